@@ -206,21 +206,19 @@ static float getRulesParamFloatValueByName(
 	const char* rulesParamName,
 	float defaultValue
 ) {
-	const std::string key(rulesParamName);
-	const auto it = params.find(key);
-	if (it == params.end())
+	const LuaRulesParams::Param* param = params.Find(rulesParamName);
+	if (param == nullptr)
 		return defaultValue;
 
-	const LuaRulesParams::Param& param = it->second;
-	if (!modParamIsVisible(param, losMask))
+	if (!modParamIsVisible(*param, losMask))
 		return defaultValue;
 
-	if (std::holds_alternative <std::string> (param.value))
+	if (std::holds_alternative <std::string> (param->value))
 		return defaultValue;
-	else if (std::holds_alternative <bool> (param.value))
-		return std::get <bool> (param.value) ? 1.0f : 0.0f;
+	else if (std::holds_alternative <bool> (param->value))
+		return std::get <bool> (param->value) ? 1.0f : 0.0f;
 	else
-		return std::get <float> (param.value);
+		return std::get <float> (param->value);
 }
 
 static const char* getRulesParamStringValueByName(
@@ -229,19 +227,17 @@ static const char* getRulesParamStringValueByName(
 	const char* rulesParamName,
 	const char* defaultValue
 ) {
-	const std::string key(rulesParamName);
-	const auto it = params.find(key);
-	if (it == params.end())
+	const LuaRulesParams::Param* param = params.Find(rulesParamName);
+	if (param == nullptr)
 		return defaultValue;
 
-	const LuaRulesParams::Param& param = it->second;
-	if (!modParamIsVisible(it->second, losMask))
+	if (!modParamIsVisible(*param, losMask))
 		return defaultValue;
 
-	if (!std::holds_alternative <std::string> (param.value))
+	if (!std::holds_alternative <std::string> (param->value))
 		return defaultValue;
 
-	return std::get <std::string> (param.value).c_str();
+	return std::get <std::string> (param->value).c_str();
 }
 
 
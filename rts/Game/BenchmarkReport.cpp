@@ -0,0 +1,166 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+#include <string>
+
+#include "BenchmarkReport.h"
+#include "System/TimeProfiler.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/FileSystem/DataDirsAccess.h"
+#include "System/FileSystem/FileQueryFlags.h"
+#include "System/Log/ILog.h"
+
+#include "System/Misc/TracyDefs.h"
+
+CONFIG(std::string, HeadlessBenchmarkReport).defaultValue("").description("engine-headless only: if set, replay demos at maximum speed without unsynced updates and write per-timer frame statistics to this file (relative to the write-dir).");
+CONFIG(int, HeadlessBenchmarkWindow).defaultValue(900).minimumValue(1).description("Number of sim-frames summarized per row-block of the HeadlessBenchmarkReport.");
+
+
+static float GetPercentile(const std::vector<float>& sortedSamples, float p)
+{
+	return sortedSamples[std::min(sortedSamples.size() - 1, static_cast<size_t>(sortedSamples.size() * p))];
+}
+
+
+bool CBenchmarkReport::IsEnabled()
+{
+	#ifdef HEADLESS
+	return (!configHandler->GetString("HeadlessBenchmarkReport").empty());
+	#else
+	return false;
+	#endif
+}
+
+void CBenchmarkReport::Init()
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	if (!IsEnabled())
+		return;
+
+	const std::string fileName = dataDirsAccess.LocateFile(configHandler->GetString("HeadlessBenchmarkReport"), FileQueryFlags::WRITE | FileQueryFlags::CREATE_DIRS);
+
+	if ((timersFile = std::fopen(fileName.c_str(), "w")) == nullptr) {
+		LOG_L(L_ERROR, "[BenchmarkReport::%s] could not open \"%s\" for writing", __func__, fileName.c_str());
+		return;
+	}
+	if ((framesFile = std::fopen((fileName + ".frames").c_str(), "w")) == nullptr) {
+		LOG_L(L_ERROR, "[BenchmarkReport::%s] could not open \"%s.frames\" for writing", __func__, fileName.c_str());
+		std::fclose(timersFile);
+		timersFile = nullptr;
+		return;
+	}
+
+	std::fprintf(timersFile, "first_frame,last_frame,timer,p50_ms,p90_ms,p99_ms,max_ms,mean_ms\n");
+	std::fprintf(framesFile, "frame,wall_ms,checksum\n");
+
+	// only special timers are recorded while the profiler is disabled
+	CTimeProfiler::GetInstance().SetEnabled(true);
+	CTimeProfiler::GetInstance().GetTotalTimes(curTotalTimes);
+
+	for (const auto& p: curTotalTimes) {
+		lastTotalTimes[p.first] = p.second;
+	}
+
+	windowSize = configHandler->GetInt("HeadlessBenchmarkWindow");
+	windowFrames = 0;
+	lastFrameTime = spring_gettime();
+
+	LOG("[BenchmarkReport::%s] writing %d-frame timer statistics to \"%s\"", __func__, windowSize, fileName.c_str());
+}
+
+void CBenchmarkReport::Kill()
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	if (!IsActive())
+		return;
+
+	if (windowFrames > 0)
+		FlushWindow(windowStartFrame + windowFrames - 1);
+
+	std::fclose(timersFile);
+	std::fclose(framesFile);
+
+	timersFile = nullptr;
+	framesFile = nullptr;
+
+	lastTotalTimes.clear();
+	windowSamples.clear();
+}
+
+
+void CBenchmarkReport::SimFrame(int frameNum, unsigned int checksum)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	if (!IsActive())
+		return;
+
+	const spring_time curFrameTime = spring_gettime();
+
+	std::fprintf(framesFile, "%d,%.3f,%08x\n", frameNum, (curFrameTime - lastFrameTime).toMilliSecsf(), checksum);
+	lastFrameTime = curFrameTime;
+
+	if (windowFrames == 0)
+		windowStartFrame = frameNum;
+
+	// per-frame cost of each timer is the growth of its accumulated total
+	CTimeProfiler::GetInstance().GetTotalTimes(curTotalTimes);
+
+	for (const auto& p: curTotalTimes) {
+		spring_time& lastTotalTime = lastTotalTimes[p.first];
+		std::vector<float>& samples = windowSamples[p.first];
+
+		// timers first seen mid-window did not run in the frames before
+		if (samples.empty())
+			samples.resize(windowFrames, 0.0f);
+
+		// totals restart from zero if the profiler is reset
+		samples.push_back(std::max((p.second - lastTotalTime).toMilliSecsf(), 0.0f));
+		lastTotalTime = p.second;
+	}
+
+	if ((windowFrames += 1) < windowSize)
+		return;
+
+	FlushWindow(frameNum);
+}
+
+void CBenchmarkReport::FlushWindow(int lastFrameNum)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	std::vector< std::pair<std::string, std::vector<float>*> > sortedSamples;
+	sortedSamples.reserve(windowSamples.size());
+
+	for (auto& p: windowSamples) {
+		if (p.second.empty())
+			continue;
+
+		sortedSamples.emplace_back(CTimeProfiler::GetTimerName(p.first), &p.second);
+	}
+
+	// stable row order so reports of different builds can be diffed directly
+	std::sort(sortedSamples.begin(), sortedSamples.end(), [](const auto& a, const auto& b) { return (a.first < b.first); });
+
+	for (const auto& p: sortedSamples) {
+		std::vector<float>& samples = *p.second;
+
+		float sum = 0.0f;
+
+		for (const float s: samples)
+			sum += s;
+
+		std::sort(samples.begin(), samples.end());
+		std::fprintf(
+			timersFile, "%d,%d,\"%s\",%.4f,%.4f,%.4f,%.4f,%.4f\n",
+			windowStartFrame, lastFrameNum, p.first.c_str(),
+			GetPercentile(samples, 0.50f), GetPercentile(samples, 0.90f), GetPercentile(samples, 0.99f),
+			samples.back(), sum / samples.size()
+		);
+
+		samples.clear();
+	}
+
+	std::fflush(timersFile);
+	std::fflush(framesFile);
+
+	windowFrames = 0;
+}
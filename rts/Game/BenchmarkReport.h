@@ -0,0 +1,58 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _BENCHMARK_REPORT_H
+#define _BENCHMARK_REPORT_H
+
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "System/UnorderedMap.hpp"
+#include "System/Misc/SpringTime.h"
+
+/**
+ * Replay benchmark for engine-headless. When HeadlessBenchmarkReport names
+ * a file, demos are replayed as fast as the simulation allows (no frame-rate
+ * throttling, no unsynced updates) and two CSV files are written:
+ *
+ *   <name>         per-timer p50/p90/p99/max/mean of the time spent under
+ *                  each SCOPED_TIMER per sim-frame, one row per timer for
+ *                  every HeadlessBenchmarkWindow frames
+ *   <name>.frames  wall-time and sync checksum of every sim-frame (the
+ *                  checksum is only available in SYNCCHECK builds)
+ *
+ * so that two engine builds can be compared on identical input, and their
+ * checksums diffed to verify that an optimization did not alter the sim.
+ */
+class CBenchmarkReport {
+public:
+	static bool IsEnabled();
+
+	void Init();
+	void Kill();
+
+	/// called after every SimFrame, before the sync checksum is reset
+	void SimFrame(int frameNum, unsigned int checksum);
+
+	bool IsActive() const { return (timersFile != nullptr); }
+
+private:
+	void FlushWindow(int lastFrameNum);
+
+private:
+	spring::unordered_map<unsigned, spring_time> lastTotalTimes;
+	spring::unordered_map<unsigned, std::vector<float> > windowSamples;
+
+	std::vector< std::pair<unsigned, spring_time> > curTotalTimes;
+
+	FILE* timersFile = nullptr;
+	FILE* framesFile = nullptr;
+
+	spring_time lastFrameTime;
+
+	int windowSize = 0;
+	int windowFrames = 0;
+	int windowStartFrame = 0;
+};
+
+#endif // _BENCHMARK_REPORT_H
@@ -8,9 +8,6 @@
 #include "System/Log/ILog.h"
 #include "System/Config/ConfigHandler.h"
 #include "System/StringUtil.h"
-#ifdef DEDICATED
-#include "System/Platform/errorhandler.h"
-#endif
 
 #include "System/Misc/TracyDefs.h"
 
@@ -57,23 +54,21 @@ void ClientSetup::LoadFromStartScript(const std::string& setup)
 		LOG_L(L_WARNING, "[ClientSetup::%s] IsHost-entry missing from setup-script; assuming this is a client", __func__);
 
 #ifdef DEDICATED
+	// thrown rather than fatal; a server started over the control port must
+	// not take down the other games running in the same process
 	if (!isHost)
-		handleerror(nullptr, "setup-script error", "dedicated server needs \"IsHost=1\" in GAME-section", MBF_OK | MBF_EXCL);
+		throw content_error("setup-script error: dedicated server needs \"IsHost=1\" in GAME-section");
 #endif
 
 	// FIXME WTF
 	std::string sourceport;
-	std::string autohostip;
-	std::string autohostport;
 
 	if (file.SGetValue(sourceport, "GAME\\SourcePort"))
 		configHandler->SetString("SourcePort", sourceport, true);
 
-	if (file.SGetValue(autohostip, "GAME\\AutohostIP"))
-		configHandler->SetString("AutohostIP", autohostip, true);
-
-	if (file.SGetValue(autohostport, "GAME\\AutohostPort"))
-		configHandler->SetString("AutohostPort", autohostport, true);
+	// kept out of the config so several servers in one process do not share them
+	file.GetDef(autohostIP,   "", "GAME\\AutohostIP");
+	file.GetDef(autohostPort, "0", "GAME\\AutohostPort");
 
 	file.GetDef(saveFile, "", "GAME\\SaveFile");
 	file.GetDef(demoFile, "", "GAME\\DemoFile");
@@ -27,6 +27,10 @@ public:
 	//! if this client is the server player, the port over which we accept incoming connections
 	int hostPort;
 
+	//! autohost interface address from the script, overrides the AutohostIP and AutohostPort configs
+	std::string autohostIP;
+	int autohostPort = 0;
+
 	bool isHost;
 
 	std::string showServerName;
@@ -51,6 +51,7 @@
 #include "Rendering/UniformConstants.h"
 #include "Rendering/Map/InfoTexture/IInfoTextureHandler.h"
 #include "Rendering/Textures/NamedTextures.h"
+#include "Lua/LuaDefsCache.h"
 #include "Lua/LuaGaia.h"
 #include "Lua/LuaHandle.h"
 #include "Lua/LuaInputReceiver.h"
@@ -128,6 +129,7 @@
 #include "System/Sound/ISound.h"
 #include "System/Sound/ISoundChannels.h"
 #include "System/Sync/DumpState.h"
+#include "System/Sync/SyncChecker.h"
 #include "System/TimeProfiler.h"
 #include "System/LoadLock.h"
 
@@ -146,6 +148,8 @@ CONFIG(int, ShowPlayerInfo).defaultValue(1).headlessValue(0);
 CONFIG(float, GuiOpacity).defaultValue(0.8f).minimumValue(0.0f).maximumValue(1.0f).description("Sets the opacity of the built-in Spring UI. Generally has no effect on LuaUI widgets. Can be set in-game using shift+, to decrease and shift+. to increase.");
 CONFIG(std::string, InputTextGeo).defaultValue("");
 
+CONFIG(bool, SimStageThreading).defaultValue(false).description("Run SimFrame stages that declare no conflicting state concurrently on the thread-pool. The schedule does not depend on timing, so this has no influence on sync. Off by default since only the HeightBounds and SmoothMesh stages can currently overlap.");
+CONFIG(bool, PipelinedSimDraw).defaultValue(false).headlessValue(false).description("Submit each draw frame before running the sim frames that are due, and swap buffers after them, so the GPU renders while the CPU simulates. Displayed sim state lags by up to one draw frame.");
 CONFIG(int, SmoothTimeOffset).defaultValue(0).headlessValue(0).description("Enables frametimeoffset smoothing, 0 = off (old version), -1 = forced 0.5,  1-20 smooth, recommended = 2-3");
 
 CGame* game = nullptr;
@@ -248,6 +252,8 @@ CGame::CGame(const std::string& mapFileName, const std::string& modFileName, ILo
 	showSpeed = configHandler->GetBool("ShowSpeed");
 
 	speedControl = configHandler->GetInt("SpeedControl");
+	simStageThreading = configHandler->GetBool("SimStageThreading");
+	pipelinedSimDraw = configHandler->GetBool("PipelinedSimDraw");
 
 	playerRoster.SetSortTypeByCode((PlayerRoster::SortType)configHandler->GetInt("ShowPlayerInfo"));
 
@@ -282,6 +288,8 @@ CGame::CGame(const std::string& mapFileName, const std::string& modFileName, ILo
 
 	CResourceHandler::CreateInstance();
 	CCategoryHandler::CreateInstance();
+
+	InitSimStages();
 }
 
 CGame::~CGame()
@@ -289,6 +297,9 @@ CGame::~CGame()
 	ENTER_SYNCED_CODE();
 	LOG("[Game::%s][1]", __func__);
 
+	// no-op if GameEnd already closed the report
+	benchmarkReport.Kill();
+
 	RmlGui::Shutdown();
 	helper->Kill();
 	KillLua(true);
@@ -550,31 +561,41 @@ void CGame::LoadDefs(LuaParser* defsParser)
 		defsParser->SetupLua(true, true);
 		// customize the defs environment; LuaParser has no access to LuaSyncedRead
 		#define LSR_ADDFUNC(f) defsParser->AddFunc(#f, LuaSyncedRead::f)
+		// results of these depend on more than the options covered by the defs-cache key
+		#define LSR_ADDSETUPFUNC(f) defsParser->AddFunc(#f, LuaDefsCache::SetupCallOut<LuaSyncedRead::f>)
 		defsParser->GetTable("Spring");
 
 		LSR_ADDFUNC(GetModOptions);
 		LSR_ADDFUNC(GetModOption);
 		LSR_ADDFUNC(GetMapOptions);
 		LSR_ADDFUNC(GetMapOption);
-		LSR_ADDFUNC(GetTeamLuaAI);
-		LSR_ADDFUNC(GetTeamList);
-		LSR_ADDFUNC(GetGaiaTeamID);
-		LSR_ADDFUNC(GetPlayerList);
-		LSR_ADDFUNC(GetAllyTeamList);
-		LSR_ADDFUNC(GetTeamInfo);
-		LSR_ADDFUNC(GetAllyTeamInfo);
-		LSR_ADDFUNC(GetAIInfo);
-		LSR_ADDFUNC(GetTeamAllyTeamID);
-		LSR_ADDFUNC(AreTeamsAllied);
-		LSR_ADDFUNC(ArePlayersAllied);
+		LSR_ADDSETUPFUNC(GetTeamLuaAI);
+		LSR_ADDSETUPFUNC(GetTeamList);
+		LSR_ADDSETUPFUNC(GetGaiaTeamID);
+		LSR_ADDSETUPFUNC(GetPlayerList);
+		LSR_ADDSETUPFUNC(GetAllyTeamList);
+		LSR_ADDSETUPFUNC(GetTeamInfo);
+		LSR_ADDSETUPFUNC(GetAllyTeamInfo);
+		LSR_ADDSETUPFUNC(GetAIInfo);
+		LSR_ADDSETUPFUNC(GetTeamAllyTeamID);
+		LSR_ADDSETUPFUNC(AreTeamsAllied);
+		LSR_ADDSETUPFUNC(ArePlayersAllied);
 		LSR_ADDFUNC(GetSideData);
 
 		defsParser->EndTable();
+		#undef LSR_ADDSETUPFUNC
 		#undef LSR_ADDFUNC
 
-		// run the parser
-		if (!defsParser->Execute())
-			throw content_error("Defs-Parser: " + defsParser->GetErrorLog());
+		const uint64_t defsCacheKey = LuaDefsCache::IsEnabled()? LuaDefsCache::GetKey(*defsParser): 0;
+
+		// run the parser, unless an earlier run with the same inputs left its result
+		if (defsCacheKey == 0 || !LuaDefsCache::Read(defsCacheKey, *defsParser)) {
+			if (!defsParser->Execute())
+				throw content_error("Defs-Parser: " + defsParser->GetErrorLog());
+
+			if (defsCacheKey != 0)
+				LuaDefsCache::Write(defsCacheKey, *defsParser);
+		}
 
 		const LuaTable& root = defsParser->GetRoot();
 
@@ -1287,6 +1308,10 @@ bool CGame::UpdateUnsynced(const spring_time currentTime)
 		}
 	}
 
+	// replay benchmarks measure the simulation only
+	if (benchmarkReport.IsActive())
+		return true;
+
 	if (skipping) {
 		// when fast-forwarding, maintain a draw-rate of 2Hz
 		if (spring_tomsecs(currentTime - skipLastDrawTime) < 500.0f)
@@ -1418,6 +1443,7 @@ bool CGame::UpdateUnsynced(const spring_time currentTime)
 
 	if (luaUI != nullptr) {
 		luaUI->CheckStack();
+		luaUI->RecvFromWorkers();
 		luaUI->CheckAction();
 	}
 	if (luaGaia != nullptr)
@@ -1711,10 +1737,66 @@ void CGame::StartPlaying()
 
 	if (saveFileHandler == nullptr)
 		eventHandler.GameStart();
+
+	benchmarkReport.Init();
 }
 
 static const char* const tracingSimFrameName = "SimFrame";
 
+void CGame::InitSimStages()
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	simStages.Clear();
+
+	// stages are listed in their historical serial order, which the graph
+	// preserves between every pair that shares state; anything that can
+	// reach a synced Lua call-in declares SIM_RES_LUA and thus runs alone
+	simStages.AddStage("GameFrame", []() {
+		SCOPED_TIMER("Sim::GameFrame");
+
+		// keep garbage-collection rate tied to sim-speed
+		// (fixed 30Hz gc is not enough while catching up)
+		if (game->luaGCControl == 0)
+			eventHandler.CollectGarbage(false);
+
+		eventHandler.GameFrame(gs->frameNum);
+	}, 0, SIM_RES_LUA, SYNC_LANE_LUA);
+
+	simStages.AddStage("Helper", []() { helper->Update(); }, 0, SIM_RES_LUA);
+	simStages.AddStage("HeightBounds", []() { readMap->Update(); }, SIM_RES_HEIGHTMAP, SIM_RES_HEIGHTBOUNDS);
+	simStages.AddStage("SmoothMesh", []() { smoothGround.UpdateSmoothMesh(); }, SIM_RES_HEIGHTMAP, SIM_RES_SMOOTHMESH);
+	simStages.AddStage("MapDamage", []() { mapDamage->Update(); }, 0, SIM_RES_LUA);
+	simStages.AddStage("Units", []() { unitHandler.Update(); }, 0, SIM_RES_LUA, SYNC_LANE_UNITS);
+	simStages.AddStage("Pathing", []() { pathManager->Update(); }, SIM_RES_HEIGHTMAP | SIM_RES_UNITS | SIM_RES_FEATURES | SIM_RES_QUADFIELD, SIM_RES_PATHING | SIM_RES_SYNC, SYNC_LANE_PATHING);
+	simStages.AddStage("Projectiles", []() { projectileHandler.Update(); }, 0, SIM_RES_LUA, SYNC_LANE_PROJECTILES);
+	simStages.AddStage("Features", []() { featureHandler.Update(); }, 0, SIM_RES_LUA, SYNC_LANE_FEATURES);
+	simStages.AddStage("Script", []() {
+		/* The default GAME_SPEED is 30, which doesn't divide 1000 well,
+		 * so scripts will perceive 990ms per second. But this is fine,
+		 * since doing "29th February" style of extra counting would be
+		 * disruptive to sleeps that assume a constant tick length while
+		 * not being otherwise perceptible since most animations don't
+		 * run that long. */
+		static constexpr int tickMs = 1000 / GAME_SPEED;
+
+		SCOPED_TIMER("Sim::Script");
+		unitScriptEngine->Tick(tickMs);
+	}, 0, SIM_RES_LUA, SYNC_LANE_UNITS);
+	// wind changes are pushed into unit scripts
+	simStages.AddStage("Wind", []() { envResHandler.Update(); }, 0, SIM_RES_LUA);
+	simStages.AddStage("Los", []() { losHandler->Update(); }, SIM_RES_UNITS | SIM_RES_HEIGHTMAP, SIM_RES_LOS | SIM_RES_SYNC, SYNC_LANE_LOS);
+	// dead ghosts have to be updated in sim, after los,
+	// to make sure they represent the current knowledge correctly.
+	// should probably be split from drawer
+	simStages.AddStage("Ghosts", []() { CUnitDrawer::UpdateGhostedBuildings(); }, SIM_RES_LOS, SIM_RES_UNSYNCED);
+	simStages.AddStage("Intercept", []() { interceptHandler.Update(false); }, 0, SIM_RES_LUA, SYNC_LANE_PROJECTILES);
+	simStages.AddStage("Teams", []() { teamHandler.GameFrame(gs->frameNum); }, 0, SIM_RES_LUA);
+	simStages.AddStage("Players", []() { playerHandler.GameFrame(gs->frameNum); }, 0, SIM_RES_LUA);
+	simStages.AddStage("GameFramePost", []() { eventHandler.GameFramePost(gs->frameNum); }, 0, SIM_RES_LUA, SYNC_LANE_LUA);
+
+	simStages.Build();
+}
+
 void CGame::SimFrame() {
 	ENTER_SYNCED_CODE();
 	ASSERT_SYNCED(gsRNG.GetGenState());
@@ -1758,7 +1840,7 @@ void CGame::SimFrame() {
 	// stats are reliable when paused) but see LuaUser
 	spring_lua_alloc_update_stats((gs->frameNum % GAME_SPEED) == 0);
 
-	if (!skipping) {
+	if (!skipping && !benchmarkReport.IsActive()) {
 		// everything here is unsynced and should ideally moved to Game::Update()
 		waitCommandsAI.Update();
 		geometricObjects->Update();
@@ -1780,49 +1862,17 @@ void CGame::SimFrame() {
 	{
 		SCOPED_SPECIAL_TIMER("Sim");
 
-		{
-			SCOPED_TIMER("Sim::GameFrame");
-
-			// keep garbage-collection rate tied to sim-speed
-			// (fixed 30Hz gc is not enough while catching up)
-			if (luaGCControl == 0)
-				eventHandler.CollectGarbage(false);
-
-			eventHandler.GameFrame(gs->frameNum);
-		}
-
-		helper->Update();
-		readMap->Update();
-		smoothGround.UpdateSmoothMesh();
-		mapDamage->Update();
-		unitHandler.Update();
-		pathManager->Update();
-		projectileHandler.Update();
-		featureHandler.Update();
-		{
-			/* The default GAME_SPEED is 30, which doesn't divide 1000 well,
-			 * so scripts will perceive 990ms per second. But this is fine,
-			 * since doing "29th February" style of extra counting would be
-			 * disruptive to sleeps that assume a constant tick length while
-			 * not being otherwise perceptible since most animations don't
-			 * run that long. */
-			static constexpr int tickMs = 1000 / GAME_SPEED;
-
-			SCOPED_TIMER("Sim::Script");
-			unitScriptEngine->Tick(tickMs);
-		}
-		envResHandler.Update();
-		losHandler->Update();
-		// dead ghosts have to be updated in sim, after los,
-		// to make sure they represent the current knowledge correctly.
-		// should probably be split from drawer
-		CUnitDrawer::UpdateGhostedBuildings();
-		interceptHandler.Update(false);
+		simStages.Execute(simStageThreading);
+	}
 
-		teamHandler.GameFrame(gs->frameNum);
-		playerHandler.GameFrame(gs->frameNum);
-		eventHandler.GameFramePost(gs->frameNum);
+	#ifdef SYNCCHECK
+	{
+		// RNG state is not a synced primitive; fold it in once per frame
+		SCOPED_SYNC_LANE(SYNC_LANE_RNG);
+		const auto rngState = gsRNG.GetGenState();
+		CSyncChecker::Sync(&rngState, sizeof(rngState));
 	}
+	#endif
 
 	lastSimFrameTime = spring_gettime();
 	gu->avgSimFrameTime = mix(gu->avgSimFrameTime, (lastSimFrameTime - lastFrameTime).toMilliSecsf(), 0.05f);
@@ -1833,7 +1883,7 @@ void CGame::SimFrame() {
 	FrameMarkEnd(tracingSimFrameName);
 
 	#ifdef HEADLESS
-	{
+	if (!benchmarkReport.IsActive()) {
 		const float msecMaxSimFrameTime = 1000.0f / (GAME_SPEED * gs->wantedSpeedFactor);
 		const float msecDifSimFrameTime = (lastSimFrameTime - lastFrameTime).toMilliSecsf();
 		// multiply by 0.5 to give unsynced code some execution time (50% of our sleep-budget)
@@ -1889,6 +1939,8 @@ void CGame::GameEnd(const std::vector<unsigned char>& winningAllyTeams, bool tim
 	CTimeProfiler::GetInstance().PrintProfilingInfo();
 #endif // HEADLESS
 
+	benchmarkReport.Kill();
+
 	CDemoRecorder* record = clientNet->GetDemoRecorder();
 
 	if (!record->IsValid())
@@ -7,11 +7,13 @@
 #include <string>
 #include <vector>
 
+#include "BenchmarkReport.h"
 #include "GameController.h"
 #include "GameJobDispatcher.h"
 #include "Game/UI/KeySet.h"
 #include "Game/Action.h"
 #include "Rendering/WorldDrawer.h"
+#include "Sim/Misc/SimStageGraph.h"
 #include "System/UnorderedMap.hpp"
 #include "System/creg/creg_cond.h"
 #include "System/Misc/SpringTime.h"
@@ -109,6 +111,7 @@ public:
 private:
 	bool Draw() override;
 	bool Update() override;
+	bool UpdateAfterDraw() const override { return pipelinedSimDraw; }
 	bool UpdateUnsynced(const spring_time currentTime);
 
 	void DrawSkip(bool blackscreen = true);
@@ -138,11 +141,13 @@ private:
 	float GetNetMessageProcessingTimeLimit() const;
 
 	void SendClientProcUsage();
+	void SendClientProfileSummary();
 	void ClientReadNet();
 	void UpdateNumQueuedSimFrames();
 	void UpdateNetMessageProcessingTimeLeft();
 	void SimFrame();
 	void StartPlaying();
+	void InitSimStages();
 
 public:
 	GameDrawMode gameDrawMode = gameNotDrawing;
@@ -210,6 +215,9 @@ public:
 	// 0 := 1/f rate, 1 := 30/s rate
 	int luaGCControl = 0;
 
+	bool simStageThreading = false;
+	bool pipelinedSimDraw = false;
+
 private:
 	JobDispatcher jobDispatcher;
 
@@ -217,6 +225,8 @@ private:
 	CTimedKeyChain curScanCodeChain;
 
 	CWorldDrawer worldDrawer;
+	CBenchmarkReport benchmarkReport;
+	CSimStageGraph simStages;
 
 	/// <playerID, <packetCode, total bytes> >
 	spring::unordered_map<int, PlayerTrafficInfo> playerTraffic;
@@ -15,6 +15,8 @@ public:
 
 	virtual bool Draw() { return true; }
 	virtual bool Update() { return true; }
+	/// if true, Update is called after Draw and before the buffer swap
+	virtual bool UpdateAfterDraw() const { return false; }
 	virtual int KeyPressed(int keyCode, int scanCode, bool isRepeat) { return 0; }
 	virtual int KeyMapChanged() { return 0; }
 	virtual int KeyReleased(int keyCode, int scanCode) { return 0; }
@@ -237,21 +237,20 @@ namespace {
 		{ }
 
 		bool ShouldIncludeUnit(const CUnit* unit) const override {
-			const auto it = unit->modParams.find(paramName);
-			if (it == unit->modParams.end())
+			const LuaRulesParams::Param* param = unit->modParams.Find(paramName);
+			if (param == nullptr)
 				return false;
 
-			const auto& param = it->second;
 			if (!wantedValueStr.empty()) {
-				if (std::holds_alternative <std::string> (param.value))
-					return std::get <std::string> (param.value) == wantedValueStr;
+				if (std::holds_alternative <std::string> (param->value))
+					return std::get <std::string> (param->value) == wantedValueStr;
 				else
 					return false;
 			} else {
-				if (std::holds_alternative <float> (param.value))
-					return std::get <float> (param.value) == wantedValueNum;
-				else if (std::holds_alternative <bool> (param.value))
-					return (std::get <bool> (param.value) ? 1.0f : 0.0f) == wantedValueNum;
+				if (std::holds_alternative <float> (param->value))
+					return std::get <float> (param->value) == wantedValueNum;
+				else if (std::holds_alternative <bool> (param->value))
+					return (std::get <bool> (param->value) ? 1.0f : 0.0f) == wantedValueNum;
 				else
 					return false;
 			}
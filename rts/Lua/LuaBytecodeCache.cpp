@@ -0,0 +1,277 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "LuaBytecodeCache.h"
+#include "LuaInclude.h"
+#include "LuaUtils.h"
+#include "Game/GameVersion.h"
+#include "System/SpringHash.h"
+#include "System/UnorderedMap.hpp"
+#include "System/Config/ConfigHandler.h"
+#include "System/FileSystem/CacheDirLimiter.h"
+#include "System/FileSystem/DataDirsAccess.h"
+#include "System/FileSystem/FileQueryFlags.h"
+#include "System/FileSystem/FileSystem.h"
+#include "System/Log/ILog.h"
+#include "System/Threading/SpringThreading.h"
+
+#include "System/Misc/TracyDefs.h"
+
+CONFIG(bool, LuaBytecodeCache).defaultValue(true).description("Keep compiled Lua chunks in memory and in the cache directory so widget and gadget files are only parsed once.");
+CONFIG(int, LuaBytecodeCacheSize).defaultValue(256).minimumValue(16).description("Size limit of the Lua bytecode cache directory in megabytes; the least recently used entries are deleted when it is exceeded.");
+
+static constexpr uint32_t BYTECODE_CACHE_MAGIC   = 0x4342554C; // "LUBC"
+static constexpr uint32_t BYTECODE_CACHE_VERSION = 1;
+
+// smaller chunks compile faster than a cache lookup
+static constexpr size_t MIN_CACHED_CHUNK_SIZE = 256;
+static constexpr size_t MAX_MEMORY_CACHE_SIZE = 64 << 20;
+
+static spring::mutex chunkCacheMutex;
+static spring::unordered_map<uint64_t, std::string> chunkCache;
+static size_t chunkCacheSize = 0;
+
+static CCacheDirLimiter cacheLimiter("LuaBytecodeCache", ".luac");
+
+
+static const std::string& GetBytecodeCacheDir()
+{
+	// LocateDir is not cheap and chunks are loaded from several threads
+	static const std::string cacheDir = dataDirsAccess.LocateDir(
+		FileSystem::GetCacheDir() + FileSystemAbstraction::GetNativePathSeparator() + "luabytecode" + FileSystemAbstraction::GetNativePathSeparator(),
+		FileQueryFlags::WRITE | FileQueryFlags::CREATE_DIRS
+	);
+
+	return cacheDir;
+}
+
+static std::string GetBytecodeCacheFileName(uint64_t key)
+{
+	char buf[32];
+	std::snprintf(buf, sizeof(buf), "%016llx.luac", static_cast<unsigned long long>(key));
+	return (FileSystem::EnsurePathSepAtEnd(GetBytecodeCacheDir()) + buf);
+}
+
+static uint64_t GetCacheSizeLimit()
+{
+	static const uint64_t limit = uint64_t(configHandler->GetInt("LuaBytecodeCacheSize")) * 1024 * 1024;
+	return limit;
+}
+
+static uint64_t GetBuildKey()
+{
+	// lundump validates its own header (Lua version, sizes, endianness), this
+	// additionally rejects bytecode from other engine builds of the same cache-dir
+	static const uint64_t buildKey = []() {
+		const std::string buildStr = SpringVersion::GetFull() + " " + LUA_RELEASE + " " + std::to_string(sizeof(lua_Number));
+		return XXH3_64bits(buildStr.data(), buildStr.size());
+	}();
+
+	return buildKey;
+}
+
+static uint64_t GetChunkKey(const char* buf, size_t size, const char* name)
+{
+	// the name is stored in the bytecode (error messages, debug info)
+	const uint64_t seed = XXH3_64bits(name, std::strlen(name));
+	return (XXH3_64bits_withSeed(buf, size, seed));
+}
+
+
+static bool ReadChunkFile(uint64_t key, std::string& bytecode)
+{
+	const std::string fileName = GetBytecodeCacheFileName(key);
+
+	FILE* file = std::fopen(fileName.c_str(), "rb");
+
+	if (file == nullptr)
+		return false;
+
+	LuaBytecodeCache::Header header;
+
+	bool valid = (std::fread(&header, sizeof(header), 1, file) == 1);
+
+	valid = valid && (header.magic == BYTECODE_CACHE_MAGIC);
+	valid = valid && (header.version == BYTECODE_CACHE_VERSION);
+	valid = valid && (header.key == key);
+	valid = valid && (header.buildKey == GetBuildKey());
+
+	if (valid) {
+		bytecode.resize(header.dataSize);
+
+		valid = (!bytecode.empty() && std::fread(bytecode.data(), bytecode.size(), 1, file) == 1);
+		valid = valid && (XXH3_64bits(bytecode.data(), bytecode.size()) == header.dataHash);
+	}
+
+	std::fclose(file);
+
+	if (!valid) {
+		LOG_L(L_WARNING, "[LuaBytecodeCache::%s] removing invalid entry \"%s\"", __func__, fileName.c_str());
+		FileSystem::Remove(fileName);
+		return false;
+	}
+
+	// reads count as uses for eviction
+	CCacheDirLimiter::Touch(fileName);
+	return true;
+}
+
+static bool WriteChunkFile(uint64_t key, const std::string& bytecode)
+{
+	static std::atomic<uint32_t> tmpFileCounter = {0};
+
+	const LuaBytecodeCache::Header header = {
+		BYTECODE_CACHE_MAGIC,
+		BYTECODE_CACHE_VERSION,
+		key,
+		GetBuildKey(),
+		XXH3_64bits(bytecode.data(), bytecode.size()),
+		static_cast<uint32_t>(bytecode.size()),
+		0,
+	};
+
+	const std::string fileName = GetBytecodeCacheFileName(key);
+	// handles on different threads can compile the same file, write to a
+	// unique temporary and rename so readers never observe a partial entry
+	const std::string tempName = fileName + "." + std::to_string(tmpFileCounter.fetch_add(1)) + ".tmp";
+
+	FILE* file = std::fopen(tempName.c_str(), "wb");
+
+	if (file == nullptr)
+		return false;
+
+	bool written = true;
+
+	written = written && (std::fwrite(&header, sizeof(header), 1, file) == 1);
+	written = written && (std::fwrite(bytecode.data(), bytecode.size(), 1, file) == 1);
+	written = (std::fclose(file) == 0) && written;
+	written = written && (std::rename(tempName.c_str(), fileName.c_str()) == 0);
+
+	if (!written) {
+		std::remove(tempName.c_str());
+		return false;
+	}
+
+	cacheLimiter.AddEntry(GetBytecodeCacheDir(), sizeof(header) + bytecode.size(), GetCacheSizeLimit());
+	return true;
+}
+
+
+static void InsertChunk(uint64_t key, const std::string& bytecode)
+{
+	std::lock_guard<spring::mutex> lock(chunkCacheMutex);
+
+	if ((chunkCacheSize + bytecode.size()) > MAX_MEMORY_CACHE_SIZE)
+		return;
+
+	if (chunkCache.emplace(key, bytecode).second)
+		chunkCacheSize += bytecode.size();
+}
+
+static void EraseChunk(uint64_t key)
+{
+	{
+		std::lock_guard<spring::mutex> lock(chunkCacheMutex);
+
+		const auto iter = chunkCache.find(key);
+
+		if (iter != chunkCache.end()) {
+			chunkCacheSize -= iter->second.size();
+			chunkCache.erase(iter);
+		}
+	}
+
+	FileSystem::Remove(GetBytecodeCacheFileName(key));
+}
+
+static bool FindChunk(uint64_t key, std::string& bytecode)
+{
+	{
+		std::lock_guard<spring::mutex> lock(chunkCacheMutex);
+
+		const auto iter = chunkCache.find(key);
+
+		if (iter != chunkCache.end()) {
+			bytecode = iter->second;
+			return true;
+		}
+	}
+
+	if (!ReadChunkFile(key, bytecode))
+		return false;
+
+	InsertChunk(key, bytecode);
+	return true;
+}
+
+static int DumpWriter(lua_State* L, const void* data, size_t size, void* ud)
+{
+	static_cast<std::string*>(ud)->append(static_cast<const char*>(data), size);
+	return 0;
+}
+
+
+bool LuaBytecodeCache::IsEnabled()
+{
+	static const bool enabled = (configHandler != nullptr && configHandler->GetBool("LuaBytecodeCache"));
+	return enabled;
+}
+
+int LuaBytecodeCache::LoadBuffer(lua_State* L, const char* buf, size_t size, const char* name)
+{
+	if (!IsEnabled() || name == nullptr || name == buf || size < MIN_CACHED_CHUNK_SIZE || buf[0] == LUA_SIGNATURE[0])
+		return (luaL_loadbuffer(L, buf, size, name));
+
+	RECOIL_DETAILED_TRACY_ZONE;
+	const uint64_t key = GetChunkKey(buf, size, name);
+
+	std::string bytecode;
+
+	if (FindChunk(key, bytecode)) {
+		if (luaL_loadbuffer(L, bytecode.data(), bytecode.size(), name) == 0)
+			return 0;
+
+		// produced by a build whose lundump accepts but fails on it
+		lua_pop(L, 1);
+		EraseChunk(key);
+	}
+
+	const int error = luaL_loadbuffer(L, buf, size, name);
+
+	if (error != 0)
+		return error;
+
+	bytecode.clear();
+
+	if (lua_dump(L, DumpWriter, &bytecode) != 0 || bytecode.empty())
+		return 0;
+
+	InsertChunk(key, bytecode);
+	WriteChunkFile(key, bytecode);
+	return 0;
+}
+
+static int CallOutLoadString(lua_State* L)
+{
+	size_t len;
+	const char* str = luaL_checklstring(L, 1, &len);
+	const char* chunkName = luaL_optstring(L, 2, str);
+
+	if (LuaBytecodeCache::LoadBuffer(L, str, len, chunkName) == 0)
+		return 1;
+
+	// nil, then the error message
+	lua_pushnil(L);
+	lua_insert(L, -2);
+	return 2;
+}
+
+bool LuaBytecodeCache::PushEntries(lua_State* L)
+{
+	LuaPushNamedCFunc(L, "loadstring", CallOutLoadString);
+	return true;
+}
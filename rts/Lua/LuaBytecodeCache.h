@@ -0,0 +1,46 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef LUA_BYTECODE_CACHE_H
+#define LUA_BYTECODE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+
+struct lua_State;
+
+/**
+ * Cache of compiled Lua chunks, kept in memory for the lifetime of the
+ * process and as lua_dump output under <CacheDir>/luabytecode/. Entries are
+ * keyed by a hash over the chunk name and source text, so the same widget or
+ * gadget file loaded by several handles (or on the next launch) skips the
+ * parser. Entries also record the engine build and Lua number format they
+ * were produced by, and anything that fails to load is recompiled from source.
+ *
+ * The directory is capped at LuaBytecodeCacheSize megabytes, evicting the
+ * least recently used entries first.
+ *
+ * Chunks loaded without an explicit name (loadstring(code) where the code
+ * doubles as its own name) are usually generated at runtime and bypass the
+ * cache, as do chunks that are already precompiled.
+ */
+namespace LuaBytecodeCache {
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint64_t key;
+		uint64_t buildKey;
+		uint64_t dataHash;
+		uint32_t dataSize;
+		uint32_t padding;
+	};
+
+	bool IsEnabled();
+
+	/// drop-in replacement for luaL_loadbuffer
+	int LoadBuffer(lua_State* L, const char* buf, size_t size, const char* name);
+
+	/// replaces the base library's loadstring in the table on top of the stack
+	bool PushEntries(lua_State* L);
+}
+
+#endif // LUA_BYTECODE_CACHE_H
@@ -0,0 +1,199 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "LuaDefsCache.h"
+#include "LuaInclude.h"
+#include "LuaParser.h"
+#include "Game/GameSetup.h"
+#include "Game/GameVersion.h"
+#include "System/SpringHash.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/FileSystem/ArchiveScanner.h"
+#include "System/FileSystem/DataDirsAccess.h"
+#include "System/FileSystem/FileQueryFlags.h"
+#include "System/FileSystem/FileSystem.h"
+#include "System/Log/ILog.h"
+
+#include "System/Misc/TracyDefs.h"
+
+CONFIG(bool, GameDataCache).defaultValue(true).description("Keep the evaluated gamedata definitions in the cache directory to skip running gamedata/defs.lua when a game is started again with the same archives and options.");
+
+static constexpr uint32_t DEFS_CACHE_MAGIC   = 0x4346444C; // "LDFC"
+static constexpr uint32_t DEFS_CACHE_VERSION = 1;
+
+// set by SetupCallOut while defs.lua runs
+static bool setupDependent = false;
+
+
+static std::string GetDefsCacheFileName(uint64_t key)
+{
+	const std::string cacheDir = dataDirsAccess.LocateDir(
+		FileSystem::GetCacheDir() + FileSystemAbstraction::GetNativePathSeparator() + "defs" + FileSystemAbstraction::GetNativePathSeparator(),
+		FileQueryFlags::WRITE | FileQueryFlags::CREATE_DIRS
+	);
+
+	char buf[32];
+	std::snprintf(buf, sizeof(buf), "%016llx.ldc", static_cast<unsigned long long>(key));
+	return (FileSystem::EnsurePathSepAtEnd(cacheDir) + buf);
+}
+
+static uint64_t GetSetupKey()
+{
+	const uint64_t key = XXH3_64bits(gameSetup->setupText.data(), gameSetup->setupText.size());
+	return (key + (key == 0));
+}
+
+static void AppendOptions(std::vector<uint8_t>& keyData, const spring::unordered_map<std::string, std::string>& options)
+{
+	std::vector< std::pair<std::string, std::string> > sortedOptions(options.begin(), options.end());
+	std::sort(sortedOptions.begin(), sortedOptions.end());
+
+	for (const auto& p: sortedOptions) {
+		// include the terminators so that {"ab", "c"} and {"a", "bc"} differ
+		keyData.insert(keyData.end(), p.first.c_str(), p.first.c_str() + p.first.size() + 1);
+		keyData.insert(keyData.end(), p.second.c_str(), p.second.c_str() + p.second.size() + 1);
+	}
+
+	keyData.push_back(0);
+}
+
+
+bool LuaDefsCache::IsEnabled()
+{
+	return (configHandler->GetBool("GameDataCache") && gameSetup != nullptr);
+}
+
+void LuaDefsCache::MarkSetupDependent() { setupDependent = true; }
+
+uint64_t LuaDefsCache::GetKey(LuaParser& parser)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	std::vector<uint8_t> keyData;
+
+	setupDependent = false;
+
+	// Game.* also holds setup values (startPosType, maxUnits, ...)
+	if (!parser.DumpGlobal("Game", keyData))
+		return 0;
+	// Engine.* and Script.IsEngineMinVersion let defs differ between engine versions
+	if (!parser.DumpGlobal("Engine", keyData))
+		return 0;
+
+	const std::string& engineVersion = SpringVersion::GetSync();
+	keyData.insert(keyData.end(), engineVersion.c_str(), engineVersion.c_str() + engineVersion.size() + 1);
+
+	for (const std::string& archiveName: {gameSetup->modName, gameSetup->mapName}) {
+		const sha512::raw_digest checksum = archiveScanner->GetArchiveCompleteChecksumBytes(archiveName);
+		keyData.insert(keyData.end(), checksum.begin(), checksum.end());
+	}
+
+	AppendOptions(keyData, gameSetup->GetModOptionsCont());
+	AppendOptions(keyData, gameSetup->GetMapOptionsCont());
+
+	const uint64_t key = XXH3_64bits(keyData.data(), keyData.size());
+
+	// zero is reserved for "no key"
+	return (key + (key == 0));
+}
+
+bool LuaDefsCache::Read(uint64_t key, LuaParser& parser)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	const std::string fileName = GetDefsCacheFileName(key);
+
+	FILE* file = std::fopen(fileName.c_str(), "rb");
+
+	if (file == nullptr)
+		return false;
+
+	Header header;
+	std::vector<uint8_t> data;
+
+	bool valid = (std::fread(&header, sizeof(header), 1, file) == 1);
+
+	valid = valid && (header.magic == DEFS_CACHE_MAGIC);
+	valid = valid && (header.version == DEFS_CACHE_VERSION);
+	valid = valid && (header.key == key);
+	valid = valid && (header.numberSize == sizeof(lua_Number));
+
+	if (valid && header.setupKey != 0 && header.setupKey != GetSetupKey()) {
+		// not corrupt, just made for a different setup; Write replaces it
+		std::fclose(file);
+		return false;
+	}
+
+	if (valid) {
+		data.resize(header.dataSize);
+
+		valid = (!data.empty() && std::fread(data.data(), data.size(), 1, file) == 1);
+		valid = valid && (XXH3_64bits(data.data(), data.size()) == header.dataHash);
+	}
+
+	std::fclose(file);
+
+	if (!valid || !parser.RestoreRoot(data.data(), data.size())) {
+		LOG_L(L_WARNING, "[LuaDefsCache::%s] removing corrupt entry \"%s\"", __func__, fileName.c_str());
+		FileSystem::Remove(fileName);
+		return false;
+	}
+
+	LOG("[LuaDefsCache::%s] restored gamedata definitions from \"%s\"", __func__, fileName.c_str());
+	return true;
+}
+
+bool LuaDefsCache::Write(uint64_t key, LuaParser& parser)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	if (parser.UsedRandom()) {
+		LOG_L(L_DEBUG, "[LuaDefsCache::%s] gamedata definitions use math.random, not caching", __func__);
+		return false;
+	}
+
+	std::vector<uint8_t> data;
+
+	if (!parser.DumpRoot(data)) {
+		LOG_L(L_DEBUG, "[LuaDefsCache::%s] gamedata definitions contain non-data values, not caching", __func__);
+		return false;
+	}
+
+	const Header header = {
+		DEFS_CACHE_MAGIC,
+		DEFS_CACHE_VERSION,
+		key,
+		setupDependent? GetSetupKey(): 0,
+		XXH3_64bits(data.data(), data.size()),
+		sizeof(lua_Number),
+		static_cast<uint32_t>(data.size()),
+	};
+
+	const std::string fileName = GetDefsCacheFileName(key);
+	// write to a temporary and rename so readers never observe a partial entry
+	const std::string tempName = fileName + ".tmp";
+
+	FILE* file = std::fopen(tempName.c_str(), "wb");
+
+	if (file == nullptr)
+		return false;
+
+	bool written = true;
+
+	written = written && (std::fwrite(&header, sizeof(header), 1, file) == 1);
+	written = written && (std::fwrite(data.data(), data.size(), 1, file) == 1);
+	written = (std::fclose(file) == 0) && written;
+
+	if (written && std::rename(tempName.c_str(), fileName.c_str()) != 0) {
+		// rename does not replace existing (stale) entries on every platform
+		std::remove(fileName.c_str());
+		written = (std::rename(tempName.c_str(), fileName.c_str()) == 0);
+	}
+
+	if (!written)
+		std::remove(tempName.c_str());
+
+	return written;
+}
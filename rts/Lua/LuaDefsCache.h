@@ -0,0 +1,50 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef LUA_DEFS_CACHE_H
+#define LUA_DEFS_CACHE_H
+
+#include <cstdint>
+
+class LuaParser;
+struct lua_State;
+
+/**
+ * On-disk cache of the table returned by gamedata/defs.lua, stored as a
+ * LuaParser snapshot under <CacheDir>/defs/. Entries are keyed by the game
+ * and map archive checksums, mod- and map-options and the Game.* constants
+ * visible to the defs environment; a hit restores the table without running
+ * any Lua. Results that depend on the rest of the game-setup (teams, players,
+ * AIs) additionally record a hash of the setup script, and results that drew
+ * from gsRNG are never stored.
+ */
+namespace LuaDefsCache {
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint64_t key;
+		uint64_t setupKey; // zero if the result does not depend on the setup script
+		uint64_t dataHash;
+
+		uint32_t numberSize;
+		uint32_t dataSize;
+	};
+
+	bool IsEnabled();
+
+	/// must be called after the defs environment is set up and before Execute
+	uint64_t GetKey(LuaParser& parser);
+
+	/// returns false on a miss or if the entry is stale, truncated or corrupt
+	bool Read(uint64_t key, LuaParser& parser);
+	bool Write(uint64_t key, LuaParser& parser);
+
+	void MarkSetupDependent();
+
+	/// wraps call-outs whose results depend on the full game-setup
+	template<int (*func)(lua_State*)> int SetupCallOut(lua_State* L) {
+		MarkSetupDependent();
+		return func(L);
+	}
+}
+
+#endif // LUA_DEFS_CACHE_H
@@ -11,6 +11,7 @@
 #include "LuaHashString.h"
 #include "LuaOpenGL.h"
 #include "LuaBitOps.h"
+#include "LuaBytecodeCache.h"
 #include "LuaMathExtra.h"
 #include "LuaUtils.h"
 #include "LuaZip.h"
@@ -498,7 +499,7 @@ bool CLuaHandle::LoadCode(lua_State* L, std::string code, const string& debug)
 	const LuaUtils::ScopedDebugTraceBack traceBack(L);
 
 	tracy::LuaRemove(code.data());
-	const int error = luaL_loadbuffer(L, code.c_str(), code.size(), debug.c_str());
+	const int error = LuaBytecodeCache::LoadBuffer(L, code.c_str(), code.size(), debug.c_str());
 
 	if (error != 0) {
 		LOG_L(L_ERROR, "[%s::%s] error=%i (%s) debug=%s msg=%s", name.c_str(), __func__, error, LuaErrorString(error), debug.c_str(), lua_tostring(L, -1));
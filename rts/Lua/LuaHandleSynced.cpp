@@ -6,6 +6,7 @@
 
 #include "LuaUtils.h"
 #include "LuaArchive.h"
+#include "LuaBytecodeCache.h"
 #include "LuaCallInCheck.h"
 #include "LuaConfig.h"
 #include "LuaConstGL.h"
@@ -26,6 +27,7 @@
 #include "LuaUnitDefs.h"
 #include "LuaWeaponDefs.h"
 #include "LuaScream.h"
+#include "LuaSharedArray.h"
 #include "LuaMaterial.h"
 #include "LuaOpenGL.h"
 #include "LuaVFS.h"
@@ -128,6 +130,7 @@ bool CUnsyncedLuaHandle::Init(std::string code, const std::string& file)
 		if (!AddEntriesToTable(L, "FeatureDefs",   LuaFeatureDefs::PushEntries        )) KILL
 		if (!AddEntriesToTable(L, "Script",          LuaInterCall::PushEntriesUnsynced)) KILL
 		if (!AddEntriesToTable(L, "Script",             LuaScream::PushEntries        )) KILL
+		if (!AddEntriesToTable(L, "Script",        LuaSharedArray::PushUnsynced       )) KILL
 		if (!AddEntriesToTable(L, "Spring",         LuaSyncedRead::PushEntries        )) KILL
 		if (!AddEntriesToTable(L, "Spring",       LuaUnsyncedCtrl::PushEntries        )) KILL
 		if (!AddEntriesToTable(L, "Spring",       LuaUnsyncedRead::PushEntries        )) KILL
@@ -177,6 +180,8 @@ bool CUnsyncedLuaHandle::Init(std::string code, const std::string& file)
  *********************/
 
 /*** Receives data sent via `SendToUnsynced` callout.
+ *
+ * SharedArray arguments arrive as read-only views, see LuaSharedArray.
  *
  * @function RecvFromSynced
  * @tparam any arg1
@@ -196,7 +201,26 @@ void CUnsyncedLuaHandle::RecvFromSynced(lua_State* srcState, int args)
 	if (!cmdStr.GetGlobalFunc(L))
 		return; // the call is not defined
 
-	LuaUtils::CopyData(L, srcState, args);
+	const int srcTop = lua_gettop(srcState);
+
+	bool haveSharedArrays = false;
+
+	for (int i = srcTop - args + 1; i <= srcTop; i++) {
+		haveSharedArrays |= LuaSharedArray::IsSharedArray(srcState, i);
+	}
+
+	if (!haveSharedArrays) {
+		LuaUtils::CopyData(L, srcState, args);
+	} else {
+		for (int i = srcTop - args + 1; i <= srcTop; i++) {
+			if (LuaSharedArray::PushView(L, srcState, i))
+				continue;
+
+			lua_pushvalue(srcState, i);
+			LuaUtils::CopyData(L, srcState, 1);
+			lua_pop(srcState, 1);
+		}
+	}
 
 	// call the routine
 	RunCallIn(L, cmdStr, args, 0);
@@ -509,6 +533,7 @@ bool CSyncedLuaHandle::Init(std::string code, const std::string& file)
 		if (!AddEntriesToTable(L, "WeaponDefs",     LuaWeaponDefs::PushEntries      )) KILL
 		if (!AddEntriesToTable(L, "FeatureDefs",   LuaFeatureDefs::PushEntries      )) KILL
 		if (!AddEntriesToTable(L, "Script",          LuaInterCall::PushEntriesSynced)) KILL
+		if (!AddEntriesToTable(L, "Script",        LuaSharedArray::PushSynced       )) KILL
 		if (!AddEntriesToTable(L, "Spring",       LuaUnsyncedCtrl::PushEntries      )) KILL
 		if (!AddEntriesToTable(L, "Spring",         LuaSyncedCtrl::PushEntries      )) KILL
 		if (!AddEntriesToTable(L, "Spring",         LuaSyncedRead::PushEntries      )) KILL
@@ -1971,7 +1996,26 @@ int CSyncedLuaHandle::SendToUnsynced(lua_State* L)
 		| (1 << LUA_TSTRING)
 	;
 
+	CSyncedLuaHandle* slh = GetSyncedHandle(L);
+
+	// views handed out during an earlier frame have expired; all pins
+	// are released together so the list only ever spans a single frame
+	if (!slh->pinnedSharedArrays.empty() && slh->pinnedSharedArrays.front().second != gs->frameNum) {
+		for (const auto& pinned: slh->pinnedSharedArrays) {
+			luaL_unref(L, LUA_REGISTRYINDEX, pinned.first);
+		}
+
+		slh->pinnedSharedArrays.clear();
+	}
+
 	for (int i = 1; i <= args; i++) {
+		if (LuaSharedArray::IsSharedArray(L, i)) {
+			// keep the array alive for as long as the view is valid
+			lua_pushvalue(L, i);
+			slh->pinnedSharedArrays.emplace_back(luaL_ref(L, LUA_REGISTRYINDEX), gs->frameNum);
+			continue;
+		}
+
 		const int t = (1 << lua_type(L, i));
 		if (!(t & supportedTypes)) {
 			luaL_error(L, "Incorrect data type for SendToUnsynced(), arg %d", i);
@@ -2254,6 +2298,9 @@ bool CSplitLuaHandle::SwapSyncedHandle(lua_State* L, lua_State* L_GC)
 	LUA_CLOSE(&syncedLuaHandle.L);
 	syncedLuaHandle.SetLuaStates(L, L_GC);
 
+	// pins are not serialized, their refs belonged to the closed state
+	syncedLuaHandle.pinnedSharedArrays.clear();
+
 	if (!IsValid()) {
 		return false;
 	}
@@ -2290,7 +2337,7 @@ int CSplitLuaHandle::LoadStringData(lua_State* L)
 	const char *str    = luaL_checklstring(L, 1, &len);
 	const char *chunkname = luaL_optstring(L, 2, str);
 
-	if (luaL_loadbuffer(L, str, len, chunkname) != 0) {
+	if (LuaBytecodeCache::LoadBuffer(L, str, len, chunkname) != 0) {
 		lua_pushnil(L);
 		lua_insert(L, -2);
 		return 2; // nil, then the error message
@@ -4,6 +4,8 @@
 #define LUA_HANDLE_SYNCED
 
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "LuaHandle.h"
 #include "LuaRulesParams.h"
@@ -138,6 +140,9 @@ class CSyncedLuaHandle : public CLuaHandle
 	private:
 		int origNextRef;
 
+		// {registry ref, frame} of SharedArrays whose views were sent to unsynced
+		std::vector< std::pair<int, int> > pinnedSharedArrays;
+
 	private: // call-outs
 		static int SyncedRandom(lua_State* L);
 		static int SyncedRandomSeed(lua_State* L);
@@ -268,7 +273,7 @@ class CSplitLuaHandle
 		CUnsyncedLuaHandle unsyncedLuaHandle;
 
 	public:
-		static void ClearGameParams() { spring::clear_unordered_map(gameParams); }
+		static void ClearGameParams() { gameParams.clear(); LuaRulesParams::ClearKeys(); }
 		static const LuaRulesParams::Params& GetGameParams() { return gameParams; }
 
 	private:
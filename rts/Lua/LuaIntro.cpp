@@ -4,6 +4,7 @@
 
 #include "LuaInclude.h"
 #include "LuaArchive.h"
+#include "LuaBytecodeCache.h"
 #include "LuaUnsyncedCtrl.h"
 #include "LuaCallInCheck.h"
 #include "LuaConstGL.h"
@@ -96,6 +97,7 @@ CLuaIntro::CLuaIntro()
 	lua_pushvalue(L, LUA_GLOBALSINDEX);
 
 	AddBasicCalls(L); // into Global
+	LuaBytecodeCache::PushEntries(L);
 
 	// load the spring libraries
 	if (
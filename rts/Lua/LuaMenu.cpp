@@ -4,6 +4,7 @@
 
 #include "LuaInclude.h"
 #include "LuaArchive.h"
+#include "LuaBytecodeCache.h"
 #include "LuaCallInCheck.h"
 #include "LuaConstEngine.h"
 #include "LuaConstGL.h"
@@ -107,6 +108,7 @@ CLuaMenu::CLuaMenu()
 	lua_pushvalue(L, LUA_GLOBALSINDEX);
 
 	AddBasicCalls(L); // into Global
+	LuaBytecodeCache::PushEntries(L);
 
 	// load the spring libraries
 	if (
@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <climits>
+#include <cstring>
 
 #include "lib/streflop/streflop_cond.h"
 
@@ -12,6 +13,7 @@
 #include "System/float4.h"
 #include "LuaInclude.h"
 
+#include "LuaBytecodeCache.h"
 #include "LuaConstGame.h"
 #include "LuaConstEngine.h"
 #include "LuaIO.h"
@@ -237,7 +239,13 @@ bool LuaParser::Execute()
 	int errorNum = 0;
 
 	tracy::LuaRemove(code.data());
-	if ((errorNum = luaL_loadbuffer(L, code.c_str(), code.size(), codeLabel.c_str())) != 0) {
+	#if (!defined(UNITSYNC) && !defined(DEDICATED))
+	errorNum = LuaBytecodeCache::LoadBuffer(L, code.c_str(), code.size(), codeLabel.c_str());
+	#else
+	errorNum = luaL_loadbuffer(L, code.c_str(), code.size(), codeLabel.c_str());
+	#endif
+
+	if (errorNum != 0) {
 		SNPRINTF(errorBuf, sizeof(errorBuf), "[loadbuf] error %d (\"%s\") in %s", errorNum, lua_tostring(L, -1), codeLabel.c_str());
 		LUA_CLOSE(&L);
 
@@ -302,6 +310,59 @@ LuaTable LuaParser::GetRoot()
 }
 
 
+/******************************************************************************/
+
+bool LuaParser::DumpRoot(std::vector<std::uint8_t>& data)
+{
+	if (!IsValid() || rootRef == LUA_NOREF)
+		return false;
+
+	lua_rawgeti(L, LUA_REGISTRYINDEX, rootRef);
+
+	const bool dumped = LuaUtils::DumpValue(L, -1, data);
+
+	lua_settop(L, 0);
+	return dumped;
+}
+
+bool LuaParser::DumpGlobal(const char* name, std::vector<std::uint8_t>& data)
+{
+	if (!IsValid())
+		return false;
+
+	const int top = lua_gettop(L);
+
+	lua_getglobal(L, name);
+
+	const bool dumped = lua_istable(L, -1) && LuaUtils::DumpValue(L, -1, data);
+
+	lua_settop(L, top);
+	return dumped;
+}
+
+bool LuaParser::RestoreRoot(const std::uint8_t* data, size_t size)
+{
+	if (!IsValid())
+		return false;
+
+	assert(rootRef == LUA_NOREF);
+	assert(initDepth == 0);
+
+	const std::uint8_t* pos = data;
+
+	if (!LuaUtils::RestoreValue(L, pos, data + size) || pos != (data + size) || !lua_istable(L, -1)) {
+		lua_settop(L, 0);
+		return false;
+	}
+
+	initDepth = -1;
+	rootRef = luaL_ref(L, LUA_REGISTRYINDEX);
+	lua_settop(L, 0);
+
+	return (valid = true);
+}
+
+
 /******************************************************************************/
 
 void LuaParser::PushParam()
@@ -526,6 +587,7 @@ int LuaParser::Random(lua_State* L)
 {
 	// both US and DS depend on LuaParser via MapParser, etc
 	#if (!defined(UNITSYNC) && !defined(DEDICATED))
+	GetLuaParser(L)->usedRandom = true;
 
 	switch (lua_gettop(L)) {
 		case 0: {
@@ -644,7 +706,11 @@ int LuaParser::Include(lua_State* L)
 	}
 
 	tracy::LuaRemove(code.data());
+	#if (!defined(UNITSYNC) && !defined(DEDICATED))
+	int error = LuaBytecodeCache::LoadBuffer(L, code.c_str(), code.size(), filename.c_str());
+	#else
 	int error = luaL_loadbuffer(L, code.c_str(), code.size(), filename.c_str());
+	#endif
 	if (error != 0) {
 		char buf[1024];
 		SNPRINTF(buf, sizeof(buf), "error = %i, %s, %s\n", error, filename.c_str(), lua_tostring(L, -1));
@@ -3,6 +3,7 @@
 #ifndef LUA_PARSER_H
 #define LUA_PARSER_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -140,6 +141,17 @@ public:
 		return GetRoot().SubTableExpr(expr);
 	}
 
+	// binary snapshots of plain data tables; dumping fails if a table holds
+	// functions or userdata, has a metatable or contains itself
+	bool DumpRoot(std::vector<std::uint8_t>& data);
+	bool DumpGlobal(const char* name, std::vector<std::uint8_t>& data);
+	// alternative to Execute, makes the snapshot the root table
+	bool RestoreRoot(const std::uint8_t* data, size_t size);
+
+	// true if the executed code drew from gsRNG, i.e. its result is not
+	// reproducible from the parser inputs alone
+	bool UsedRandom() const { return usedRandom; }
+
 	const std::string& GetErrorLog() const { return errorLog; }
 
 	// for setting up the initial params table
@@ -189,6 +201,7 @@ private:
 	int currentRef = -1;
 
 	bool valid = false;
+	bool usedRandom = false;
 	bool lowerKeys = false; // convert all returned keys to lower case
 	bool lowerCppKeys = false; // convert strings in arguments keys to lower case
 
@@ -1,6 +1,10 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include <algorithm>
+#include <memory>
+
 #include "LuaRulesParams.h"
+#include "System/creg/ISerializer.h"
 #include "System/creg/STL_Variant.h"
 
 using namespace LuaRulesParams;
@@ -10,3 +14,110 @@ CR_REG_METADATA(Param, (
 	CR_MEMBER(los),
 	CR_MEMBER(value)
 ))
+
+CR_BIND(Params::Entry,)
+CR_REG_METADATA_SUB(Params, Entry, (
+	CR_MEMBER(key),
+	CR_MEMBER(param)
+))
+
+CR_BIND(Params,)
+CR_REG_METADATA(Params, (
+	CR_MEMBER(entries)
+))
+
+
+static std::vector<std::string> keyNames;
+static spring::unordered_map<std::string, int> keyIndices;
+
+
+int LuaRulesParams::AddKey(const std::string& name)
+{
+	const auto pair = keyIndices.emplace(name, keyNames.size());
+
+	if (pair.second)
+		keyNames.push_back(name);
+
+	return pair.first->second;
+}
+
+int LuaRulesParams::GetKey(const std::string& name)
+{
+	const auto iter = keyIndices.find(name);
+
+	if (iter == keyIndices.end())
+		return -1;
+
+	return iter->second;
+}
+
+const std::string& LuaRulesParams::GetKeyName(int key)
+{
+	static const std::string invalidName;
+
+	if (!IsValidKey(key))
+		return invalidName;
+
+	return keyNames[key];
+}
+
+bool LuaRulesParams::IsValidKey(int key)
+{
+	return (key >= 0 && key < static_cast<int>(keyNames.size()));
+}
+
+void LuaRulesParams::ClearKeys()
+{
+	keyNames.clear();
+	spring::clear_unordered_map(keyIndices);
+}
+
+void LuaRulesParams::SerializeKeys(creg::ISerializer* s)
+{
+	std::unique_ptr<creg::IType> vecType = creg::DeduceType<decltype(keyNames)>::Get();
+	vecType->Serialize(s, &keyNames);
+
+	if (s->IsWriting())
+		return;
+
+	// saved entries refer to the saved keys, replace whatever this session interned
+	spring::clear_unordered_map(keyIndices);
+
+	for (size_t i = 0; i < keyNames.size(); i++) {
+		keyIndices.emplace(keyNames[i], i);
+	}
+}
+
+
+static bool EntryKeyLess(const Params::Entry& e, int key) { return (e.key < key); }
+
+const Param* Params::Find(int key) const
+{
+	const auto iter = std::lower_bound(entries.begin(), entries.end(), key, EntryKeyLess);
+
+	if (iter == entries.end() || iter->key != key)
+		return nullptr;
+
+	return &iter->param;
+}
+
+Param& Params::Insert(int key)
+{
+	const auto iter = std::lower_bound(entries.begin(), entries.end(), key, EntryKeyLess);
+
+	if (iter != entries.end() && iter->key == key)
+		return iter->param;
+
+	return (entries.insert(iter, Entry{key, {}})->param);
+}
+
+bool Params::Erase(int key)
+{
+	const auto iter = std::lower_bound(entries.begin(), entries.end(), key, EntryKeyLess);
+
+	if (iter == entries.end() || iter->key != key)
+		return false;
+
+	entries.erase(iter);
+	return true;
+}
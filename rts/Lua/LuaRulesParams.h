@@ -5,10 +5,15 @@
 
 #include <string>
 #include <variant>
+#include <vector>
 
 #include "System/UnorderedMap.hpp"
 #include "System/creg/creg_cond.h"
 
+namespace creg {
+	class ISerializer;
+}
+
 namespace LuaRulesParams
 {
 	enum {
@@ -35,7 +40,52 @@ namespace LuaRulesParams
 		std::variant <bool, float, std::string> value;
 	};
 
-	typedef spring::unordered_map<std::string, Param> Params;
+	/**
+	 * Rules-param names are interned into small integer keys shared by every
+	 * Params container, so lookups compare ints instead of hashing strings.
+	 * Keys are only ever added by synced code (in simulation order), which
+	 * keeps them identical across clients; unsynced code can only look up
+	 * names that already exist.
+	 */
+	int AddKey(const std::string& name);
+	int GetKey(const std::string& name);
+	const std::string& GetKeyName(int key);
+
+	bool IsValidKey(int key);
+	void ClearKeys();
+	void SerializeKeys(creg::ISerializer* s);
+
+
+	/// per-object rules-params, a small vector kept sorted by interned key
+	class Params {
+		CR_DECLARE_STRUCT(Params)
+
+	public:
+		struct Entry {
+			CR_DECLARE_STRUCT(Entry)
+
+			int   key = -1;
+			Param param;
+		};
+
+	public:
+		const Param* Find(int key) const;
+		const Param* Find(const std::string& name) const { return (Find(GetKey(name))); }
+
+		Param& Insert(int key);
+		bool Erase(int key);
+
+		void clear() { entries.clear(); }
+
+		bool empty() const { return entries.empty(); }
+		size_t size() const { return entries.size(); }
+
+		std::vector<Entry>::const_iterator begin() const { return entries.begin(); }
+		std::vector<Entry>::const_iterator end() const { return entries.end(); }
+
+	private:
+		std::vector<Entry> entries;
+	};
 }
 
 #endif // LUA_RULESPARAMS_H
@@ -0,0 +1,427 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+
+/******************************************************************************
+ * LuaSharedArray
+ * @module LuaSharedArray
+ *
+ * @see rts/Lua/LuaSharedArray.cpp
+******************************************************************************/
+
+
+/**
+ * @class LuaSharedArray
+ *
+ * @brief Typed numeric arrays passed from synced to unsynced code by reference
+ *
+ * Synced code creates an array with Script.CreateSharedArray and passes it
+ * to SendToUnsynced, which hands RecvFromSynced a read-only view of the same
+ * memory instead of a copy. Both support:
+ *  - arr[i]                 : element i (1-based), nil if out of range
+ *  - #arr                   : number of elements
+ *  - arr:Get(i[, count])    : count elements starting at i, as multiple values
+ * Synced arrays also support:
+ *  - arr[i] = v             : sets element i
+ *  - arr:Set(i, v1, v2, ...) or arr:Set(i, {v1, v2, ...}) : sets consecutive elements
+ *  - arr:Fill(v)            : sets every element
+ * Views also support:
+ *  - view:IsValid()         : false once the frame the view was sent in has ended
+ *
+ * A view reads whatever the array holds at the time of access, so synced
+ * writes made after SendToUnsynced in the same frame are visible to it. Any
+ * access to an expired view raises an error.
+ */
+
+#include <cstring>
+
+#include "LuaSharedArray.h"
+#include "LuaInclude.h"
+#include "LuaHashString.h"
+#include "Sim/Misc/GlobalSynced.h"
+
+
+enum {
+	SHARED_ARRAY_FLOAT = 0,
+	SHARED_ARRAY_INT   = 1,
+};
+
+static constexpr uint32_t MAX_SHARED_ARRAY_SIZE = 1 << 24;
+
+
+// element data directly follows the header inside the userdatum
+struct SharedArrayHeader {
+	uint32_t type;
+	uint32_t size;
+
+	uint8_t* GetData() { return (reinterpret_cast<uint8_t*>(this + 1)); }
+	const uint8_t* GetData() const { return (reinterpret_cast<const uint8_t*>(this + 1)); }
+};
+
+// the viewed array lives in the synced state of the same split handle and is
+// pinned in its registry until the frame ends (see CSyncedLuaHandle::SendToUnsynced)
+struct SharedArrayView {
+	const SharedArrayHeader* array;
+	int frameNum;
+};
+
+
+// [start, start + count) must lie within the array; the arithmetic is done
+// in size_t because both values come straight from Lua and can be huge
+static bool IsValidRange(const SharedArrayHeader* array, int start, int count)
+{
+	if (start < 1 || count < 0)
+		return false;
+	if (size_t(start - 1) > array->size)
+		return false;
+
+	return (size_t(count) <= (array->size - size_t(start - 1)));
+}
+
+static void PushElement(lua_State* L, const SharedArrayHeader* array, uint32_t i)
+{
+	const uint8_t* data = array->GetData() + i * sizeof(float);
+
+	switch (array->type) {
+		case SHARED_ARRAY_FLOAT: {
+			float value;
+			std::memcpy(&value, data, sizeof(value));
+			lua_pushnumber(L, value);
+		} break;
+		case SHARED_ARRAY_INT: {
+			int32_t value;
+			std::memcpy(&value, data, sizeof(value));
+			lua_pushnumber(L, value);
+		} break;
+		default: {
+			lua_pushnil(L);
+		} break;
+	}
+}
+
+static void SetElement(lua_State* L, SharedArrayHeader* array, uint32_t i, int valIndex)
+{
+	uint8_t* data = array->GetData() + i * sizeof(float);
+
+	switch (array->type) {
+		case SHARED_ARRAY_FLOAT: {
+			const float value = luaL_checkfloat(L, valIndex);
+			std::memcpy(data, &value, sizeof(value));
+		} break;
+		case SHARED_ARRAY_INT: {
+			const int32_t value = luaL_checkint(L, valIndex);
+			std::memcpy(data, &value, sizeof(value));
+		} break;
+		default: {
+		} break;
+	}
+}
+
+static int PushElements(lua_State* L, const SharedArrayHeader* array)
+{
+	const int start = luaL_checkint(L, 2);
+	const int count = luaL_optint(L, 3, 1);
+
+	if (!IsValidRange(array, start, count))
+		luaL_error(L, "SharedArray:Get(%d, %d) out of range (size %d)", start, count, array->size);
+
+	luaL_checkstack(L, count, __func__);
+
+	for (int i = 0; i < count; i++) {
+		PushElement(L, array, start - 1 + i);
+	}
+
+	return count;
+}
+
+
+static SharedArrayHeader* ToArray(lua_State* L, int index)
+{
+	return (static_cast<SharedArrayHeader*>(luaL_checkudata(L, index, "SharedArray")));
+}
+
+static const SharedArrayHeader* ToView(lua_State* L, int index)
+{
+	const SharedArrayView* view = static_cast<const SharedArrayView*>(luaL_checkudata(L, index, "SharedArrayView"));
+
+	if (view->frameNum != gs->frameNum)
+		luaL_error(L, "SharedArray view from frame %d has expired", view->frameNum);
+
+	return view->array;
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+bool LuaSharedArray::PushSynced(lua_State* L)
+{
+	CreateMetatable(L);
+
+	HSTR_PUSH_CFUNC(L, "CreateSharedArray", CreateSharedArray);
+	return true;
+}
+
+
+bool LuaSharedArray::PushUnsynced(lua_State* L)
+{
+	CreateViewMetatable(L);
+	return true;
+}
+
+
+bool LuaSharedArray::CreateMetatable(lua_State* L)
+{
+	luaL_newmetatable(L, "SharedArray");
+
+	HSTR_PUSH_CFUNC(L, "__index",    meta_index);
+	HSTR_PUSH_CFUNC(L, "__newindex", meta_newindex);
+	HSTR_PUSH_CFUNC(L, "__len",      meta_len);
+	HSTR_PUSH_CFUNC(L, "Get",        meta_get);
+	HSTR_PUSH_CFUNC(L, "Set",        meta_set);
+	HSTR_PUSH_CFUNC(L, "Fill",       meta_fill);
+
+	lua_pop(L, 1);
+	return true;
+}
+
+
+bool LuaSharedArray::CreateViewMetatable(lua_State* L)
+{
+	luaL_newmetatable(L, "SharedArrayView");
+
+	HSTR_PUSH_CFUNC(L, "__index",    view_index);
+	HSTR_PUSH_CFUNC(L, "__newindex", view_newindex);
+	HSTR_PUSH_CFUNC(L, "__len",      view_len);
+	HSTR_PUSH_CFUNC(L, "Get",        view_get);
+	HSTR_PUSH_CFUNC(L, "IsValid",    view_isvalid);
+
+	lua_pop(L, 1);
+	return true;
+}
+
+
+bool LuaSharedArray::IsSharedArray(lua_State* L, int index)
+{
+	if (lua_type(L, index) != LUA_TUSERDATA)
+		return false;
+	if (!lua_getmetatable(L, index))
+		return false;
+
+	luaL_getmetatable(L, "SharedArray");
+
+	const bool ret = lua_rawequal(L, -1, -2);
+
+	lua_pop(L, 2);
+	return ret;
+}
+
+
+bool LuaSharedArray::PushView(lua_State* dst, lua_State* src, int srcIndex)
+{
+	if (!IsSharedArray(src, srcIndex))
+		return false;
+
+	luaL_checkstack(dst, 2, __func__);
+
+	SharedArrayView* view = static_cast<SharedArrayView*>(lua_newuserdata(dst, sizeof(SharedArrayView)));
+
+	view->array = static_cast<const SharedArrayHeader*>(lua_touserdata(src, srcIndex));
+	view->frameNum = gs->frameNum;
+
+	luaL_getmetatable(dst, "SharedArrayView");
+	lua_setmetatable(dst, -2);
+	return true;
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+/***
+ * @function Script.CreateSharedArray
+ * @string type "float" or "int"
+ * @number size
+ * @treturn SharedArray array zero-initialized
+ */
+int LuaSharedArray::CreateSharedArray(lua_State* L)
+{
+	const char* typeName = luaL_checkstring(L, 1);
+	const int size = luaL_checkint(L, 2);
+
+	uint32_t type = 0;
+
+	if (std::strcmp(typeName, "float") == 0) {
+		type = SHARED_ARRAY_FLOAT;
+	} else if (std::strcmp(typeName, "int") == 0) {
+		type = SHARED_ARRAY_INT;
+	} else {
+		luaL_error(L, "[%s] unknown element type \"%s\"", __func__, typeName);
+	}
+
+	if (size < 0 || size > static_cast<int>(MAX_SHARED_ARRAY_SIZE))
+		luaL_error(L, "[%s] invalid size %d", __func__, size);
+
+	const size_t dataSize = size * sizeof(float);
+
+	SharedArrayHeader* array = static_cast<SharedArrayHeader*>(lua_newuserdata(L, sizeof(SharedArrayHeader) + dataSize));
+
+	array->type = type;
+	array->size = size;
+	std::memset(array->GetData(), 0, dataSize);
+
+	luaL_getmetatable(L, "SharedArray");
+	lua_setmetatable(L, -2);
+	return 1;
+}
+
+
+int LuaSharedArray::meta_index(lua_State* L)
+{
+	const SharedArrayHeader* array = ToArray(L, 1);
+
+	if (lua_israwnumber(L, 2)) {
+		const int i = lua_toint(L, 2);
+
+		if (i < 1 || i > static_cast<int>(array->size))
+			return 0;
+
+		PushElement(L, array, i - 1);
+		return 1;
+	}
+
+	// methods
+	lua_getmetatable(L, 1);
+	lua_pushvalue(L, 2);
+	lua_rawget(L, -2);
+	return 1;
+}
+
+
+int LuaSharedArray::meta_newindex(lua_State* L)
+{
+	SharedArrayHeader* array = ToArray(L, 1);
+
+	const int i = luaL_checkint(L, 2);
+
+	if (i < 1 || i > static_cast<int>(array->size))
+		luaL_error(L, "SharedArray index %d out of range (size %d)", i, array->size);
+
+	SetElement(L, array, i - 1, 3);
+	return 0;
+}
+
+
+int LuaSharedArray::meta_len(lua_State* L)
+{
+	lua_pushnumber(L, ToArray(L, 1)->size);
+	return 1;
+}
+
+
+int LuaSharedArray::meta_get(lua_State* L)
+{
+	return (PushElements(L, ToArray(L, 1)));
+}
+
+
+int LuaSharedArray::meta_set(lua_State* L)
+{
+	SharedArrayHeader* array = ToArray(L, 1);
+
+	const int start = luaL_checkint(L, 2);
+
+	if (lua_istable(L, 3)) {
+		const int count = lua_objlen(L, 3);
+
+		if (!IsValidRange(array, start, count))
+			luaL_error(L, "SharedArray:Set(%d) of %d elements out of range (size %d)", start, count, array->size);
+
+		for (int i = 0; i < count; i++) {
+			lua_rawgeti(L, 3, i + 1);
+			SetElement(L, array, start - 1 + i, -1);
+			lua_pop(L, 1);
+		}
+
+		return 0;
+	}
+
+	const int count = lua_gettop(L) - 2;
+
+	if (!IsValidRange(array, start, count))
+		luaL_error(L, "SharedArray:Set(%d) of %d elements out of range (size %d)", start, count, array->size);
+
+	for (int i = 0; i < count; i++) {
+		SetElement(L, array, start - 1 + i, 3 + i);
+	}
+
+	return 0;
+}
+
+
+int LuaSharedArray::meta_fill(lua_State* L)
+{
+	SharedArrayHeader* array = ToArray(L, 1);
+
+	if (array->size == 0)
+		return 0;
+
+	SetElement(L, array, 0, 2);
+
+	for (uint32_t i = 1; i < array->size; i++) {
+		std::memcpy(array->GetData() + i * sizeof(float), array->GetData(), sizeof(float));
+	}
+
+	return 0;
+}
+
+
+int LuaSharedArray::view_index(lua_State* L)
+{
+	luaL_checkudata(L, 1, "SharedArrayView");
+
+	if (lua_israwnumber(L, 2)) {
+		const SharedArrayHeader* array = ToView(L, 1);
+		const int i = lua_toint(L, 2);
+
+		if (i < 1 || i > static_cast<int>(array->size))
+			return 0;
+
+		PushElement(L, array, i - 1);
+		return 1;
+	}
+
+	// methods
+	lua_getmetatable(L, 1);
+	lua_pushvalue(L, 2);
+	lua_rawget(L, -2);
+	return 1;
+}
+
+
+int LuaSharedArray::view_newindex(lua_State* L)
+{
+	luaL_error(L, "SharedArray views are read-only");
+	return 0;
+}
+
+
+int LuaSharedArray::view_len(lua_State* L)
+{
+	lua_pushnumber(L, ToView(L, 1)->size);
+	return 1;
+}
+
+
+int LuaSharedArray::view_get(lua_State* L)
+{
+	return (PushElements(L, ToView(L, 1)));
+}
+
+
+int LuaSharedArray::view_isvalid(lua_State* L)
+{
+	const SharedArrayView* view = static_cast<const SharedArrayView*>(luaL_checkudata(L, 1, "SharedArrayView"));
+
+	lua_pushboolean(L, view->frameNum == gs->frameNum);
+	return 1;
+}
@@ -0,0 +1,49 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef LUA_SHARED_ARRAY_H
+#define LUA_SHARED_ARRAY_H
+
+struct lua_State;
+
+
+/**
+ * Typed numeric arrays that synced code fills and passes to its unsynced
+ * half through SendToUnsynced without copying. The synced side owns the
+ * storage (a plain userdatum, so savegames handle it like any other);
+ * the unsynced side receives a read-only view that points into it and
+ * expires when the game frame it was sent in ends.
+ */
+class LuaSharedArray {
+public:
+	static bool PushSynced(lua_State* L);
+	static bool PushUnsynced(lua_State* L);
+
+	static bool IsSharedArray(lua_State* L, int index);
+
+	/// pushes a view of the synced array at srcIndex onto dst
+	static bool PushView(lua_State* dst, lua_State* src, int srcIndex);
+
+private: // call-outs
+	static int CreateSharedArray(lua_State* L);
+
+private: // metatable methods
+	static bool CreateMetatable(lua_State* L);
+	static bool CreateViewMetatable(lua_State* L);
+
+	static int meta_index(lua_State* L);
+	static int meta_newindex(lua_State* L);
+	static int meta_len(lua_State* L);
+
+	static int meta_get(lua_State* L);
+	static int meta_set(lua_State* L);
+	static int meta_fill(lua_State* L);
+
+	static int view_index(lua_State* L);
+	static int view_newindex(lua_State* L);
+	static int view_len(lua_State* L);
+
+	static int view_get(lua_State* L);
+	static int view_isvalid(lua_State* L);
+};
+
+#endif /* LUA_SHARED_ARRAY_H */
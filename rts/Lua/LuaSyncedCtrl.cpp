@@ -1302,9 +1302,24 @@ void SetRulesParam(lua_State* L, const char* caller, int offset,
 	const int valIndex = offset + 2;
 	const int losIndex = offset + 3; // table
 
-	const std::string& key = luaL_checkstring(L, index);
+	int key = -1;
 
-	LuaRulesParams::Param& param = params[key];
+	// handles returned by Spring.GetRulesParamKey skip the name lookup
+	if (lua_islightuserdata(L, index)) {
+		key = static_cast<int>(reinterpret_cast<intptr_t>(lua_touserdata(L, index))) - 1;
+
+		if (!LuaRulesParams::IsValidKey(key))
+			luaL_error(L, "Invalid rules-param key in %s()", caller);
+	} else {
+		key = LuaRulesParams::AddKey(luaL_checkstring(L, index));
+	}
+
+	if (lua_isnoneornil(L, valIndex)) {
+		params.Erase(key);
+		return; //no need to set los if param was erased
+	}
+
+	LuaRulesParams::Param& param = params.Insert(key);
 
 	// set the value of the parameter
 	if (lua_israwnumber(L, valIndex)) {
@@ -1313,11 +1328,8 @@ void SetRulesParam(lua_State* L, const char* caller, int offset,
 		param.value.emplace <bool> (lua_toboolean(L, valIndex));
 	} else if (lua_isstring(L, valIndex)) {
 		param.value.emplace <std::string> (lua_tostring(L, valIndex));
-	} else if (lua_isnoneornil(L, valIndex)) {
-		params.erase(key);
-		return; //no need to set los if param was erased
 	} else {
-		params.erase(key);
+		params.Erase(key);
 		luaL_error(L, "Incorrect arguments to %s()", caller);
 	}
 
@@ -1354,7 +1366,7 @@ void SetRulesParam(lua_State* L, const char* caller, int offset,
 
 /***
  * @function Spring.SetGameRulesParam
- * @string paramName
+ * @tparam string|userdata paramName name or key from Spring.GetRulesParamKey
  * @tparam ?number|string paramValue numeric paramValues in quotes will be converted to number.
  * @tparam[opt] losAccess losAccess
  * @treturn nil
@@ -1369,7 +1381,7 @@ int LuaSyncedCtrl::SetGameRulesParam(lua_State* L)
 /***
  * @function Spring.SetTeamRulesParam
  * @number teamID
- * @string paramName
+ * @tparam string|userdata paramName name or key from Spring.GetRulesParamKey
  * @tparam ?number|string paramValue numeric paramValues in quotes will be converted to number.
  * @tparam[opt] losAccess losAccess
  * @treturn nil
@@ -1387,7 +1399,7 @@ int LuaSyncedCtrl::SetTeamRulesParam(lua_State* L)
 /***
  * @function Spring.SetPlayerRulesParam
  * @number playerID
- * @string paramName
+ * @tparam string|userdata paramName name or key from Spring.GetRulesParamKey
  * @tparam ?number|string paramValue numeric paramValues in quotes will be converted to number.
  * @tparam[opt] losAccess losAccess
  * @treturn nil
@@ -1411,7 +1423,7 @@ int LuaSyncedCtrl::SetPlayerRulesParam(lua_State* L)
  *
  * @function Spring.SetUnitRulesParam
  * @number unitID
- * @string paramName
+ * @tparam string|userdata paramName name or key from Spring.GetRulesParamKey
  * @tparam ?number|string paramValue numeric paramValues in quotes will be converted to number.
  * @tparam[opt] losAccess losAccess
  * @treturn nil
@@ -1431,7 +1443,7 @@ int LuaSyncedCtrl::SetUnitRulesParam(lua_State* L)
 /***
  * @function Spring.SetFeatureRulesParam
  * @number featureID
- * @string paramName
+ * @tparam string|userdata paramName name or key from Spring.GetRulesParamKey
  * @tparam ?number|string paramValue numeric paramValues in quotes will be converted to number.
  * @tparam[opt] losAccess losAccess
  * @treturn nil
@@ -118,6 +118,7 @@ bool LuaSyncedRead::PushEntries(lua_State* L)
 	REGISTER_LUA_CFUNC(GetGameFrame);
 	REGISTER_LUA_CFUNC(GetGameSeconds);
 
+	REGISTER_LUA_CFUNC(GetRulesParamKey);
 	REGISTER_LUA_CFUNC(GetGameRulesParam);
 	REGISTER_LUA_CFUNC(GetGameRulesParams);
 
@@ -283,6 +284,7 @@ bool LuaSyncedRead::PushEntries(lua_State* L)
 
 	REGISTER_LUA_CFUNC(GetUnitRulesParam);
 	REGISTER_LUA_CFUNC(GetUnitRulesParams);
+	REGISTER_LUA_CFUNC(GetUnitsRulesParam);
 
 	REGISTER_LUA_CFUNC(GetCEGID);
 
@@ -685,27 +687,42 @@ static inline const CTeam* ParseTeam(lua_State* L, const char* caller, int index
 
 /******************************************************************************/
 
+static int ParseRulesParamKey(lua_State* L, int index)
+{
+	// handles returned by Spring.GetRulesParamKey skip the name lookup
+	if (lua_islightuserdata(L, index))
+		return (static_cast<int>(reinterpret_cast<intptr_t>(lua_touserdata(L, index))) - 1);
+
+	return (LuaRulesParams::GetKey(luaL_checkstring(L, index)));
+}
+
+static void PushRulesParamValue(lua_State* L, const LuaRulesParams::Param& param)
+{
+	std::visit ([L](auto&& value) {
+		using T = std::decay_t <decltype(value)>;
+		if constexpr (std::is_same_v <T, float>)
+			lua_pushnumber(L, value);
+		else if constexpr (std::is_same_v <T, bool>)
+			lua_pushboolean(L, value);
+		else if constexpr (std::is_same_v <T, std::string>)
+			lua_pushsstring(L, value);
+	}, param.value);
+}
+
 static int PushRulesParams(lua_State* L, const char* caller,
                           const LuaRulesParams::Params& params,
                           const int losStatus)
 {
 	lua_createtable(L, 0, params.size());
 
-	for (const auto& it: params) {
-		const std::string& name = it.first;
-		const LuaRulesParams::Param& param = it.second;
+	for (const auto& entry: params) {
+		const LuaRulesParams::Param& param = entry.param;
 		if (!(param.los & losStatus))
 			continue;
 
-		std::visit ([L, &name](auto&& value) {
-			using T = std::decay_t <decltype(value)>;
-			if constexpr (std::is_same_v <T, float>)
-				LuaPushNamedNumber(L, name, value);
-			else if constexpr (std::is_same_v <T, bool>)
-				LuaPushNamedBool(L, name, value);
-			else if constexpr (std::is_same_v <T, std::string>)
-				LuaPushNamedString(L, name, value);
-		}, param.value);
+		lua_pushsstring(L, LuaRulesParams::GetKeyName(entry.key));
+		PushRulesParamValue(L, param);
+		lua_rawset(L, -3);
 	}
 
 	return 1;
@@ -716,25 +733,14 @@ static int GetRulesParam(lua_State* L, const char* caller, int index,
                           const LuaRulesParams::Params& params,
                           const int& losStatus)
 {
-	const std::string& key = luaL_checkstring(L, index);
-	const auto it = params.find(key);
-	if (it == params.end())
+	const LuaRulesParams::Param* param = params.Find(ParseRulesParamKey(L, index));
+	if (param == nullptr)
 		return 0;
 
-	const LuaRulesParams::Param& param = it->second;
-	if (!(param.los & losStatus))
+	if (!(param->los & losStatus))
 		return 0;
 
-	std::visit ([L](auto&& value) {
-		using T = std::decay_t <decltype(value)>;
-		if constexpr (std::is_same_v <T, float>)
-			lua_pushnumber(L, value);
-		else if constexpr (std::is_same_v <T, bool>)
-			lua_pushboolean(L, value);
-		else if constexpr (std::is_same_v <T, std::string>)
-			lua_pushsstring(L, value);
-	}, param.value);
-
+	PushRulesParamValue(L, *param);
 	return 1;
 }
 
@@ -958,6 +964,30 @@ int LuaSyncedRead::GetWind(lua_State* L)
 ******************************************************************************/
 
 
+/*** Returns a handle for a rules-param name
+ *
+ * The handle can be passed as ruleRef to all Get*RulesParam and
+ * Set*RulesParam functions, which then skip looking up the name.
+ * Unsynced code can only obtain handles for names that synced
+ * code has already used, and receives nil otherwise.
+ *
+ * @function Spring.GetRulesParamKey
+ * @string paramName
+ * @treturn nil|userdata key
+ */
+int LuaSyncedRead::GetRulesParamKey(lua_State* L)
+{
+	const std::string& name = luaL_checkstring(L, 1);
+	const int key = CLuaHandle::GetHandleSynced(L)? LuaRulesParams::AddKey(name): LuaRulesParams::GetKey(name);
+
+	if (key < 0)
+		return 0;
+
+	lua_pushlightuserdata(L, reinterpret_cast<void*>(static_cast<intptr_t>(key + 1)));
+	return 1;
+}
+
+
 /***
  *
  * @function Spring.GetGameRulesParams
@@ -1213,6 +1243,49 @@ int LuaSyncedRead::GetUnitRulesParam(lua_State* L)
 }
 
 
+/*** Returns the value of one rules-param for each unit in an array
+ *
+ * Units that are invalid, not visible or whose param is not readable by
+ * the caller are left out of the result.
+ *
+ * @function Spring.GetUnitsRulesParam
+ * @tparam {number,...} unitIDs
+ * @tparam number|string ruleRef the rule index or name
+ * @treturn {[number] = number|string,...} values map with unitIDs as key
+ */
+int LuaSyncedRead::GetUnitsRulesParam(lua_State* L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+
+	if (game == nullptr)
+		return 0;
+
+	const int key = ParseRulesParamKey(L, 2);
+	const int numUnits = lua_objlen(L, 1);
+
+	lua_createtable(L, 0, numUnits);
+
+	for (int i = 1; i <= numUnits; i++) {
+		lua_rawgeti(L, 1, i);
+		const CUnit* unit = ParseUnit(L, __func__, -1);
+		lua_pop(L, 1);
+
+		if (unit == nullptr)
+			continue;
+
+		const LuaRulesParams::Param* param = unit->modParams.Find(key);
+
+		if (param == nullptr || !(param->los & GetUnitRulesParamLosMask(L, unit)))
+			continue;
+
+		PushRulesParamValue(L, *param);
+		lua_rawseti(L, -2, unit->id);
+	}
+
+	return 1;
+}
+
+
 /***
  *
  * @function Spring.GetFeatureRulesParam
@@ -46,6 +46,7 @@ class LuaSyncedRead {
 		static int GetGameFrame(lua_State* L);
 		static int GetGameSeconds(lua_State* L);
 
+		static int GetRulesParamKey(lua_State* L);
 		static int GetGameRulesParam(lua_State* L);
 		static int GetGameRulesParams(lua_State* L);
 
@@ -185,6 +186,7 @@ class LuaSyncedRead {
 
 		static int GetUnitRulesParam(lua_State* L);
 		static int GetUnitRulesParams(lua_State* L);
+		static int GetUnitsRulesParam(lua_State* L);
 
 		static int GetUnitLosState(lua_State* L);
 		static int GetUnitSeparation(lua_State* L);
@@ -6,6 +6,7 @@
 #include "LuaInclude.h"
 #include "LuaUnsyncedCtrl.h"
 #include "LuaArchive.h"
+#include "LuaBytecodeCache.h"
 #include "LuaCallInCheck.h"
 #include "LuaConstGL.h"
 #include "LuaConstCMD.h"
@@ -17,6 +18,7 @@
 #include "LuaInterCall.h"
 #include "LuaUnsyncedRead.h"
 #include "LuaUICommand.h"
+#include "LuaUIWorker.h"
 #include "LuaFeatureDefs.h"
 #include "LuaUnitDefs.h"
 #include "LuaWeaponDefs.h"
@@ -134,6 +136,7 @@ CLuaUI::CLuaUI()
 	lua_pushvalue(L, LUA_GLOBALSINDEX);
 
 	AddBasicCalls(L); // into Global
+	LuaBytecodeCache::PushEntries(L);
 
 	// load the spring libraries
 	if (!LoadCFunctions(L)                                                   ||
@@ -184,6 +187,7 @@ CLuaUI::CLuaUI()
 
 CLuaUI::~CLuaUI()
 {
+	LuaUIWorker::KillWorkers();
 	luaUI = nullptr;
 }
 
@@ -263,6 +267,7 @@ bool CLuaUI::LoadCFunctions(lua_State* L)
 	lua_createtable(L, 0, 1);
 
 	REGISTER_LUA_CFUNC(SetShockFrontFactors);
+	LuaUIWorker::PushEntries(L);
 
 	lua_setglobal(L, "Spring");
 	return true;
@@ -290,6 +295,39 @@ bool CLuaUI::ConfigureLayout(const string& command)
 }
 
 
+/***
+ * Called once per message a worker sent with Worker.SendToMain, see Spring.StartWorker.
+ *
+ * @function RecvFromWorker
+ * @string workerName
+ * @param ... the values passed to Worker.SendToMain
+ */
+void CLuaUI::RecvFromWorkers()
+{
+	if (!LuaUIWorker::HaveWorkers())
+		return;
+
+	LuaUIWorker::PublishSnapshot();
+
+	LUA_CALL_IN_CHECK(L);
+	static const LuaHashString cmdStr("RecvFromWorker");
+
+	LuaUIWorker::Message msg;
+
+	while (LuaUIWorker::PopMessage(msg)) {
+		luaL_checkstack(L, 3, __func__);
+
+		// dropped if nobody listens
+		if (!cmdStr.GetGlobalFunc(L))
+			continue;
+
+		lua_pushsstring(L, msg.workerName);
+
+		RunCallIn(L, cmdStr, 1 + LuaUIWorker::PushMessage(L, msg), 0);
+	}
+}
+
+
 
 static inline float fuzzRand(float fuzz)
 {
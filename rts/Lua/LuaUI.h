@@ -71,6 +71,7 @@ public: // call-ins
 	                   string& menuName);
 
 	bool ConfigureLayout(const string& command);
+	void RecvFromWorkers();
 
 	void ShockFront(const float3& pos, float power, float areaOfEffect, const float* distMod = NULL);
 
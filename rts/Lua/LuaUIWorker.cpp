@@ -0,0 +1,697 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+
+/******************************************************************************
+ * LuaUI workers
+ * @module LuaUIWorker
+ *
+ * @see rts/Lua/LuaUIWorker.cpp
+******************************************************************************/
+
+
+/**
+ * @class Worker
+ *
+ * @brief Global table of a LuaUI worker environment
+ *
+ * A worker runs its file once when started, then waits on its thread and
+ * calls its global functions
+ *  - RecvFromMain(...)      : for every message LuaUI sent with Spring.SendToWorker
+ *  - Update(frameNum)       : once per new game-state snapshot
+ * and can use
+ *  - Worker.SendToMain(...) : queues RecvFromWorker(workerName, ...) in LuaUI,
+ *                             false if too many messages are pending
+ *  - Worker.GetSnapshot()   : latest snapshot table, nil before the first one
+ *  - Worker.GetName()       : the name the worker was started with
+ *  - Spring.Echo, Spring.Log and LOG
+ *
+ * Messages may only contain nil, booleans, numbers, strings and tables of
+ * these. The snapshot table is shared between calls until a newer snapshot
+ * arrives and should be treated as read-only; it contains
+ *  - frameNum, gameSeconds, myPlayerID, myTeamID, myAllyTeamID, spectating
+ *  - metal, energy     : {current, storage, income, expense} of myTeamID
+ *  - units             : array of {id, defID, team, x, y, z, health, maxHealth}
+ *                        for every allied or in-LOS unit (all if spectating
+ *                        with full view)
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <utility>
+
+#include "LuaUIWorker.h"
+#include "LuaContextData.h"
+#include "LuaInclude.h"
+#include "LuaHashString.h"
+#include "LuaUtils.h"
+#include "LuaVFS.h"
+#include "Game/GlobalUnsynced.h"
+#include "Sim/Misc/GlobalConstants.h"
+#include "Sim/Misc/GlobalSynced.h"
+#include "Sim/Misc/TeamHandler.h"
+#include "Sim/Units/Unit.h"
+#include "Sim/Units/UnitDef.h"
+#include "Sim/Units/UnitHandler.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/FileSystem/FileHandler.h"
+#include "System/Log/ILog.h"
+#include "System/Platform/Threading.h"
+#include "System/Threading/SpringThreading.h"
+
+#include "System/Misc/TracyDefs.h"
+
+CONFIG(int, MaxLuaUIWorkers).defaultValue(4).minimumValue(0).description("Maximum number of worker threads LuaUI can run at once with Spring.StartWorker, 0 disables workers.");
+
+// per queue; senders get false back beyond this
+static constexpr size_t MAX_QUEUED_MESSAGES = 4096;
+// instructions between checks whether a busy worker was stopped
+static constexpr int STOP_HOOK_INTERVAL = 1 << 16;
+
+
+struct WorkerSnapshot {
+	struct Unit {
+		int id;
+		int defID;
+		int team;
+		float3 pos;
+		float health;
+		float maxHealth;
+	};
+
+	int frameNum;
+	float gameSeconds;
+
+	int myPlayerID;
+	int myTeamID;
+	int myAllyTeamID;
+	bool spectating;
+
+	// current, storage, income, expense
+	float metal[4];
+	float energy[4];
+
+	std::vector<Unit> units;
+};
+
+
+class LuaWorker {
+public:
+	LuaWorker(const std::string& _name, const std::string& _file, std::string&& _code)
+	: name(_name)
+	, file(_file)
+	, code(std::move(_code))
+	, D(false, false)
+	{
+		thread = spring::thread(&LuaWorker::Run, this);
+	}
+
+	~LuaWorker() {
+		{
+			std::lock_guard<spring::mutex> lock(mutex);
+			stopped = true;
+		}
+
+		// also interrupts a call-in that never returns, see StopHook
+		cond.notify_one();
+		thread.join();
+	}
+
+	const std::string& GetName() const { return name; }
+	bool IsDead() const { return dead.load(); }
+
+	bool PushMessage(std::vector<std::uint8_t>&& data) {
+		{
+			std::lock_guard<spring::mutex> lock(mutex);
+
+			if (inbox.size() >= MAX_QUEUED_MESSAGES)
+				return false;
+
+			inbox.emplace_back(std::move(data));
+		}
+
+		cond.notify_one();
+		return true;
+	}
+
+	void NotifySnapshot() {
+		{
+			std::lock_guard<spring::mutex> lock(mutex);
+			snapshotPending = true;
+		}
+
+		cond.notify_one();
+	}
+
+private:
+	void Run();
+	bool Init();
+	void Kill();
+
+	void CallIn(const char* funcName, const std::vector<std::uint8_t>* data);
+	void PushSnapshot();
+
+	void PushWorkerFunc(const char* funcName, lua_CFunction func) {
+		lua_pushstring(L, funcName);
+		lua_pushlightuserdata(L, this);
+		lua_pushcclosure(L, func, 1);
+		lua_rawset(L, -3);
+	}
+
+	static LuaWorker* GetWorker(lua_State* L) { return (static_cast<LuaWorker*>(lua_touserdata(L, lua_upvalueindex(1)))); }
+
+	static void StopHook(lua_State* L, lua_Debug* ar);
+
+	static int SendToMain(lua_State* L);
+	static int GetSnapshot(lua_State* L);
+	static int GetWorkerName(lua_State* L);
+
+private:
+	std::string name;
+	std::string file;
+	std::string code;
+
+	luaContextData D;
+	lua_State* L = nullptr;
+
+	spring::thread thread;
+	spring::mutex mutex;
+	spring::condition_variable cond;
+
+	std::deque< std::vector<std::uint8_t> > inbox;
+
+	// last snapshot pushed into L and its registry reference
+	std::shared_ptr<const WorkerSnapshot> snapshot;
+	int snapshotRef = LUA_NOREF;
+
+	bool snapshotPending = false;
+
+	std::atomic<bool> stopped = {false};
+	std::atomic<bool> dead = {false};
+
+	static thread_local LuaWorker* currentWorker;
+};
+
+thread_local LuaWorker* LuaWorker::currentWorker = nullptr;
+
+
+// all accessed from the main thread only
+static std::vector< std::unique_ptr<LuaWorker> > workers;
+static int snapshotFrame = -1;
+
+static spring::mutex snapshotMutex;
+static std::shared_ptr<const WorkerSnapshot> latestSnapshot;
+
+static spring::mutex outboxMutex;
+static std::deque<LuaUIWorker::Message> outbox;
+
+
+static LuaWorker* FindWorker(const std::string& name)
+{
+	const auto pred = [&](const std::unique_ptr<LuaWorker>& w) { return (w->GetName() == name); };
+	const auto iter = std::find_if(workers.begin(), workers.end(), pred);
+
+	if (iter == workers.end())
+		return nullptr;
+
+	return (iter->get());
+}
+
+static bool DumpArgs(lua_State* L, int firstArg, std::vector<std::uint8_t>& data)
+{
+	for (int i = firstArg, top = lua_gettop(L); i <= top; i++) {
+		if (!LuaUtils::DumpValue(L, i, data))
+			return false;
+	}
+
+	return true;
+}
+
+static int RestoreArgs(lua_State* L, const std::vector<std::uint8_t>& data)
+{
+	const std::uint8_t* pos = data.data();
+	const std::uint8_t* end = data.data() + data.size();
+
+	int count = 0;
+
+	// data was produced by DumpArgs, a failure here is a bug
+	while (pos < end && lua_checkstack(L, 1) && LuaUtils::RestoreValue(L, pos, end)) {
+		count += 1;
+	}
+
+	assert(pos == end);
+	return count;
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+void LuaWorker::Run()
+{
+	Threading::SetThreadName("luaui-worker");
+
+	currentWorker = this;
+
+	if (!Init()) {
+		Kill();
+		return;
+	}
+
+	std::deque< std::vector<std::uint8_t> > messages;
+
+	while (true) {
+		bool newSnapshot = false;
+
+		{
+			std::unique_lock<spring::mutex> lock(mutex);
+			cond.wait(lock, [&]() { return (stopped || snapshotPending || !inbox.empty()); });
+
+			if (stopped)
+				break;
+
+			messages.swap(inbox);
+			newSnapshot = std::exchange(snapshotPending, false);
+		}
+
+		for (const std::vector<std::uint8_t>& data: messages) {
+			CallIn("RecvFromMain", &data);
+		}
+
+		messages.clear();
+
+		if (newSnapshot)
+			CallIn("Update", nullptr);
+	}
+
+	Kill();
+}
+
+
+bool LuaWorker::Init()
+{
+	D.synced = false;
+
+	if ((L = LUA_OPEN(&D)) == nullptr)
+		return false;
+
+	LUA_OPEN_LIB(L, luaopen_base);
+	LUA_OPEN_LIB(L, luaopen_math);
+	LUA_OPEN_LIB(L, luaopen_table);
+	LUA_OPEN_LIB(L, luaopen_string);
+
+	// no file access, workers only see what LuaUI sends them
+	lua_pushnil(L); lua_setglobal(L, "dofile");
+	lua_pushnil(L); lua_setglobal(L, "loadfile");
+	lua_pushnil(L); lua_setglobal(L, "loadlib");
+	lua_pushnil(L); lua_setglobal(L, "require");
+
+	lua_newtable(L);
+	HSTR_PUSH_CFUNC(L, "Echo", LuaUtils::Echo);
+	HSTR_PUSH_CFUNC(L, "Log",  LuaUtils::Log);
+	lua_setglobal(L, "Spring");
+
+	lua_newtable(L);
+	LuaUtils::PushLogEntries(L);
+	lua_setglobal(L, "LOG");
+
+	lua_newtable(L);
+	PushWorkerFunc("SendToMain",  SendToMain);
+	PushWorkerFunc("GetSnapshot", GetSnapshot);
+	PushWorkerFunc("GetName",     GetWorkerName);
+	lua_setglobal(L, "Worker");
+
+	lua_sethook(L, StopHook, LUA_MASKCOUNT, STOP_HOOK_INTERVAL);
+
+	if (luaL_loadbuffer(L, code.data(), code.size(), file.c_str()) != 0 || lua_pcall(L, 0, 0, 0) != 0) {
+		LOG_L(L_ERROR, "[LuaUIWorker::%s] worker \"%s\" failed to load: %s", __func__, name.c_str(), lua_tostring(L, -1));
+		return false;
+	}
+
+	code.clear();
+	code.shrink_to_fit();
+
+	lua_settop(L, 0);
+	return true;
+}
+
+
+void LuaWorker::Kill()
+{
+	dead = true;
+
+	if (L == nullptr)
+		return;
+
+	snapshot.reset();
+	snapshotRef = LUA_NOREF;
+
+	LUA_CLOSE(&L);
+}
+
+
+void LuaWorker::CallIn(const char* funcName, const std::vector<std::uint8_t>* data)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	if (stopped.load())
+		return;
+
+	lua_settop(L, 0);
+	lua_getglobal(L, funcName);
+
+	if (!lua_isfunction(L, -1)) {
+		lua_settop(L, 0);
+		return;
+	}
+
+	int numArgs = 0;
+
+	if (data != nullptr) {
+		numArgs = RestoreArgs(L, *data);
+	} else {
+		// Update
+		std::lock_guard<spring::mutex> lock(snapshotMutex);
+		lua_pushnumber(L, (latestSnapshot != nullptr)? latestSnapshot->frameNum: -1);
+		numArgs = 1;
+	}
+
+	if (lua_pcall(L, numArgs, 0, 0) != 0 && !stopped.load())
+		LOG_L(L_ERROR, "[LuaUIWorker::%s] worker \"%s\" error in %s: %s", __func__, name.c_str(), funcName, lua_tostring(L, -1));
+
+	lua_settop(L, 0);
+}
+
+
+void LuaWorker::PushSnapshot()
+{
+	std::shared_ptr<const WorkerSnapshot> s;
+
+	{
+		std::lock_guard<spring::mutex> lock(snapshotMutex);
+		s = latestSnapshot;
+	}
+
+	if (s == nullptr) {
+		lua_pushnil(L);
+		return;
+	}
+
+	if (s == snapshot && snapshotRef != LUA_NOREF) {
+		lua_rawgeti(L, LUA_REGISTRYINDEX, snapshotRef);
+		return;
+	}
+
+	luaL_checkstack(L, 4, __func__);
+	lua_createtable(L, 0, 9);
+
+	LuaPushNamedNumber(L, "frameNum",     s->frameNum);
+	LuaPushNamedNumber(L, "gameSeconds",  s->gameSeconds);
+	LuaPushNamedNumber(L, "myPlayerID",   s->myPlayerID);
+	LuaPushNamedNumber(L, "myTeamID",     s->myTeamID);
+	LuaPushNamedNumber(L, "myAllyTeamID", s->myAllyTeamID);
+	LuaPushNamedBool(L,   "spectating",   s->spectating);
+
+	for (const auto& res: {std::make_pair("metal", s->metal), std::make_pair("energy", s->energy)}) {
+		lua_pushstring(L, res.first);
+		lua_createtable(L, 4, 0);
+
+		for (int i = 0; i < 4; i++) {
+			lua_pushnumber(L, res.second[i]);
+			lua_rawseti(L, -2, i + 1);
+		}
+
+		lua_rawset(L, -3);
+	}
+
+	lua_pushliteral(L, "units");
+	lua_createtable(L, s->units.size(), 0);
+
+	for (size_t i = 0; i < s->units.size(); i++) {
+		const WorkerSnapshot::Unit& u = s->units[i];
+
+		lua_createtable(L, 0, 8);
+		LuaPushNamedNumber(L, "id",        u.id);
+		LuaPushNamedNumber(L, "defID",     u.defID);
+		LuaPushNamedNumber(L, "team",      u.team);
+		LuaPushNamedNumber(L, "x",         u.pos.x);
+		LuaPushNamedNumber(L, "y",         u.pos.y);
+		LuaPushNamedNumber(L, "z",         u.pos.z);
+		LuaPushNamedNumber(L, "health",    u.health);
+		LuaPushNamedNumber(L, "maxHealth", u.maxHealth);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	lua_rawset(L, -3);
+
+	luaL_unref(L, LUA_REGISTRYINDEX, snapshotRef);
+	lua_pushvalue(L, -1);
+
+	snapshot = std::move(s);
+	snapshotRef = luaL_ref(L, LUA_REGISTRYINDEX);
+}
+
+
+void LuaWorker::StopHook(lua_State* L, lua_Debug* ar)
+{
+	if (!currentWorker->stopped.load())
+		return;
+
+	// unwinds to the pcall of the running call-in, Run then sees the flag
+	luaL_error(L, "worker stopped");
+}
+
+
+int LuaWorker::SendToMain(lua_State* L)
+{
+	LuaWorker* worker = GetWorker(L);
+	LuaUIWorker::Message msg = {worker->name, {}};
+
+	if (!DumpArgs(L, 1, msg.data))
+		luaL_error(L, "[Worker.%s] arguments may only contain nil, booleans, numbers, strings and tables of these", __func__);
+
+	std::lock_guard<spring::mutex> lock(outboxMutex);
+
+	if (outbox.size() >= MAX_QUEUED_MESSAGES) {
+		lua_pushboolean(L, false);
+		return 1;
+	}
+
+	outbox.emplace_back(std::move(msg));
+	lua_pushboolean(L, true);
+	return 1;
+}
+
+int LuaWorker::GetSnapshot(lua_State* L)
+{
+	GetWorker(L)->PushSnapshot();
+	return 1;
+}
+
+int LuaWorker::GetWorkerName(lua_State* L)
+{
+	lua_pushsstring(L, GetWorker(L)->name);
+	return 1;
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+bool LuaUIWorker::PushEntries(lua_State* L)
+{
+	REGISTER_LUA_CFUNC(StartWorker);
+	REGISTER_LUA_CFUNC(SendToWorker);
+	REGISTER_LUA_CFUNC(StopWorker);
+	return true;
+}
+
+
+bool LuaUIWorker::HaveWorkers() { return (!workers.empty()); }
+
+void LuaUIWorker::KillWorkers()
+{
+	// joins every worker thread
+	workers.clear();
+	snapshotFrame = -1;
+
+	{
+		std::lock_guard<spring::mutex> lock(snapshotMutex);
+		latestSnapshot.reset();
+	}
+	{
+		std::lock_guard<spring::mutex> lock(outboxMutex);
+		outbox.clear();
+	}
+}
+
+
+void LuaUIWorker::PublishSnapshot()
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	if (workers.empty() || gs->frameNum == snapshotFrame)
+		return;
+
+	std::shared_ptr<WorkerSnapshot> s = std::make_shared<WorkerSnapshot>();
+
+	s->frameNum = gs->frameNum;
+	s->gameSeconds = gs->frameNum * INV_GAME_SPEED;
+
+	s->myPlayerID = gu->myPlayerNum;
+	s->myTeamID = gu->myTeam;
+	s->myAllyTeamID = gu->myAllyTeam;
+	s->spectating = gu->spectating;
+
+	const CTeam* team = teamHandler.Team(gu->myTeam);
+
+	for (int i = 0; i < SResourcePack::MAX_RESOURCES; i++) {
+		float* res = (i == 0)? s->metal: s->energy;
+
+		res[0] = team->res[i];
+		res[1] = team->resStorage[i];
+		res[2] = team->resPrevIncome[i];
+		res[3] = team->resPrevExpense[i];
+	}
+
+	const std::vector<CUnit*>& activeUnits = unitHandler.GetActiveUnits();
+
+	s->units.reserve(activeUnits.size());
+
+	for (const CUnit* unit: activeUnits) {
+		if (!gu->spectatingFullView && unit->allyteam != gu->myAllyTeam && !unit->IsInLosForAllyTeam(gu->myAllyTeam))
+			continue;
+
+		s->units.push_back({unit->id, unit->unitDef->id, unit->team, unit->pos, unit->health, unit->maxHealth});
+	}
+
+	{
+		std::lock_guard<spring::mutex> lock(snapshotMutex);
+		latestSnapshot = std::move(s);
+	}
+
+	snapshotFrame = gs->frameNum;
+
+	for (const auto& worker: workers) {
+		worker->NotifySnapshot();
+	}
+}
+
+
+bool LuaUIWorker::PopMessage(Message& msg)
+{
+	std::lock_guard<spring::mutex> lock(outboxMutex);
+
+	if (outbox.empty())
+		return false;
+
+	msg = std::move(outbox.front());
+	outbox.pop_front();
+	return true;
+}
+
+int LuaUIWorker::PushMessage(lua_State* L, const Message& msg)
+{
+	return (RestoreArgs(L, msg.data));
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+/***
+ * Starts a worker thread running a file in its own Lua environment
+ *
+ * @function Spring.StartWorker
+ * @string name unique among running workers
+ * @string fileName
+ * @string[opt] mode VFS modes to load the file with
+ * @treturn bool started false if the name is taken, the file is missing or too many workers run
+ */
+int LuaUIWorker::StartWorker(lua_State* L)
+{
+	const std::string name = luaL_checkstring(L, 1);
+	const std::string file = luaL_checkstring(L, 2);
+
+	if (FindWorker(name) != nullptr) {
+		lua_pushboolean(L, false);
+		return 1;
+	}
+
+	if (workers.size() >= static_cast<size_t>(configHandler->GetInt("MaxLuaUIWorkers"))) {
+		LOG_L(L_WARNING, "[LuaUIWorker::%s] cannot start \"%s\", MaxLuaUIWorkers reached", __func__, name.c_str());
+		lua_pushboolean(L, false);
+		return 1;
+	}
+
+	// the VFS is not thread-safe, read the file here
+	CFileHandler f(file, LuaVFS::GetModes(L, 3, false));
+
+	std::string code;
+
+	if (!f.LoadStringData(code)) {
+		lua_pushboolean(L, false);
+		return 1;
+	}
+
+	workers.emplace_back(new LuaWorker(name, file, std::move(code)));
+
+	// let the new worker see the game right away
+	snapshotFrame = -1;
+	PublishSnapshot();
+
+	lua_pushboolean(L, true);
+	return 1;
+}
+
+
+/***
+ * Queues RecvFromMain(...) in a worker
+ *
+ * @function Spring.SendToWorker
+ * @string name
+ * @param ... nil, booleans, numbers, strings and tables of these
+ * @treturn bool queued false if the worker does not exist, has died or has too many pending messages
+ */
+int LuaUIWorker::SendToWorker(lua_State* L)
+{
+	LuaWorker* worker = FindWorker(luaL_checkstring(L, 1));
+
+	if (worker == nullptr || worker->IsDead()) {
+		lua_pushboolean(L, false);
+		return 1;
+	}
+
+	std::vector<std::uint8_t> data;
+
+	if (!DumpArgs(L, 2, data))
+		luaL_error(L, "[%s] arguments may only contain nil, booleans, numbers, strings and tables of these", __func__);
+
+	lua_pushboolean(L, worker->PushMessage(std::move(data)));
+	return 1;
+}
+
+
+/***
+ * Stops a worker and waits for its thread to finish
+ *
+ * @function Spring.StopWorker
+ * @string name
+ * @treturn bool stopped false if the worker does not exist
+ */
+int LuaUIWorker::StopWorker(lua_State* L)
+{
+	const std::string name = luaL_checkstring(L, 1);
+
+	const auto pred = [&](const std::unique_ptr<LuaWorker>& w) { return (w->GetName() == name); };
+	const auto iter = std::find_if(workers.begin(), workers.end(), pred);
+
+	if (iter == workers.end()) {
+		lua_pushboolean(L, false);
+		return 1;
+	}
+
+	workers.erase(iter);
+
+	lua_pushboolean(L, true);
+	return 1;
+}
@@ -0,0 +1,49 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef LUA_UI_WORKER_H
+#define LUA_UI_WORKER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct lua_State;
+
+
+/**
+ * Lua environments that LuaUI can start on threads of their own, for widget
+ * logic that does not need to run inside the draw and update call-ins. A
+ * worker gets a separate lua_State with the base, math, table and string
+ * libraries and a Worker table instead of the engine API; it talks to LuaUI
+ * only through copied messages and sees the game through a read-only
+ * snapshot that the main thread publishes once per simulation frame.
+ */
+class LuaUIWorker {
+public:
+	struct Message {
+		std::string workerName;
+		std::vector<std::uint8_t> data;
+	};
+
+public:
+	/// adds Spring.StartWorker, SendToWorker and StopWorker
+	static bool PushEntries(lua_State* L);
+
+	static bool HaveWorkers();
+	static void KillWorkers();
+
+	/// called by LuaUI on the main thread before it processes worker messages
+	static void PublishSnapshot();
+
+	/// pops the next message sent by any worker, in order of sending
+	static bool PopMessage(Message& msg);
+	/// pushes the values of a popped message onto L, returns their count
+	static int PushMessage(lua_State* L, const Message& msg);
+
+private: // call-outs
+	static int StartWorker(lua_State* L);
+	static int SendToWorker(lua_State* L);
+	static int StopWorker(lua_State* L);
+};
+
+#endif /* LUA_UI_WORKER_H */
@@ -175,6 +175,174 @@ int LuaUtils::CopyData(lua_State* dst, lua_State* src, int count)
 	return count;
 }
 
+/******************************************************************************/
+/******************************************************************************/
+
+enum {
+	DUMP_TYPE_FALSE  = 0,
+	DUMP_TYPE_TRUE   = 1,
+	DUMP_TYPE_NUMBER = 2,
+	DUMP_TYPE_STRING = 3,
+	DUMP_TYPE_TABLE  = 4,
+	DUMP_TYPE_NIL    = 5,
+};
+
+static constexpr int MAX_DUMP_DEPTH = 64;
+
+
+static void DumpBytes(std::vector<std::uint8_t>& data, const void* bytes, size_t size)
+{
+	data.insert(data.end(), static_cast<const std::uint8_t*>(bytes), static_cast<const std::uint8_t*>(bytes) + size);
+}
+
+bool LuaUtils::DumpValue(lua_State* L, int index, std::vector<std::uint8_t>& data, int depth)
+{
+	switch (lua_type(L, index)) {
+		case LUA_TNIL: {
+			data.push_back(DUMP_TYPE_NIL);
+			return true;
+		} break;
+		case LUA_TBOOLEAN: {
+			data.push_back(lua_toboolean(L, index)? DUMP_TYPE_TRUE: DUMP_TYPE_FALSE);
+			return true;
+		} break;
+		case LUA_TNUMBER: {
+			const lua_Number value = lua_tonumber(L, index);
+
+			data.push_back(DUMP_TYPE_NUMBER);
+			DumpBytes(data, &value, sizeof(value));
+			return true;
+		} break;
+		case LUA_TSTRING: {
+			size_t len = 0;
+			const char* str = lua_tolstring(L, index, &len);
+			const std::uint32_t size = len;
+
+			data.push_back(DUMP_TYPE_STRING);
+			DumpBytes(data, &size, sizeof(size));
+			DumpBytes(data, str, len);
+			return true;
+		} break;
+		case LUA_TTABLE: {
+			// also catches tables that contain themselves
+			if (depth >= MAX_DUMP_DEPTH || !lua_checkstack(L, 3))
+				return false;
+
+			const int table = (index > 0)? index: (lua_gettop(L) + index + 1);
+
+			if (lua_getmetatable(L, table) != 0) {
+				lua_pop(L, 1);
+				return false;
+			}
+
+			data.push_back(DUMP_TYPE_TABLE);
+
+			const size_t countPos = data.size();
+			std::uint32_t count = 0;
+
+			DumpBytes(data, &count, sizeof(count));
+
+			for (lua_pushnil(L); lua_next(L, table) != 0; lua_pop(L, 1)) {
+				if (!DumpValue(L, -2, data, depth + 1) || !DumpValue(L, -1, data, depth + 1)) {
+					lua_pop(L, 2);
+					return false;
+				}
+
+				count += 1;
+			}
+
+			std::memcpy(&data[countPos], &count, sizeof(count));
+			return true;
+		} break;
+		default: {
+		} break;
+	}
+
+	// functions, userdata, threads
+	return false;
+}
+
+bool LuaUtils::RestoreValue(lua_State* L, const std::uint8_t*& pos, const std::uint8_t* end, int depth)
+{
+	if (pos >= end)
+		return false;
+
+	switch (*(pos++)) {
+		case DUMP_TYPE_NIL: {
+			lua_pushnil(L);
+			return true;
+		} break;
+		case DUMP_TYPE_FALSE:
+		case DUMP_TYPE_TRUE: {
+			lua_pushboolean(L, pos[-1] == DUMP_TYPE_TRUE);
+			return true;
+		} break;
+		case DUMP_TYPE_NUMBER: {
+			lua_Number value;
+
+			if ((end - pos) < static_cast<ptrdiff_t>(sizeof(value)))
+				return false;
+
+			std::memcpy(&value, pos, sizeof(value));
+			lua_pushnumber(L, value);
+
+			pos += sizeof(value);
+			return true;
+		} break;
+		case DUMP_TYPE_STRING: {
+			std::uint32_t size;
+
+			if ((end - pos) < static_cast<ptrdiff_t>(sizeof(size)))
+				return false;
+
+			std::memcpy(&size, pos, sizeof(size));
+
+			if ((end - (pos += sizeof(size))) < static_cast<ptrdiff_t>(size))
+				return false;
+
+			lua_pushlstring(L, reinterpret_cast<const char*>(pos), size);
+
+			pos += size;
+			return true;
+		} break;
+		case DUMP_TYPE_TABLE: {
+			std::uint32_t count;
+
+			if (depth >= MAX_DUMP_DEPTH || !lua_checkstack(L, 3))
+				return false;
+			if ((end - pos) < static_cast<ptrdiff_t>(sizeof(count)))
+				return false;
+
+			std::memcpy(&count, pos, sizeof(count));
+
+			// every pair takes at least two bytes
+			if (((end - (pos += sizeof(count))) / 2) < static_cast<ptrdiff_t>(count))
+				return false;
+
+			lua_createtable(L, 0, count);
+
+			for (std::uint32_t i = 0; i < count; i++) {
+				if (!RestoreValue(L, pos, end, depth + 1))
+					return false;
+				// nil and NaN keys would raise an error outside of any pcall
+				if (lua_isnil(L, -1) || (lua_type(L, -1) == LUA_TNUMBER && math::isnan(lua_tonumber(L, -1))))
+					return false;
+				if (!RestoreValue(L, pos, end, depth + 1))
+					return false;
+
+				lua_rawset(L, -3);
+			}
+
+			return true;
+		} break;
+		default: {
+		} break;
+	}
+
+	return false;
+}
+
+
 /******************************************************************************/
 /******************************************************************************/
 
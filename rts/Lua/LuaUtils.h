@@ -3,7 +3,9 @@
 #ifndef LUA_UTILS_H
 #define LUA_UTILS_H
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "lib/fmt/printf.h"
 
@@ -107,6 +109,12 @@ class LuaUtils {
 		// Copies lua data between 2 lua_States
 		static int CopyData(lua_State* dst, lua_State* src, int count);
 
+		// Serializes plain data (nil, booleans, numbers, strings and tables
+		// of these without metatables) to bytes and back, for moving values
+		// between lua_States that may not be touched at the same time
+		static bool DumpValue(lua_State* L, int index, std::vector<std::uint8_t>& data, int depth = 0);
+		static bool RestoreValue(lua_State* L, const std::uint8_t*& pos, const std::uint8_t* end, int depth = 0);
+
 		// returns stack index of traceback function
 		static int PushDebugTraceback(lua_State* L);
 
@@ -26,6 +26,7 @@
 #include "System/XSimdOps.hpp"
 #include "Game/GlobalUnsynced.h"
 #include "Sim/Misc/LosHandler.h"
+#include "Sim/Misc/SimStageGraph.h"
 
 #include "System/Misc/TracyDefs.h"
 
@@ -523,6 +524,8 @@ void CReadMap::UpdateDraw(bool firstCall)
 void CReadMap::UpdateHeightMapSynced(const SRectangle& hgtMapRect)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
+	SIM_STAGE_ACCESS(0, SIM_RES_HEIGHTMAP);
+
 	const bool initialize = (hgtMapRect == SRectangle{ 0, 0, mapDims.mapx, mapDims.mapy });
 
 	const int2 mins = {hgtMapRect.x1 - 1, hgtMapRect.z1 - 1};
@@ -570,6 +573,8 @@ void CReadMap::UpdateHeightMapSynced(const SRectangle& hgtMapRect)
 void CReadMap::UpdateHeightBounds(int syncFrame)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
+	SIM_STAGE_ACCESS(SIM_RES_HEIGHTMAP, SIM_RES_HEIGHTBOUNDS);
+
 	constexpr int PACING_PERIOD = GAME_SPEED; //tune if needed
 	int dataChunk = syncFrame % PACING_PERIOD;
 
@@ -6,7 +6,9 @@
 #include "System/Log/ILog.h"
 #include "System/Net/Socket.h"
 
+#include <algorithm>
 #include <cstring>
+#include <limits>
 #include <vector>
 #include <cinttypes>
 
@@ -77,6 +79,18 @@ enum EVENT
 	 */
 	SERVER_WARNING = 5,
 
+	/**
+	 * Periodic server metrics, if AutohostTelemetryInterval is non-zero
+	 *
+	 *   (uint16 msgsize, ServerTelemetry server, uint8 numclients, ClientTelemetry[numclients] clients)
+	 *
+	 * ServerTelemetry and ClientTelemetry are packed structs in host byte
+	 * order, defined in rts/Net/AutohostInterface.h; a receiver should read
+	 * server.structSize and server.clientStructSize rather than assume their
+	 * sizes, so fields can be appended later.
+	 */
+	SERVER_TELEMETRY = 6,
+
 	/**
 	 * Player has joined the game
 	 *
@@ -137,6 +151,20 @@ enum EVENT
 	 */
 	PLAYER_DEFEATED = 14,
 
+	/**
+	 * Player has reported its profiling summary, sent every few seconds
+	 * while ingame and forwarded only if AutohostTelemetryInterval is
+	 * non-zero
+	 *
+	 *   (uint8 magic = 79, uint16 msgsize, uint8 playernumber, { float percentage, float peakMillis, char[] name, '\0' }...)
+	 *
+	 * The message data is a straight copy of the NETMSG_PROFILE_SUMMARY packet
+	 * including the magic 79 byte, see CBaseNetProtocol::SendProfileSummary.
+	 * Percentage is the share of wall-time the client spent in the named
+	 * profiler timer, peakMillis its recent longest single run.
+	 */
+	PLAYER_PROFILE = 15,
+
 	/**
 	 * Message sent by Lua script
 	 *
@@ -339,6 +367,52 @@ void AutohostInterface::SendPlayerDefeated(uchar playerNum)
 	Send(asio::buffer(&msg, 2 * sizeof(uchar)));
 }
 
+void AutohostInterface::SendPlayerProfile(const std::uint8_t* msg, size_t msgSize)
+{
+	if (autohost.is_open()) {
+		std::vector<std::uint8_t> buffer(msgSize + 1);
+		buffer[0] = PLAYER_PROFILE;
+		std::copy(msg, msg + msgSize, buffer.begin() + 1);
+
+		Send(asio::buffer(buffer));
+	}
+}
+
+void AutohostInterface::SendTelemetry(ServerTelemetry server, const std::vector<ClientTelemetry>& clients)
+{
+	if (!autohost.is_open())
+		return;
+
+	const size_t numClients = std::min(clients.size(), size_t(std::numeric_limits<uchar>::max()));
+	const std::uint16_t msgsize =
+			1                                            // SERVER_TELEMETRY
+			+ sizeof(std::uint16_t)                      // msgsize
+			+ sizeof(ServerTelemetry)
+			+ 1                                          // numclients
+			+ numClients * sizeof(ClientTelemetry);
+
+	server.structSize = sizeof(ServerTelemetry);
+	server.clientStructSize = sizeof(ClientTelemetry);
+
+	std::vector<std::uint8_t> buffer(msgsize);
+	unsigned int pos = 0;
+
+	buffer[pos++] = SERVER_TELEMETRY;
+
+	memcpy(&buffer[pos], &msgsize, sizeof(msgsize));
+	pos += sizeof(msgsize);
+
+	memcpy(&buffer[pos], &server, sizeof(server));
+	pos += sizeof(server);
+
+	buffer[pos++] = numClients;
+
+	if (numClients > 0)
+		memcpy(&buffer[pos], clients.data(), numClients * sizeof(ClientTelemetry));
+
+	Send(asio::buffer(buffer));
+}
+
 void AutohostInterface::Message(const std::string& message)
 {
 	if (autohost.is_open()) {
@@ -4,6 +4,7 @@
 #define AUTOHOST_INTERFACE_H
 
 #include <string>
+#include <vector>
 #include <cinttypes>
 #include <asio/ip/udp.hpp>
 
@@ -16,6 +17,70 @@ class AutohostInterface
 public:
 	typedef unsigned char uchar;
 
+#pragma pack(push, 1)
+	/// server part of SERVER_TELEMETRY, values cover the time since the previous report
+	struct ServerTelemetry {
+		/// set by SendTelemetry
+		std::uint16_t structSize = 0;
+		std::uint16_t clientStructSize = 0;
+
+		std::uint32_t intervalMillis = 0;
+		std::int32_t  frameNum = 0;
+		/// frames sent to clients during the interval
+		std::uint32_t framesSent = 0;
+
+		float userSpeed = 0.0f;
+		float internalSpeed = 0.0f;
+		float medianCpu = 0.0f;
+		std::int32_t medianPing = 0;
+
+		std::uint32_t packetCachePackets = 0;
+		std::uint64_t packetCacheRawBytes = 0;
+		std::uint64_t packetCacheMemBytes = 0;
+
+		/// demo stream size so far, 0 if not recording
+		std::uint64_t demoBytes = 0;
+
+		/// delays between a frame being sent and clients' sync-responses for it arriving
+		std::uint32_t syncResponses = 0;
+		std::uint32_t syncResponseMeanMicros = 0;
+		std::uint32_t syncResponseP95Micros = 0;
+		std::uint32_t syncResponseMaxMicros = 0;
+
+		std::uint8_t isPaused = 0;
+		std::uint8_t gameHasStarted = 0;
+	};
+
+	/// per-connection part of SERVER_TELEMETRY
+	struct ClientTelemetry {
+		enum {
+			FLAG_SPECTATOR   = 1,
+			FLAG_LOCAL       = 2,
+			/// receiving missed packets from the server's cache
+			FLAG_CATCHING_UP = 4,
+			FLAG_DESYNCED    = 8,
+		};
+
+		std::uint8_t playerNum = 0;
+		/// GameParticipant::State
+		std::uint8_t state = 0;
+		std::uint8_t flags = 0;
+
+		float cpuUsage = 0.0f;
+		std::int32_t pingMillis = 0;
+		/// frames between the server and the client's last response
+		std::int32_t lagFrames = 0;
+
+		/// received messages not yet processed by the server
+		std::uint16_t incomingQueue = 0;
+		/// messages and chunks not yet sent to or acknowledged by the client
+		std::uint16_t outgoingQueue = 0;
+
+		std::uint32_t bytesSent = 0;
+		std::uint32_t bytesReceived = 0;
+	};
+#pragma pack(pop)
+
 	/**
 	 * @brief Connects to a port on localhost
 	 * @param remoteIP IP of the autohost to connect to
@@ -47,6 +112,8 @@ public:
 	void Warning(const std::string& message);
 
 	void SendLuaMsg(const std::uint8_t* msg, size_t msgSize);
+	void SendPlayerProfile(const std::uint8_t* msg, size_t msgSize);
+	void SendTelemetry(ServerTelemetry server, const std::vector<ClientTelemetry>& clients);
 	void Send(const std::uint8_t* msg, size_t msgSize);
 
 	/**
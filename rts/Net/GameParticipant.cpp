@@ -32,6 +32,7 @@ void GameParticipant::Connected(std::shared_ptr<netcode::CConnection> _link, boo
 
 	clientLink = _link;
 	aiClientLinks[MAX_AIS].link.reset(new netcode::CLoopbackConnection());
+	cacheCursor.Stop();
 
 	isLocal = local;
 	myState = CONNECTED;
@@ -60,6 +61,7 @@ void GameParticipant::Kill(const std::string& reason, const bool flush)
 	}
 
 	aiClientLinks[MAX_AIS].link.reset();
+	cacheCursor.Stop();
 #ifdef SYNCCHECK
 	syncResponse.clear();
 #endif
@@ -5,10 +5,12 @@
 
 #include <memory>
 
+#include "PacketCache.h"
 #include "Game/Players/PlayerBase.h"
 #include "Game/Players/PlayerStatistics.h"
 #include "System/Net/LoopbackConnection.h"
 #include "System/UnorderedMap.hpp"
+#include "System/Sync/SyncChecker.h"
 #include "System/Misc/SpringTime.h"
 
 namespace netcode
@@ -50,6 +52,9 @@ public:
 
 	PlayerStatistics lastStats;
 
+	/// active while the server streams packets this client missed, live broadcasts are held back until then
+	PacketCache::Cursor cacheCursor;
+
 	spring_time disconnectDelay;
 
 	struct ClientLinkData {
@@ -69,6 +74,9 @@ public:
 
 	#ifdef SYNCCHECK
 	spring::unordered_map<int, unsigned int> syncResponse; // syncResponse[frameNum] = checksum
+
+	SyncLaneChecksums syncLanes = {};
+	int syncLanesFrame = -1;
 	#endif
 
 private:
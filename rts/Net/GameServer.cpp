@@ -1,9 +1,13 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include "System/Net/EventWaiter.h"
 #include "System/Net/UDPListener.h"
 #include "System/Net/UDPConnection.h"
 
+#include <bit>
 #include <functional>
+#include <cinttypes>
+#include <mutex>
 
 #if defined DEDICATED || defined DEBUG
 	#include <iostream>
@@ -25,6 +29,9 @@
 #ifndef DEDICATED
 #include "Game/IVideoCapturing.h"
 #endif
+#ifdef HEADLESS
+#include "Game/BenchmarkReport.h"
+#endif
 #include "Game/Players/Player.h"
 #include "Game/Players/PlayerHandler.h"
 
@@ -67,7 +74,11 @@ using netcode::RawPacket;
 
 
 CONFIG(int, AutohostPort).defaultValue(0).description("Which port should the engine listen on for Autohost interfact connections.");
-CONFIG(int, ServerSleepTime).defaultValue(5).description("Number of milliseconds to sleep per tick for the server thread. Lower values have marginally higher CPU load, while high values can introduce additional latency.");
+CONFIG(int, ServerSleepTime).defaultValue(5).description("Number of milliseconds to sleep per tick for the server thread. Lower values have marginally higher CPU load, while high values can introduce additional latency. With ServerEventLoop this only applies while outgoing data is waiting to be sent.");
+CONFIG(bool, ServerEventLoop).defaultValue(true).description("Wake the server thread when network input arrives or the next frame is due, instead of polling every ServerSleepTime milliseconds.");
+CONFIG(int, ServerIdleWaitTime).defaultValue(50).minimumValue(1).maximumValue(100).description("Maximum number of milliseconds the event-driven server thread waits when nothing is due, bounds how late housekeeping and autohost input are handled.");
+CONFIG(int, ServerCatchupRate).defaultValue(1024).minimumValue(0).description("Kilobytes per second of game history the server streams to each client that joins or reconnects after the game started, 0 sends all of it at once.");
+CONFIG(int, AutohostTelemetryInterval).defaultValue(0).minimumValue(0).description("Milliseconds between binary telemetry reports (frame rate, per-client lag and queues, cache and demo sizes, sync-response delays) sent to the autohost, which also get client profiling summaries forwarded. 0 disables both.");
 CONFIG(int, SpeedControl).defaultValue(1).minimumValue(1).maximumValue(2)
 	.description("Sets how server adjusts speed according to player's load (CPU), 1: use average, 2: use highest");
 CONFIG(bool, AllowSpectatorJoin).defaultValue(true).dedicatedValue(false).description("allow any unauthenticated clients to join as spectator with any name, name will be prefixed with ~");
@@ -120,11 +131,54 @@ decltype(CGameServer::commandBlacklist) CGameServer::commandBlacklist{
 	"nopause", "nohelp", "cheat", "desync", "godmode", "globallos",
 	"nocost", "forcestart", "nospectatorchat", "nospecdraw",
 	"skip", "reloadcob", "reloadcegs", "devlua", "editdefs",
-	"singlestep", "spec", "specbynum"
+	"singlestep", "spec", "specbynum", "looplatency"
 };
 
 
 
+void LatencyHistogram::Add(spring_time t)
+{
+	const int64_t ts = t.toMicroSecsi();
+	const uint64_t us = std::max(ts, int64_t(0));
+	const uint64_t bucket = std::bit_width(us >> MIN_BUCKET_BITS);
+
+	counts[std::min(bucket, uint64_t(NUM_BUCKETS - 1))] += 1;
+
+	numSamples += 1;
+	sumMicros += us;
+	maxMicros = std::max(maxMicros, us);
+}
+
+uint64_t LatencyHistogram::GetPercentile(float p) const
+{
+	const uint64_t rank = std::max(uint64_t(math::ceil(p * numSamples)), uint64_t(1));
+
+	uint64_t sum = 0;
+
+	for (unsigned int i = 0; i < NUM_BUCKETS; i++) {
+		if ((sum += counts[i]) < rank)
+			continue;
+
+		// the last bucket is open-ended
+		if (i == (NUM_BUCKETS - 1))
+			break;
+
+		return (std::min(uint64_t(1) << (MIN_BUCKET_BITS + i), maxMicros));
+	}
+
+	return maxMicros;
+}
+
+std::string LatencyHistogram::ToString(const char* name) const
+{
+	return (spring::format(
+		"%s: n=%" PRIu64 " mean=%" PRIu64 "us p50<=%" PRIu64 "us p99<=%" PRIu64 "us max=%" PRIu64 "us",
+		name, numSamples, GetMean(), GetPercentile(0.5f), GetPercentile(0.99f), maxMicros
+	));
+}
+
+
+
 CGameServer* gameServer = nullptr;
 
 CGameServer::CGameServer(
@@ -146,12 +200,25 @@ CGameServer::~CGameServer()
 {
 	quitServer = true;
 
+	if (loopWaiter != nullptr)
+		loopWaiter->Wake();
+
 	LOG_L(L_INFO, "[%s][1]", __func__);
 	thread.join();
 	LOG_L(L_INFO, "[%s][2]", __func__);
 
 	// after this, demoRecorder goes out of scope and its dtor is called
 	WriteDemoData();
+
+	// client links share the listener socket, which lives on loopWaiter's
+	// context; both have to be gone before members are destroyed (players
+	// outlives loopWaiter), this also covers Reload
+	for (GameParticipant& p: players) {
+		p.clientLink.reset();
+	}
+
+	udpListener.reset();
+	loopWaiter.reset();
 }
 
 
@@ -163,14 +230,30 @@ void CGameServer::Initialize()
 	whiteListAdditionalPlayers = configHandler->GetBool("WhiteListAdditionalPlayers");
 	logInfoMessages = configHandler->GetBool("ServerLogInfoMessages");
 	logDebugMessages = configHandler->GetBool("ServerLogDebugMessages");
+#ifdef HEADLESS
+	benchmarkReplay = CBenchmarkReport::IsEnabled();
+#endif
 
 	rng.Seed((myGameData->GetSetupText()).length());
 
 	// start network
-	if (!myGameSetup->onlyLocal)
-		udpListener.reset(new netcode::UDPListener(myClientSetup->hostPort, myClientSetup->hostIP));
+	if (configHandler->GetBool("ServerEventLoop"))
+		loopWaiter.reset(new netcode::EventWaiter());
+
+	if (!myGameSetup->onlyLocal) {
+		// the listening socket lives on the waiter's own context, so it can wait for it
+		udpListener.reset(new netcode::UDPListener(myClientSetup->hostPort, myClientSetup->hostIP, (loopWaiter != nullptr)? &loopWaiter->GetIoContext(): nullptr));
+
+		if (loopWaiter != nullptr)
+			loopWaiter->WatchSocket(udpListener->GetSocket());
+	}
+
+	{
+		const std::string autohostIP = myClientSetup->autohostIP.empty()? configHandler->GetString("AutohostIP"): myClientSetup->autohostIP;
+		const int autohostPort = (myClientSetup->autohostPort > 0)? myClientSetup->autohostPort: configHandler->GetInt("AutohostPort");
 
-	AddAutohostInterface(StringToLower(configHandler->GetString("AutohostIP")), configHandler->GetInt("AutohostPort"));
+		AddAutohostInterface(StringToLower(autohostIP), autohostPort);
+	}
 	Message(spring::format(ServerStart, myClientSetup->hostPort), false);
 
 	// start script
@@ -193,6 +276,7 @@ void CGameServer::Initialize()
 		mapDrawTimings.fill({spring_notime, 0});
 		chatMutedFlags.fill({false, false});
 		aiControlFlags.fill(false);
+		profileSummaryTimings.fill(spring_notime);
 
 		const std::vector<PlayerBase>& playerStartData = myGameSetup->GetPlayerStartingDataCont();
 		const std::vector<TeamBase>&     teamStartData = myGameSetup->GetTeamStartingDataCont();
@@ -243,7 +327,9 @@ void CGameServer::Initialize()
 	}
 
 	{
-		std::sort(commandBlacklist.begin(), commandBlacklist.end());
+		// other servers in this process may already be reading it
+		static std::once_flag sortFlag;
+		std::call_once(sortFlag, []() { std::sort(commandBlacklist.begin(), commandBlacklist.end()); });
 	}
 
 	if (configHandler->GetBool("ServerRecordDemos")) {
@@ -255,14 +341,20 @@ void CGameServer::Initialize()
 	}
 
 	loopSleepTime = configHandler->GetInt("ServerSleepTime");
+	loopIdleWaitTime = configHandler->GetInt("ServerIdleWaitTime");
+	catchupRate = configHandler->GetInt("ServerCatchupRate") * 1024;
+	telemetryInterval = configHandler->GetInt("AutohostTelemetryInterval");
+
 	linkMinPacketSize = globalConfig.linkIncomingMaxPacketRate > 0 ? (globalConfig.linkIncomingSustainedBandwidth / globalConfig.linkIncomingMaxPacketRate) : 1;
 
 	lastNewFrameTick = spring_gettime();
 	lastBandwidthUpdate = spring_gettime();
+	lastCatchupUpdate = spring_gettime();
+	lastTelemetryUpdate = spring_gettime();
 
 	thread = spring::thread(std::bind(&CGameServer::UpdateLoop, this));
 
-	LOG("%s: thread affinity %x", __func__, Threading::GetAffinity());
+	LOG("%s: thread affinity %" PRIx64, __func__, Threading::GetAffinity());
 
 	// Something in CGameServer::CGameServer borks the FPU control word
 	// maybe the threading, or something in CNet::InitServer() ??
@@ -364,7 +456,13 @@ void CGameServer::AddLocalClient(const std::string& myName, const std::string& m
 	std::lock_guard<spring::recursive_mutex> scoped_lock(gameServerMutex);
 	assert(!HasLocalClient());
 
-	localClientNumber = BindConnection(std::shared_ptr<netcode::CConnection>(new netcode::CLocalConnection()), myName, "", myVersion, myPlatform, true);
+	netcode::CLocalConnection* localConn = new netcode::CLocalConnection();
+
+	// packets from the local client do not pass through a socket
+	if (loopWaiter != nullptr)
+		localConn->SetIncomingDataCallback([this]() { loopWaiter->Wake(); });
+
+	localClientNumber = BindConnection(std::shared_ptr<netcode::CConnection>(localConn), myName, "", myVersion, myPlatform, true);
 }
 
 void CGameServer::AddAutohostInterface(const std::string& autohostIP, const int autohostPort)
@@ -478,7 +576,7 @@ bool CGameServer::SendDemoData(int targetFrameNum)
 #ifdef SYNCCHECK
 				if (targetFrameNum == -1) {
 					// not skipping
-					outstandingSyncFrames.insert(serverFrameNum);
+					outstandingSyncFrames.emplace(serverFrameNum, spring_gettime());
 				}
 				CheckSync();
 #endif
@@ -550,16 +648,119 @@ bool CGameServer::SendDemoData(int targetFrameNum)
 void CGameServer::Broadcast(std::shared_ptr<const netcode::RawPacket> packet)
 {
 	for (GameParticipant& p: players) {
+		// clients still catching up get this from the cache, in order
+		if (p.cacheCursor.IsActive())
+			continue;
+
 		p.SendData(packet);
 	}
 
 	if (canReconnect || allowSpecJoin || !gameHasStarted)
-		packetCache.push_back(packet);
+		packetCache.Add(*packet);
 
 	if (demoRecorder != nullptr)
 		demoRecorder->SaveToDemo(packet->data, packet->length, GetDemoTime());
 }
 
+void CGameServer::UpdateCatchup()
+{
+	const spring_time curTime = spring_gettime();
+	const float timeElapsed = std::min((curTime - lastCatchupUpdate).toSecsf(), 1.0f);
+
+	lastCatchupUpdate = curTime;
+
+	// with an unlimited rate BindConnection already sent everything
+	for (GameParticipant& p: players) {
+		if (p.cacheCursor.IsActive())
+			SendCachedPackets(p, size_t(catchupRate * timeElapsed));
+	}
+}
+
+void CGameServer::SendCachedPackets(GameParticipant& p, size_t maxBytes)
+{
+	std::vector< std::shared_ptr<const netcode::RawPacket> > packets;
+
+	// once the cursor reaches the end this client gets live broadcasts again
+	if (packetCache.Read(p.cacheCursor, maxBytes, packets))
+		p.cacheCursor.Stop();
+
+	for (const std::shared_ptr<const netcode::RawPacket>& packet: packets)
+		p.SendData(packet);
+}
+
+void CGameServer::UpdateTelemetry()
+{
+	if (hostif == nullptr || telemetryInterval <= 0)
+		return;
+
+	const spring_time curTime = spring_gettime();
+	const spring_time elapsed = curTime - lastTelemetryUpdate;
+
+	if (elapsed < spring_msecs(telemetryInterval))
+		return;
+
+	lastTelemetryUpdate = curTime;
+
+	AutohostInterface::ServerTelemetry server;
+	std::vector<AutohostInterface::ClientTelemetry> clients;
+
+	server.intervalMillis = elapsed.toMilliSecsi();
+	server.frameNum = serverFrameNum;
+	server.framesSent = std::max(serverFrameNum - telemetryFrameNum, 0);
+	server.userSpeed = userSpeedFactor;
+	server.internalSpeed = internalSpeed;
+	server.medianCpu = medianCpu;
+	server.medianPing = medianPing;
+
+	server.packetCachePackets = packetCache.GetNumPackets();
+	server.packetCacheRawBytes = packetCache.GetRawSize();
+	server.packetCacheMemBytes = packetCache.GetMemoryUsage();
+
+	if (demoRecorder != nullptr)
+		server.demoBytes = demoRecorder->GetFileHeader().demoStreamSize;
+
+	server.syncResponses = syncResponseLatency.numSamples;
+	server.syncResponseMeanMicros = syncResponseLatency.GetMean();
+	server.syncResponseP95Micros = syncResponseLatency.GetPercentile(0.95f);
+	server.syncResponseMaxMicros = syncResponseLatency.maxMicros;
+
+	server.isPaused = isPaused;
+	server.gameHasStarted = gameHasStarted;
+
+	telemetryFrameNum = serverFrameNum;
+	syncResponseLatency.Clear();
+
+	clients.reserve(players.size());
+
+	for (const GameParticipant& p: players) {
+		if (p.clientLink == nullptr)
+			continue;
+
+		AutohostInterface::ClientTelemetry client;
+
+		client.playerNum = p.id;
+		client.state = p.myState;
+		client.flags |= (AutohostInterface::ClientTelemetry::FLAG_SPECTATOR   * p.spectator);
+		client.flags |= (AutohostInterface::ClientTelemetry::FLAG_LOCAL       * p.isLocal);
+		client.flags |= (AutohostInterface::ClientTelemetry::FLAG_CATCHING_UP * p.cacheCursor.IsActive());
+		client.flags |= (AutohostInterface::ClientTelemetry::FLAG_DESYNCED    * p.desynced);
+
+		// same measure as the ping in NETMSG_PLAYERINFO
+		client.cpuUsage = p.cpuUsage;
+		client.lagFrames = std::max(serverFrameNum - p.lastFrameResponse, 0);
+		client.pingMillis = (client.lagFrames * 1000) / (GAME_SPEED * internalSpeed);
+
+		client.incomingQueue = std::min(p.clientLink->GetPacketQueueSize(), 0xFFFFu);
+		client.outgoingQueue = std::min(p.clientLink->GetOutgoingQueueSize(), 0xFFFFu);
+		client.bytesSent = p.clientLink->GetDataSent();
+		client.bytesReceived = p.clientLink->GetDataReceived();
+
+		clients.push_back(client);
+	}
+
+	hostif->SendTelemetry(server, clients);
+}
+
 void CGameServer::Message(const std::string& message, bool broadcast, bool internal)
 {
 	if (!internal) {
@@ -588,6 +789,10 @@ void CGameServer::PrivateMessage(int playerNum, const std::string& message) {
 void CGameServer::CheckSync()
 {
 #ifdef SYNCCHECK
+	// do not wait forever for clients that can not answer a lane request
+	if (syncLanesFrame >= 0 && serverFrameNum > (syncLanesFrame + static_cast<int>(SYNCCHECK_TIMEOUT)))
+		CheckSyncLanes(true);
+
 	std::vector< std::pair<unsigned, unsigned> > checksums; // <response checkum, #clients matching checksum>
 	std::vector<int> noSyncResponsePlayers;
 
@@ -597,7 +802,7 @@ void CGameServer::CheckSync()
 	auto outstandingSyncFrameIt = outstandingSyncFrames.begin();
 
 	while (outstandingSyncFrameIt != outstandingSyncFrames.end()) {
-		const signed outstandingSyncFrame = *outstandingSyncFrameIt;
+		const signed outstandingSyncFrame = outstandingSyncFrameIt->first;
 
 		unsigned correctChecksum = 0;
 		// maximum number of matched checksums
@@ -732,7 +937,12 @@ void CGameServer::CheckSync()
 			#endif
 
 				if (!desyncHasOccurred) {
-					if (globalConfig.dumpGameStateOnDesync) {
+					if (demoReader == nullptr) {
+						// ask everyone for their per-lane checksums of this frame; the lanes
+						// that differ name the subsystem and restrict the game state dump
+						LOG("Desync detected. Requesting per-subsystem sync checksums for frame %d.", outstandingSyncFrame);
+						Broadcast(CBaseNetProtocol::Get().SendSyncLanes(SERVER_PLAYER, syncLanesFrame = outstandingSyncFrame, {}));
+					} else if (globalConfig.dumpGameStateOnDesync) {
 						LOG("Desync detected. Requesting all clients to collect game state information.");
 						Broadcast(CBaseNetProtocol::Get().SendGameStateDump());
 					}
@@ -787,6 +997,88 @@ void CGameServer::CheckSync()
 }
 
 
+void CGameServer::CheckSyncLanes(bool timedOut)
+{
+#ifdef SYNCCHECK
+	if (syncLanesFrame < 0)
+		return;
+
+	std::vector<const GameParticipant*> responders;
+	std::string desyncedLanes;
+
+	responders.reserve(players.size());
+
+	for (const GameParticipant& p: players) {
+		if (p.clientLink == nullptr || p.myState == GameParticipant::State::DISCONNECTING)
+			continue;
+
+		if (p.syncLanesFrame == syncLanesFrame) {
+			responders.push_back(&p);
+			continue;
+		}
+
+		// wait for everyone still connected unless the request timed out
+		if (!timedOut)
+			return;
+	}
+
+	SyncLaneChecksums correctLanes = {};
+	uint32_t syncLaneMask = 0;
+
+	for (unsigned int lane = 0; lane < SYNC_LANE_COUNT; lane++) {
+		unsigned maxChecksumCount = 0;
+
+		// same policy as CheckSync; the local client dictates, otherwise majority vote
+		for (const GameParticipant* p: responders) {
+			unsigned checksumCount = 0;
+
+			for (const GameParticipant* q: responders) {
+				checksumCount += (q->syncLanes[lane] == p->syncLanes[lane]);
+			}
+
+			if (HasLocalClient() && p->id == static_cast<int>(localClientNumber))
+				checksumCount = -1u;
+
+			if (checksumCount <= maxChecksumCount)
+				continue;
+
+			maxChecksumCount = checksumCount;
+			correctLanes[lane] = p->syncLanes[lane];
+		}
+	}
+
+	for (const GameParticipant* p: responders) {
+		desyncedLanes.clear();
+
+		for (unsigned int lane = 0; lane < SYNC_LANE_COUNT; lane++) {
+			if (p->syncLanes[lane] == correctLanes[lane])
+				continue;
+
+			desyncedLanes += (desyncedLanes.empty())? "": ", ";
+			desyncedLanes += GetSyncLaneName(lane);
+			syncLaneMask |= (1u << lane);
+		}
+
+		if (desyncedLanes.empty())
+			continue;
+
+		Message(spring::format(SyncLaneError, p->name.c_str(), syncLanesFrame, desyncedLanes.c_str()));
+	}
+
+	if (globalConfig.dumpGameStateOnDesync) {
+		// dump everything if the lanes were inconclusive (e.g. nobody answered)
+		if (syncLaneMask == 0)
+			syncLaneMask = SYNC_LANE_MASK_ALL;
+
+		LOG("Requesting all clients to collect game state information (sync-lane mask %x).", syncLaneMask);
+		Broadcast(CBaseNetProtocol::Get().SendGameStateDump(syncLaneMask));
+	}
+
+	syncLanesFrame = -1;
+#endif
+}
+
+
 float CGameServer::GetDemoTime() const {
 	if (!gameHasStarted) return gameTime;
 	return (startTime + serverFrameNum * INV_GAME_SPEED);
@@ -800,12 +1092,20 @@ void CGameServer::Update()
 	gameTime += tdif;
 	lastUpdate = spring_gettime();
 
+	UpdateCatchup();
+
 	if (!isPaused && gameHasStarted) {
 		// if we are not playing a demo, or have no local client, or the
 		// local client is less than <GAME_SPEED> frames behind, advance
 		// <modGameTime>
-		if (demoReader == nullptr || !HasLocalClient() || (serverFrameNum - players[localClientNumber].lastFrameResponse) < GAME_SPEED)
+		if (demoReader == nullptr || !HasLocalClient() || (serverFrameNum - players[localClientNumber].lastFrameResponse) < GAME_SPEED) {
 			modGameTime += (tdif * internalSpeed);
+
+			// benchmark replays are paced only by the local client; hand
+			// it another second of demo time whenever it has caught up
+			if (benchmarkReplay && demoReader != nullptr)
+				modGameTime = std::max(modGameTime, demoReader->GetModGameTime() + 1.0f);
+		}
 	}
 
 	if (lastPlayerInfo < (spring_gettime() - playerInfoTime)) {
@@ -860,6 +1160,8 @@ void CGameServer::Update()
 		}
 	}
 
+	UpdateTelemetry();
+
 	const bool pregameTimeoutReached = (spring_gettime() > (serverStartTime + spring_secs(globalConfig.initialNetworkTimeout)));
 	const bool canCheckForPlayers = (pregameTimeoutReached || gameHasStarted);
 
@@ -1362,8 +1664,12 @@ void CGameServer::ProcessPacket(const unsigned playerNum, std::shared_ptr<const
 			assert(a == playerNum);
 			GameParticipant& p = players[a];
 
-			if (outstandingSyncFrames.find(frameNum) != outstandingSyncFrames.end())
+			const auto syncFrameIt = outstandingSyncFrames.find(frameNum);
+
+			if (syncFrameIt != outstandingSyncFrames.end()) {
 				p.syncResponse[frameNum] = checkSum;
+				syncResponseLatency.Add(spring_gettime() - syncFrameIt->second);
+			}
 
 			// update player's ping (if !defined(SYNCCHECK) this is done in NETMSG_KEYFRAME)
 			if (frameNum <= serverFrameNum && frameNum > p.lastFrameResponse)
@@ -1378,6 +1684,31 @@ void CGameServer::ProcessPacket(const unsigned playerNum, std::shared_ptr<const
 #endif
 		} break;
 
+		case NETMSG_SYNCLANES: {
+#ifdef SYNCCHECK
+			try {
+				netcode::UnpackPacket pckt(packet, 1);
+
+				uint8_t playerNum; pckt >> playerNum;
+				int32_t  frameNum; pckt >> frameNum;
+
+				if (playerNum != a) {
+					Message(spring::format(WrongPlayer, msgCode, a, playerNum));
+					break;
+				}
+
+				GameParticipant& p = players[a];
+
+				pckt >> p.syncLanes;
+				p.syncLanesFrame = frameNum;
+
+				CheckSyncLanes(false);
+			} catch (const netcode::UnpackPacketException& ex) {
+				Message(spring::format("Player %s sent invalid SyncLanes: %s", players[a].name.c_str(), ex.what()));
+			}
+#endif
+		} break;
+
 		case NETMSG_SHARE:
 			if (inbuf[1] != a) {
 				Message(spring::format(WrongPlayer, msgCode, a, (unsigned)inbuf[1]));
@@ -1844,6 +2175,26 @@ void CGameServer::ProcessPacket(const unsigned playerNum, std::shared_ptr<const
 			Broadcast(packet);
 			break;
 #endif
+		case NETMSG_PROFILE_SUMMARY: {
+			if (packet->length < 4)
+				break;
+
+			if (inbuf[3] != a) {
+				Message(spring::format(WrongPlayer, msgCode, a, (unsigned)inbuf[3]));
+				break;
+			}
+
+			// not broadcast, only of interest to an autohost collecting telemetry
+			if (hostif == nullptr || telemetryInterval <= 0)
+				break;
+
+			// limit to one summary per player per report
+			if (spring_diffmsecs(spring_now(), profileSummaryTimings[a]) >= telemetryInterval) {
+				hostif->SendPlayerProfile(packet->data, packet->length);
+				profileSummaryTimings[a] = spring_now();
+			}
+		} break;
+
 		case NETMSG_GAMESTATE_DUMP:
 			LOG("Server broadcast game state collection request.");
 			Broadcast(packet);
@@ -2177,8 +2528,15 @@ void CGameServer::StartGame(bool forced)
 	gameHasStarted = true;
 	startTime = gameTime;
 
-	if (!canReconnect && !allowSpecJoin)
-		packetCache.clear(); // free memory
+	if (!canReconnect && !allowSpecJoin) {
+		// nobody can join from here on, hand out what is left before freeing the cache
+		for (GameParticipant& p: players) {
+			if (p.cacheCursor.IsActive())
+				SendCachedPackets(p, size_t(-1));
+		}
+
+		packetCache.Clear();
+	}
 
 	if (udpListener && !canReconnect && !allowSpecJoin)
 		udpListener->SetAcceptingConnections(false); // do not accept new connections
@@ -2532,6 +2890,18 @@ void CGameServer::PushAction(const Action& action, bool fromAutoHost)
 			}
 		} break;
 
+		case hashString("looplatency"): {
+			Message(spring::format("server loop: %" PRIu64 " wakeups", numLoopWakeups), false);
+			Message(inputLatency.ToString("input-to-frame"), false);
+			Message(frameLatency.ToString("frame lateness"), false);
+
+			if (action.extra == "reset") {
+				inputLatency.Clear();
+				frameLatency.Clear();
+				numLoopWakeups = 0;
+			}
+		} break;
+
 		case hashString("kill"): {
 			LOG("Server killed!");
 			quitServer = true;
@@ -2676,7 +3046,7 @@ void CGameServer::CreateNewFrame(bool fromServerThread, bool fixedFrameTime)
 				}
 			}
 		#ifdef SYNCCHECK
-			outstandingSyncFrames.insert(serverFrameNum);
+			outstandingSyncFrames.emplace(serverFrameNum, spring_gettime());
 		#endif
 		}
 	}
@@ -2704,6 +3074,75 @@ std::string CGameServer::SpeedControlToString(int speedCtrl)
 }
 
 
+spring_time CGameServer::GetNextFrameTime() const
+{
+	// frames are only paced by the clock while a game is running
+	if (!gameHasStarted || PreSimFrame() || isPaused || demoReader != nullptr)
+		return spring_notime;
+	if (!spring_istime(lastNewFrameTick))
+		return spring_notime;
+
+	// inverse of the accumulation in CreateNewFrame
+	const float framesPerMicroSec = GAME_SPEED * internalSpeed * 0.000001f;
+
+	if (framesPerMicroSec <= 0.0f)
+		return spring_notime;
+
+	return (lastNewFrameTick + spring_time::fromMicroSecs(static_cast<int64_t>(-frameTimeLeft / framesPerMicroSec)));
+}
+
+void CGameServer::WaitForEvents()
+{
+	const spring_time now = spring_gettime();
+
+	spring_time waitTime = spring_msecs(loopIdleWaitTime);
+
+	{
+		std::lock_guard<spring::recursive_mutex> scoped_lock(gameServerMutex);
+
+		// connections pace their own (re)sends, keep polling them while they have anything queued
+		if (demoReader != nullptr || (udpListener != nullptr && udpListener->HasPendingOutgoing()))
+			waitTime = spring_msecs(loopSleepTime);
+
+		nextFrameTime = GetNextFrameTime();
+	}
+
+	spring_time deadline = now + waitTime;
+
+	if (spring_istime(nextFrameTime))
+		deadline = std::min(deadline, nextFrameTime);
+
+	if (deadline <= now)
+		return;
+
+	if (loopWaiter->Wait(deadline) == netcode::EventWaiter::EVENT_NONE)
+		return;
+
+	numLoopWakeups++;
+
+	if (!spring_istime(firstInputTime))
+		firstInputTime = spring_gettime();
+}
+
+void CGameServer::UpdateLoopLatency(int prevServerFrameNum)
+{
+	if (loopWaiter == nullptr)
+		return;
+	if (serverFrameNum == prevServerFrameNum)
+		return;
+
+	const spring_time now = spring_gettime();
+
+	if (spring_istime(firstInputTime))
+		inputLatency.Add(now - firstInputTime);
+	if (spring_istime(nextFrameTime))
+		frameLatency.Add(std::max(now - nextFrameTime, spring_notime));
+
+	firstInputTime = spring_notime;
+	nextFrameTime = spring_notime;
+}
+
+
 __FORCE_ALIGN_STACK__
 void CGameServer::UpdateLoop()
 {
@@ -2712,20 +3151,39 @@ void CGameServer::UpdateLoop()
 		Threading::SetAffinity(~0);
 
 		while (!quitServer) {
-			spring_msecs(loopSleepTime).sleep(true);
+			if (loopWaiter != nullptr) {
+				WaitForEvents();
+			} else {
+				spring_msecs(loopSleepTime).sleep(true);
+			}
 
 			if (udpListener != nullptr)
 				udpListener->Update();
 
 			std::lock_guard<spring::recursive_mutex> scoped_lock(gameServerMutex);
+			const int prevServerFrameNum = serverFrameNum;
+
 			ServerReadNet();
 			Update();
+			UpdateLoopLatency(prevServerFrameNum);
+		}
+
+		if (loopWaiter != nullptr) {
+			LOG("[%s] %" PRIu64 " wakeups", __func__, numLoopWakeups);
+			LOG("[%s] %s", __func__, inputLatency.ToString("input-to-frame").c_str());
+			LOG("[%s] %s", __func__, frameLatency.ToString("frame lateness").c_str());
 		}
 
+		LOG("[%s] packet cache: %u packets, %uKB raw, %uKB in memory", __func__,
+			unsigned(packetCache.GetNumPackets()),
+			unsigned(packetCache.GetRawSize() / 1024),
+			unsigned(packetCache.GetMemoryUsage() / 1024)
+		);
+
 		if (hostif != nullptr)
 			hostif->SendQuit();
 
-		LOG("%s: thread affinity %x", __func__, Threading::GetAffinity());
+		LOG("%s: thread affinity %" PRIx64, __func__, Threading::GetAffinity());
 
 		Broadcast(CBaseNetProtocol::Get().SendQuit("Server shutdown"));
 
@@ -3019,6 +3477,9 @@ unsigned CGameServer::BindConnection(
 	newPlayer.SendData(std::shared_ptr<const RawPacket>(myGameData->Pack()));
 	newPlayer.SendData(CBaseNetProtocol::Get().SendSetPlayerNum((unsigned char)newPlayerNumber));
 
+	// from here on broadcasts reach the player through the cache, after everything missed so far
+	newPlayer.cacheCursor.Start();
+
 	// after gamedata and playerNum, the player can start loading
 	if (demoReader == nullptr || myGameSetup->demoName.empty()) {
 		// player wants to play -> join team
@@ -3035,9 +3496,13 @@ unsigned CGameServer::BindConnection(
 		}
 	}
 
-	// finally send player all packets he missed until now
-	for (const std::shared_ptr<const netcode::RawPacket>& p: packetCache)
-		newPlayer.SendData(p);
+	// send the first part of the missed packets right away, and all of them for
+	// local players or before the game started (the cache is small until then)
+	if (isLocal || !gameHasStarted || catchupRate <= 0) {
+		SendCachedPackets(newPlayer, size_t(-1));
+	} else {
+		SendCachedPackets(newPlayer, catchupRate / GAME_SPEED);
+	}
 
 	// new connection established
 	Message(spring::format(" -> Connection established (given id %i)", newPlayerNumber));
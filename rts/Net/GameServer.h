@@ -5,7 +5,9 @@
 
 // #include <asio/ip/udp.hpp>
 
+#include <algorithm>
 #include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <array>
@@ -14,6 +16,7 @@
 #include <set>
 #include <vector>
 
+#include "PacketCache.h"
 #include "Game/GameData.h"
 #include "Sim/Misc/GlobalConstants.h"
 #include "Sim/Misc/TeamBase.h"
@@ -32,6 +35,7 @@ namespace netcode
 	class RawPacket;
 	class CConnection;
 	class UDPListener;
+	class EventWaiter;
 }
 class CDemoReader;
 class Action;
@@ -43,6 +47,32 @@ class ChatMessage;
 class GameParticipant;
 class GameSkirmishAI;
 
+/**
+ * @brief Distribution of server-side latencies
+ * Samples go into power-of-two buckets, starting with everything below 64us
+ * and ending with everything above ~1s; percentiles are bucket upper bounds.
+ */
+struct LatencyHistogram
+{
+	static constexpr unsigned int NUM_BUCKETS = 16;
+	static constexpr unsigned int MIN_BUCKET_BITS = 6;
+
+	void Add(spring_time t);
+	void Clear() { *this = {}; }
+
+	uint64_t GetPercentile(float p) const;
+	uint64_t GetMean() const { return (sumMicros / std::max(numSamples, uint64_t(1))); }
+
+	/// "name: n=... mean=...us p50<=...us p99<=...us max=...us"
+	std::string ToString(const char* name) const;
+
+	std::array<uint64_t, NUM_BUCKETS> counts = {};
+
+	uint64_t numSamples = 0;
+	uint64_t sumMicros = 0;
+	uint64_t maxMicros = 0;
+};
+
 class GameTeam : public TeamBase
 {
 public:
@@ -158,9 +188,14 @@ private:
 	void CheckForGameStart(bool forced = false);
 	void StartGame(bool forced);
 	void UpdateLoop();
+	/// sleeps until network input arrives, a frame is due or connections need servicing
+	void WaitForEvents();
+	void UpdateLoopLatency(int prevServerFrameNum);
+	spring_time GetNextFrameTime() const;
 	void Update();
 	void ProcessPacket(const unsigned playerNum, std::shared_ptr<const netcode::RawPacket> packet);
 	void CheckSync();
+	void CheckSyncLanes(bool timedOut);
 	void HandleConnectionAttempts();
 	void ServerReadNet();
 
@@ -175,6 +210,13 @@ private:
 
 	void Broadcast(std::shared_ptr<const netcode::RawPacket> packet);
 
+	/// stream cached packets to clients that are catching up, at most catchupRate per second each
+	void UpdateCatchup();
+	void SendCachedPackets(GameParticipant& p, size_t maxBytes);
+
+	/// sends SERVER_TELEMETRY to the autohost every telemetryInterval milliseconds
+	void UpdateTelemetry();
+
 	/**
 	 * @brief skip frames
 	 *
@@ -215,17 +257,20 @@ private:
 	std::array< std::pair<spring_time, uint32_t>, MAX_PLAYERS> mapDrawTimings; // throttles NETMSG_MAPDRAW
 	std::array< std::pair<       bool,     bool>, MAX_PLAYERS> chatMutedFlags; // blocks NETMSG_{CHAT,DRAW}
 	std::array<                            bool , MAX_PLAYERS> aiControlFlags; // blocks NETMSG_AI_CREATED (aicontrol)
+	std::array<           spring_time           , MAX_PLAYERS> profileSummaryTimings; // throttles NETMSG_PROFILE_SUMMARY
 
 	// std::map<asio::ip::udp::endpoint, int> rejectedConnections;
 	std::map<std::string, int> rejectedConnections;
 
 	std::pair<std::string, std::string> refClientVersion;
 
-	std::deque< std::shared_ptr<const netcode::RawPacket> > packetCache;
+	/// everything broadcast so far, for reconnecting and late-joining clients
+	PacketCache packetCache;
 
 	/////////////////// sync stuff ///////////////////
 #ifdef SYNCCHECK
-	std::set<int> outstandingSyncFrames;
+	/// frames waiting for sync-responses, and when they were sent
+	std::map<int, spring_time> outstandingSyncFrames;
 #endif
 
 	/////////////////// game status variables ///////////////////
@@ -236,6 +281,8 @@ private:
 	spring_time lastPlayerInfo = spring_notime;
 	spring_time lastUpdate = spring_notime;
 	spring_time lastBandwidthUpdate = spring_notime;
+	spring_time lastCatchupUpdate = spring_notime;
+	spring_time lastTelemetryUpdate = spring_notime;
 
 	float modGameTime = 0.0f;
 	float gameTime = 0.0f;
@@ -249,12 +296,21 @@ private:
 	int medianPing = 0;
 	int curSpeedCtrl = 0;
 	int loopSleepTime = 0;
+	int loopIdleWaitTime = 0;
+	/// bytes per second, 0 if unlimited
+	int catchupRate = 0;
+	/// milliseconds between autohost telemetry reports, 0 if disabled
+	int telemetryInterval = 0;
+	/// serverFrameNum at the previous telemetry report
+	int telemetryFrameNum = 0;
 
 
 	int serverFrameNum = -1;
 
 	int syncErrorFrame = 0;
 	int syncWarningFrame = 0;
+	/// frame for which per-lane checksums were requested after a desync, -1 if none outstanding
+	int syncLanesFrame = -1;
 	bool desyncHasOccurred = false;
 
 	int linkMinPacketSize = 1;
@@ -280,11 +336,29 @@ private:
 
 	bool logInfoMessages = false;
 	bool logDebugMessages = false;
+	/// replay demos as fast as the local client can simulate them (headless only)
+	bool benchmarkReplay = false;
 
 
 	/// If the server receives a command, it will forward it to clients if it is not in this set
-	static std::array<std::string, 26> commandBlacklist;
+	static std::array<std::string, 27> commandBlacklist;
+
+	/////////////////// loop latency ///////////////////
+	/// time from network input waking the loop until the next frame went out
+	LatencyHistogram inputLatency;
+	/// how late frames were created relative to when they were due
+	LatencyHistogram frameLatency;
+
+	spring_time firstInputTime = spring_notime;
+	spring_time nextFrameTime = spring_notime;
+
+	uint64_t numLoopWakeups = 0;
+
+	/// delays of sync-responses received since the last telemetry report
+	LatencyHistogram syncResponseLatency;
 
+	/// null if ServerEventLoop is disabled
+	std::unique_ptr<netcode::EventWaiter> loopWaiter;
 	std::unique_ptr<netcode::UDPListener> udpListener;
 	std::unique_ptr<CDemoReader> demoReader;
 	std::unique_ptr<CDemoRecorder> demoRecorder;
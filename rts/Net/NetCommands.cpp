@@ -109,6 +109,7 @@ void CGame::SendClientProcUsage()
 
 			// take the minimum drawframes into account, too
 			clientNet->Send(CBaseNetProtocol::Get().SendCPUUsage(totalProcUsage));
+			SendClientProfileSummary();
 		} else {
 			// the CPU-load percentage is undefined prior to SimFrame()
 			clientNet->Send(CBaseNetProtocol::Get().SendCPUUsage(0.0f));
@@ -117,6 +118,36 @@ void CGame::SendClientProcUsage()
 }
 
 
+void CGame::SendClientProfileSummary()
+{
+	static spring_time lastProfileSummaryTime = spring_gettime();
+
+	// coarser than the CPU usage, the server only passes these on to an autohost
+	if ((spring_gettime() - lastProfileSummaryTime).toMilliSecsf() < 5000.0f)
+		return;
+
+	lastProfileSummaryTime = spring_gettime();
+
+	const auto& profiler = CTimeProfiler::GetInstance();
+	std::vector<CBaseNetProtocol::ProfileTimer> timers;
+
+	// "Update" only has data while the profiler is enabled
+	for (const char* name: {"Sim", "Draw", "Update"}) {
+		const CTimeProfiler::TimeRecord& rec = profiler.GetTimeRecord(name);
+
+		if (rec.stats.y <= 0.0f && rec.stats.x <= 0.0f)
+			continue;
+
+		timers.push_back({name, rec.stats.y, rec.stats.x});
+	}
+
+	if (timers.empty())
+		return;
+
+	clientNet->Send(CBaseNetProtocol::Get().SendProfileSummary(gu->myPlayerNum, timers));
+}
+
+
 uint32_t CGame::GetNumQueuedSimFrameMessages(uint32_t maxFrames) const
 {
 	// read ahead to find number of NETMSG_XXXFRAMES we still have to process
@@ -616,6 +647,12 @@ void CGame::ClientReadNet()
 
 				SimFrame();
 
+#ifdef SYNCCHECK
+				benchmarkReport.SimFrame(gs->frameNum, CSyncChecker::GetChecksum());
+#else
+				benchmarkReport.SimFrame(gs->frameNum, 0);
+#endif
+
 #ifdef SYNCCHECK
 				// both NETMSG_SYNCRESPONSE and NETMSG_NEWFRAME are used for ping calculation by server
 				ASSERT_SYNCED(gs->frameNum);
@@ -626,6 +663,9 @@ void CGame::ClientReadNet()
 				if (haveServerDemo)
 					localSyncChecksums[gs->frameNum] = CSyncChecker::GetChecksum();
 
+				// keep per-lane checksums around in case the server asks for them
+				CSyncChecker::SaveLaneHistory(gs->frameNum);
+
 				// reset checksum every 4096 frames =~ 2.5 minutes
 				if ((gs->frameNum & 4095) == 0)
 					CSyncChecker::NewFrame();
@@ -668,6 +708,37 @@ void CGame::ClientReadNet()
 #endif
 			} break;
 
+			case NETMSG_SYNCLANES: {
+				ZoneScopedN("Net::SyncLanes");
+#if (defined(SYNCCHECK))
+				// server detected a desync and wants our lane checksums for
+				// that frame; requests replayed from a demo are not answered
+				if (haveServerDemo)
+					break;
+
+				try {
+					netcode::UnpackPacket pckt(packet, 1);
+
+					uint8_t playerNum; pckt >> playerNum;
+					int32_t  frameNum; pckt >> frameNum;
+
+					SyncLaneChecksums laneChecksums;
+
+					if (playerNum != SERVER_PLAYER)
+						break;
+
+					if (!CSyncChecker::GetLaneHistory(frameNum, laneChecksums)) {
+						LOG_L(L_WARNING, "[Game::%s] no sync-lane checksums left for frame %d", __func__, frameNum);
+						break;
+					}
+
+					clientNet->Send(CBaseNetProtocol::Get().SendSyncLanes(gu->myPlayerNum, frameNum, laneChecksums));
+				} catch (const netcode::UnpackPacketException& ex) {
+					LOG_L(L_ERROR, "[Game::%s][NETMSG_SYNCLANES] exception \"%s\"", __func__, ex.what());
+				}
+#endif
+			} break;
+
 
 			case NETMSG_COMMAND: {
 				ZoneScopedN("Net::Command");
@@ -1570,8 +1641,10 @@ void CGame::ClientReadNet()
 
 			case NETMSG_GAMESTATE_DUMP: {
 				ZoneScopedN("Net::GamestateDump");
-				LOG("Collecting current game state information.");
-				DumpState(gs->frameNum, gs->frameNum, 1, true, true);
+				const uint32_t syncLaneMask = *reinterpret_cast<const uint32_t*>(inbuf + 1);
+
+				LOG("Collecting current game state information (sync-lane mask %x).", syncLaneMask);
+				DumpState(gs->frameNum, gs->frameNum, 1, true, true, syncLaneMask);
 				break;
 			}
 
@@ -0,0 +1,110 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "PacketCache.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "System/StringUtil.h"
+#include "System/Log/ILog.h"
+#include "System/Net/RawPacket.h"
+
+
+void PacketCache::Add(const netcode::RawPacket& packet)
+{
+	const uint32_t length = packet.length;
+	const size_t pos = openBlock.size();
+
+	openBlock.resize(pos + sizeof(length) + length);
+	std::memcpy(&openBlock[pos], &length, sizeof(length));
+
+	if (length > 0)
+		std::memcpy(&openBlock[pos + sizeof(length)], packet.data, length);
+
+	numPackets += 1;
+	rawSize += length;
+
+	if (openBlock.size() >= BLOCK_SIZE)
+		SealBlock();
+}
+
+void PacketCache::SealBlock()
+{
+	const std::vector<uint8_t> packedData = zlib::deflate(openBlock);
+	const std::vector<uint8_t>& blockData = packedData.empty()? openBlock: packedData;
+
+	if (packedData.empty())
+		LOG_L(L_WARNING, "[PacketCache::%s] failed to compress block %u, storing it uncompressed", __func__, unsigned(blocks.size()));
+
+	blocks.push_back({arena.size(), blockData.size(), openBlock.size(), !packedData.empty()});
+	arena.insert(arena.end(), blockData.begin(), blockData.end());
+
+	// keep the capacity for the next block
+	openBlock.clear();
+}
+
+void PacketCache::Clear()
+{
+	arena = {};
+	blocks = {};
+	openBlock = {};
+
+	numPackets = 0;
+	rawSize = 0;
+}
+
+
+bool PacketCache::Read(Cursor& cursor, size_t maxBytes, std::vector< std::shared_ptr<const netcode::RawPacket> >& packets) const
+{
+	size_t numBytes = 0;
+
+	while (cursor.blockIdx <= blocks.size()) {
+		const uint8_t* data = openBlock.data();
+		size_t dataSize = openBlock.size();
+
+		if (cursor.blockIdx < blocks.size()) {
+			const Block& block = blocks[cursor.blockIdx];
+
+			if (!block.packed) {
+				data = &arena[block.arenaPos];
+				dataSize = block.arenaSize;
+			} else {
+				if (cursor.blockDataIdx != cursor.blockIdx) {
+					cursor.blockData = zlib::inflate(&arena[block.arenaPos], block.arenaSize);
+					cursor.blockDataIdx = cursor.blockIdx;
+
+					if (cursor.blockData.size() != block.rawSize) {
+						LOG_L(L_ERROR, "[PacketCache::%s] block %u is corrupt, skipping it", __func__, unsigned(cursor.blockIdx));
+						cursor.blockData.clear();
+					}
+				}
+
+				data = cursor.blockData.data();
+				dataSize = cursor.blockData.size();
+			}
+		}
+
+		if (cursor.readPos >= dataSize) {
+			// caught up with the packets that are still being added
+			if (cursor.blockIdx == blocks.size())
+				return true;
+
+			cursor.blockIdx += 1;
+			cursor.readPos = 0;
+			continue;
+		}
+
+		if (numBytes > 0 && numBytes >= maxBytes)
+			return false;
+
+		uint32_t length = 0;
+		std::memcpy(&length, data + cursor.readPos, sizeof(length));
+
+		packets.emplace_back(std::make_shared<const netcode::RawPacket>(data + cursor.readPos + sizeof(length), length));
+
+		cursor.readPos += (sizeof(length) + length);
+		numBytes += std::max(length, 1u);
+	}
+
+	return true;
+}
@@ -0,0 +1,91 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _PACKET_CACHE_H
+#define _PACKET_CACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace netcode
+{
+	class RawPacket;
+}
+
+/**
+ * @brief Everything the server broadcast so far, for clients joining late
+ * Packets are appended to an open block; full blocks are compressed into
+ * one append-only arena, so a long game costs a few large allocations
+ * instead of one per packet.
+ */
+class PacketCache
+{
+public:
+	/**
+	 * @brief Read position of one client catching up
+	 * Stays valid across Add, including when the block it points into
+	 * gets sealed.
+	 */
+	class Cursor {
+	public:
+		bool IsActive() const { return active; }
+
+		void Start() { *this = {}; active = true; }
+		void Stop() { *this = {}; }
+
+	private:
+		friend class PacketCache;
+
+		size_t blockIdx = 0;
+		size_t readPos = 0;
+
+		/// unpacked copy of blocks[blockIdx], if that is sealed
+		std::vector<uint8_t> blockData;
+		size_t blockDataIdx = size_t(-1);
+
+		bool active = false;
+	};
+
+public:
+	void Add(const netcode::RawPacket& packet);
+	/// frees all memory, cursors must be restarted afterwards
+	void Clear();
+
+	/**
+	 * @brief Unpacks the packets following cursor into packets
+	 * Stops after maxBytes of packet data (but always reads at least one
+	 * packet) or when it caught up with the last added packet.
+	 * @return true if cursor reached the end of the cache
+	 */
+	bool Read(Cursor& cursor, size_t maxBytes, std::vector< std::shared_ptr<const netcode::RawPacket> >& packets) const;
+
+	size_t GetNumPackets() const { return numPackets; }
+	size_t GetRawSize() const { return rawSize; }
+	size_t GetMemoryUsage() const { return (arena.capacity() + openBlock.capacity() + blocks.capacity() * sizeof(Block)); }
+
+private:
+	void SealBlock();
+
+private:
+	static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+	struct Block {
+		size_t arenaPos;
+		size_t arenaSize;
+		size_t rawSize;
+		/// false if deflate failed and the block is stored as-is
+		bool packed;
+	};
+
+	/// compressed contents of all sealed blocks, back to back
+	std::vector<uint8_t> arena;
+	std::vector<Block> blocks;
+
+	/// length-prefixed packets not compressed yet
+	std::vector<uint8_t> openBlock;
+
+	size_t numPackets = 0;
+	size_t rawSize = 0;
+};
+
+#endif // _PACKET_CACHE_H
@@ -543,6 +543,30 @@ PacketType CBaseNetProtocol::SendPing(uint8_t playerNum, uint8_t pingTag, float
 	return PacketType(packet);
 }
 
+PacketType CBaseNetProtocol::SendProfileSummary(uint8_t playerNum, const std::vector<ProfileTimer>& timers)
+{
+	uint32_t payloadSize = sizeof(playerNum);
+
+	for (const ProfileTimer& timer: timers) {
+		payloadSize += sizeof(timer.percentage) + sizeof(timer.peakMillis) + (timer.name.size() + 1);
+	}
+
+	const uint32_t headerSize = sizeof(uint8_t) + sizeof(uint16_t);
+	const uint32_t packetSize = headerSize + payloadSize;
+
+	if (packetSize >= (1 << (sizeof(uint16_t) * 8)))
+		throw netcode::PackPacketException("[BaseNetProto::SendProfileSummary] maximum packet-size exceeded");
+
+	PackPacket* packet = new PackPacket(packetSize, NETMSG_PROFILE_SUMMARY);
+	*packet << static_cast<uint16_t>(packetSize) << playerNum;
+
+	for (const ProfileTimer& timer: timers) {
+		*packet << timer.percentage << timer.peakMillis << timer.name;
+	}
+
+	return PacketType(packet);
+}
+
 
 PacketType CBaseNetProtocol::SendClientData(uint8_t playerNum, const std::vector<uint8_t>& data)
 {
@@ -605,9 +629,17 @@ PacketType CBaseNetProtocol::SendSdBlockresponse(uint8_t playerNum, std::vector<
 }
 #endif // SYNCDEBUG
 
-PacketType CBaseNetProtocol::SendGameStateDump()
+PacketType CBaseNetProtocol::SendGameStateDump(uint32_t syncLaneMask)
+{
+	PackPacket* packet = new PackPacket(sizeof(uint8_t) + sizeof(syncLaneMask), NETMSG_GAMESTATE_DUMP);
+	*packet << syncLaneMask;
+	return PacketType(packet);
+}
+
+PacketType CBaseNetProtocol::SendSyncLanes(uint8_t playerNum, int32_t frameNum, const SyncLaneChecksums& laneChecksums)
 {
-	PackPacket* packet = new PackPacket(sizeof(uint8_t), NETMSG_GAMESTATE_DUMP);
+	PackPacket* packet = new PackPacket(sizeof(uint8_t) + sizeof(playerNum) + sizeof(frameNum) + sizeof(laneChecksums), NETMSG_SYNCLANES);
+	*packet << playerNum << frameNum << laneChecksums;
 	return PacketType(packet);
 }
 
@@ -671,6 +703,7 @@ CBaseNetProtocol::CBaseNetProtocol()
 	proto->AddType(NETMSG_AI_STATE_CHANGED, 4);
 	proto->AddType(NETMSG_GAME_FRAME_PROGRESS, 5);
 	proto->AddType(NETMSG_PING, 1 + (1 + 1 + 4));
+	proto->AddType(NETMSG_PROFILE_SUMMARY, -2);
 
 #ifdef SYNCDEBUG
 	proto->AddType(NETMSG_SD_CHKREQUEST, 5);
@@ -680,6 +713,7 @@ CBaseNetProtocol::CBaseNetProtocol()
 	proto->AddType(NETMSG_SD_BLKRESPONSE, -2);
 #endif // SYNCDEBUG
 
-	proto->AddType(NETMSG_GAMESTATE_DUMP, 1);
+	proto->AddType(NETMSG_GAMESTATE_DUMP, 1 + sizeof(uint32_t));
+	proto->AddType(NETMSG_SYNCLANES, 1 + 1 + sizeof(int32_t) + sizeof(SyncLaneChecksums));
 }
 
@@ -11,6 +11,7 @@
 
 #include "Game/GameVersion.h"
 #include "NetMessageTypes.h"
+#include "System/Sync/SyncChecker.h"
 
 #if (!defined(DEDICATED) && !defined(UNITSYNC) && !defined(BUILDING_AI) && !defined(UNIT_TEST))
 #define CLIENT_NETLOG(p, l, m) clientNet->Send(CBaseNetProtocol::Get().SendLogMsg((p), (l), (m)))
@@ -83,6 +84,14 @@ public:
 	PacketType SendCurrentFrameProgress(int32_t frameNum);
 	PacketType SendPing(uint8_t playerNum, uint8_t pingTag, float localTime);
 
+	struct ProfileTimer {
+		std::string name;
+		float percentage;
+		float peakMillis;
+	};
+
+	PacketType SendProfileSummary(uint8_t playerNum, const std::vector<ProfileTimer>& timers);
+
 	PacketType SendPlayerStat(uint8_t playerNum, const PlayerStatistics& currentStats);
 	PacketType SendTeamStat(uint8_t teamNum, const TeamStatistics& currentStats);
 
@@ -118,7 +127,8 @@ public:
 	PacketType SendSdBlockresponse(uint8_t playerNum, std::vector<uint32_t> checksums);
 #endif
 
-	PacketType SendGameStateDump();
+	PacketType SendGameStateDump(uint32_t syncLaneMask = SYNC_LANE_MASK_ALL);
+	PacketType SendSyncLanes(uint8_t playerNum, int32_t frameNum, const SyncLaneChecksums& laneChecksums);
 
 private:
 	CBaseNetProtocol();
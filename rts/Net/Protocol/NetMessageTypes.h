@@ -66,7 +66,8 @@ enum NETMSG {
 	NETMSG_SD_RESET         = 45,
 #endif // SYNCDEBUG
 
-	NETMSG_GAMESTATE_DUMP	= 46, // no arguments
+	NETMSG_GAMESTATE_DUMP	= 46, // uint32_t syncLaneMask
+	NETMSG_SYNCLANES        = 47, // uint8_t playerNum; int32_t frameNum; uint32_t laneChecksums[SYNC_LANE_COUNT]; (request if playerNum is SERVER_PLAYER)
 
 	NETMSG_LOGMSG           = 49, // uint8_t playerNum, uint8_t logMsgLvl, std::string strData
 	NETMSG_LUAMSG           = 50, // /* uint16_t messageSize */, uint8_t playerNum, uint16_t script, uint8_t mode, std::vector<uint8_t> rawData
@@ -95,6 +96,8 @@ enum NETMSG {
 
 	NETMSG_PING = 78, // uint8_t playerNum, uint8_t pingTag, float localTime
 
+	NETMSG_PROFILE_SUMMARY = 79, // uint16_t messageSize, uint8_t playerNum, numTimers * { float percentage, float peakMillis, std::string name } # only forwarded to the autohost #
+
 	NETMSG_LAST //max types of netmessages, internal only
 };
 
@@ -0,0 +1,461 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "SpectatorRelay.h"
+
+#include <algorithm>
+
+#include "Game/GameVersion.h"
+#include "Net/Protocol/BaseNetProtocol.h"
+#include "Net/Protocol/NetMessageTypes.h"
+#include "Sim/Misc/GlobalConstants.h"
+#include "System/Exceptions.h"
+#include "System/GlobalConfig.h"
+#include "System/SpringFormat.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/Log/ILog.h"
+#include "System/Net/Socket.h"
+#include "System/Net/UDPConnection.h"
+#include "System/Net/UDPListener.h"
+#include "System/Net/UnpackPacket.h"
+#include "System/Platform/Misc.h"
+
+using netcode::RawPacket;
+
+
+CSpectatorRelay::CSpectatorRelay(
+	const std::string& upstreamHost,
+	int upstreamPort,
+	const std::string& listenIP,
+	int listenPort,
+	const std::string& relayName_,
+	const std::string& relayPassword_,
+	const std::string& clientPassword_
+)
+	: relayName(relayName_)
+	, relayPassword(relayPassword_)
+	, clientPassword(clientPassword_)
+{
+	#ifndef UNIT_TEST
+	loopSleepTime = configHandler->GetInt("ServerSleepTime");
+	loopIdleWaitTime = configHandler->GetInt("ServerIdleWaitTime");
+	catchupRate = configHandler->GetInt("ServerCatchupRate") * 1024;
+	#endif
+
+	listener = std::make_unique<netcode::UDPListener>(listenPort, listenIP, &waiter.GetIoContext());
+	waiter.WatchSocket(listener->GetSocket());
+
+	asio::error_code err;
+	asio::ip::address upstreamAddr = netcode::ResolveAddr(upstreamHost, upstreamPort, &err).address();
+
+	if (err)
+		throw network_error("[SpectatorRelay] failed to resolve upstream host \"" + upstreamHost + "\": " + err.message());
+
+	// a dual-stack socket reports IPv4 peers as mapped addresses
+	if (upstreamAddr.is_v4() && listener->GetSocket()->local_endpoint().address().is_v6())
+		upstreamAddr = asio::ip::make_address_v6(asio::ip::v4_mapped, upstreamAddr.to_v4());
+
+	upstream = listener->SpawnConnection(upstreamAddr.to_string(), upstreamPort);
+	upstream->Unmute();
+	upstream->SendData(CBaseNetProtocol::Get().SendAttemptConnect(relayName, relayPassword, SpringVersion::GetSync(), Platform::GetPlatformStr(), globalConfig.networkLossFactor));
+	upstream->Flush(true);
+
+	lastCatchupUpdate = spring_gettime();
+
+	LOG("[SpectatorRelay] connecting to %s:%d as %s", upstreamHost.c_str(), upstreamPort, relayName.c_str());
+}
+
+CSpectatorRelay::~CSpectatorRelay()
+{
+	if (!finished)
+		Finish("Relay shutdown");
+
+	LOG("[SpectatorRelay] packet cache: %u packets, %uKB raw, %uKB in memory",
+		unsigned(packetCache.GetNumPackets()),
+		unsigned(packetCache.GetRawSize() / 1024),
+		unsigned(packetCache.GetMemoryUsage() / 1024)
+	);
+}
+
+
+void CSpectatorRelay::Update()
+{
+	if (finished)
+		return;
+
+	WaitForEvents();
+
+	listener->Update();
+
+	ReadUpstream();
+
+	if (finished)
+		return;
+
+	// clients have nothing to join before the upstream accepted us
+	if (joined)
+		HandleConnectionAttempts();
+
+	ReadClients();
+	UpdateCatchup();
+}
+
+void CSpectatorRelay::WaitForEvents()
+{
+	const spring_time now = spring_gettime();
+
+	spring_time waitTime = spring_msecs(loopIdleWaitTime);
+
+	// connections pace their own (re)sends, and catching up clients are fed in small steps
+	if (listener->HasPendingOutgoing())
+		waitTime = spring_msecs(loopSleepTime);
+
+	for (const RelayClient& client: clients) {
+		if (client.cacheCursor.IsActive()) {
+			waitTime = spring_msecs(loopSleepTime);
+			break;
+		}
+	}
+
+	waiter.Wait(now + waitTime);
+}
+
+
+void CSpectatorRelay::ReadUpstream()
+{
+	if (upstream->CheckTimeout(0, !joined)) {
+		Finish("Upstream server timed out");
+		return;
+	}
+
+	std::shared_ptr<const RawPacket> packet;
+
+	while (!finished && (packet = upstream->GetData()) != nullptr) {
+		HandleUpstreamPacket(packet);
+	}
+}
+
+void CSpectatorRelay::HandleUpstreamPacket(const std::shared_ptr<const RawPacket>& packet)
+{
+	if (packet->length <= 0)
+		return;
+
+	switch (packet->data[0]) {
+		case NETMSG_REJECT_CONNECT:
+		case NETMSG_QUIT: {
+			std::string reason = "Upstream server quit";
+
+			try {
+				netcode::UnpackPacket pckt(packet, 3);
+				pckt >> reason;
+			} catch (const netcode::UnpackPacketException& ex) {
+				LOG_L(L_WARNING, "[SpectatorRelay::%s] invalid quit message: %s", __func__, ex.what());
+			}
+
+			Finish(reason);
+			return;
+		}
+
+		case NETMSG_KEYFRAME: {
+			upstreamFrameNum = *reinterpret_cast<const int32_t*>(&packet->data[1]);
+
+			// the upstream measures our lag by these
+			upstream->SendData(CBaseNetProtocol::Get().SendKeyFrame(upstreamFrameNum));
+		} break;
+
+		case NETMSG_NEWFRAME: {
+			upstreamFrameNum += 1;
+		} break;
+
+		case NETMSG_GAME_FRAME_PROGRESS: {
+			// never cached, only interesting to clients catching up right now
+			for (RelayClient& client: clients) {
+				client.link->SendData(packet);
+			}
+		} return;
+
+		case NETMSG_PING: {
+			// answer to a ping of our own, clients get theirs from us
+		} return;
+
+		default: {
+		} break;
+	}
+
+	if (!joined) {
+		joinPackets.push_back(packet);
+
+		if (packet->data[0] == NETMSG_SETPLAYERNUM) {
+			joined = true;
+			LOG("[SpectatorRelay] joined upstream as player %u, accepting clients", unsigned(packet->data[1]));
+		}
+
+		return;
+	}
+
+	Broadcast(packet);
+}
+
+
+void CSpectatorRelay::HandleConnectionAttempts()
+{
+	while (listener->HasIncomingConnections()) {
+		std::shared_ptr<netcode::UDPConnection> prev = listener->PreviewConnection().lock();
+		std::shared_ptr<const RawPacket> packet = prev->GetData();
+
+		if (packet == nullptr) {
+			listener->RejectConnection();
+			continue;
+		}
+
+		try {
+			if (packet->length < 3)
+				throw netcode::UnpackPacketException("Packet too short");
+
+			if (packet->data[0] != NETMSG_ATTEMPTCONNECT)
+				throw netcode::UnpackPacketException("Invalid message ID");
+
+			netcode::UnpackPacket msg(packet, 3);
+			std::string name;
+			std::string passwd;
+			std::string version;
+			std::string platform;
+			uint8_t reconnect;
+			uint8_t netloss;
+			uint16_t netversion;
+			msg >> netversion;
+			msg >> name;
+			msg >> passwd;
+			msg >> version;
+			msg >> platform;
+			msg >> reconnect;
+			msg >> netloss;
+
+			if (netversion != NETWORK_VERSION)
+				throw netcode::UnpackPacketException(spring::format("Wrong network version: received %d, required %d", (int)netversion, (int)NETWORK_VERSION));
+
+			if (!clientPassword.empty() && passwd != clientPassword) {
+				RejectConnectionAttempt(prev, "Incorrect password");
+				continue;
+			}
+
+			BindClient(listener->AcceptConnection(), name, version, reconnect, netloss);
+		} catch (const netcode::UnpackPacketException& ex) {
+			RejectConnectionAttempt(prev, ex.what());
+		}
+	}
+}
+
+void CSpectatorRelay::RejectConnectionAttempt(const std::shared_ptr<netcode::UDPConnection>& link, const std::string& reason)
+{
+	const std::string msg = spring::format("Connection attempt rejected: %s", reason.c_str());
+
+	LOG_L(L_WARNING, "[SpectatorRelay::%s] %s from %s", __func__, msg.c_str(), link->GetFullAddress().c_str());
+
+	link->Unmute();
+	link->SendData(CBaseNetProtocol::Get().SendRejectConnect(msg));
+	link->Flush(true);
+
+	listener->RejectConnection();
+}
+
+void CSpectatorRelay::BindClient(
+	std::shared_ptr<netcode::UDPConnection> link,
+	const std::string& clientName,
+	const std::string& clientVersion,
+	bool reconnect,
+	int netloss
+) {
+	LOG("[SpectatorRelay] %s attempt from %s (%s)", (reconnect? "reconnection": "connection"), clientName.c_str(), link->GetFullAddress().c_str());
+
+	const auto pred = [&clientName](const RelayClient& c) { return (c.name == clientName); };
+	const auto iter = std::find_if(clients.begin(), clients.end(), pred);
+
+	if (reconnect) {
+		// never respond to a reconnection attempt we can not take, as in the server
+		if (iter == clients.end() || !iter->link->CanReconnect() || !iter->link->CheckTimeout(-1)) {
+			LOG("[SpectatorRelay]  -> user can not reconnect");
+			return;
+		}
+
+		iter->link->ReconnectTo(*link);
+		iter->link->SetLossFactor(netloss);
+		listener->UpdateConnections();
+
+		LOG("[SpectatorRelay]  -> connection reestablished");
+		return;
+	}
+
+	link->Unmute();
+
+	if (clientVersion != SpringVersion::GetSync()) {
+		LOG("[SpectatorRelay]  -> client version '%s' mismatch", clientVersion.c_str());
+
+		link->SendData(CBaseNetProtocol::Get().SendQuit(spring::format("Connection rejected: client version '%s' mismatch, relay is '%s'", clientVersion.c_str(), SpringVersion::GetSync().c_str())));
+		link->Flush(true);
+		return;
+	}
+
+	// same name on a new link, the old one is gone
+	if (iter != clients.end()) {
+		KillClient(*iter, "Terminating connection");
+		clients.erase(iter);
+	}
+
+	clients.emplace_back();
+
+	RelayClient& client = clients.back();
+	client.link = std::move(link);
+	client.name = clientName;
+
+	for (const std::shared_ptr<const RawPacket>& packet: joinPackets) {
+		client.link->SendData(packet);
+	}
+
+	client.cacheCursor.Start();
+
+	// before the game started the cache is small, send it right away
+	if (upstreamFrameNum == 0 || catchupRate <= 0) {
+		SendCachedPackets(client, size_t(-1));
+	} else {
+		SendCachedPackets(client, catchupRate / GAME_SPEED);
+	}
+
+	client.link->SetLossFactor(netloss);
+	client.link->Flush(upstreamFrameNum == 0);
+
+	LOG("[SpectatorRelay]  -> connection established (%u clients)", unsigned(clients.size()));
+}
+
+
+void CSpectatorRelay::ReadClients()
+{
+	bool haveSyncSource = false;
+
+	for (size_t i = 0; i < clients.size(); ) {
+		RelayClient& client = clients[i];
+
+		if (client.link->CheckTimeout(0, upstreamFrameNum == 0)) {
+			LOG("[SpectatorRelay] %s timed out", client.name.c_str());
+
+			KillClient(client, "User timeout");
+			clients.erase(clients.begin() + i);
+			continue;
+		}
+
+		std::shared_ptr<const RawPacket> packet;
+		bool quit = false;
+
+		while (!quit && (packet = client.link->GetData()) != nullptr) {
+			if (packet->length <= 0)
+				continue;
+
+			switch (packet->data[0]) {
+				case NETMSG_PING: {
+					// limit to 50 pings per second like the server
+					if (spring_diffmsecs(spring_now(), client.lastPingTime) >= 20) {
+						client.link->SendData(packet);
+						client.lastPingTime = spring_now();
+					}
+				} break;
+
+				case NETMSG_SYNCRESPONSE:
+				case NETMSG_SYNCLANES: {
+					if (client.isSyncSource)
+						upstream->SendData(packet);
+				} break;
+
+				case NETMSG_QUIT: {
+					quit = true;
+				} break;
+
+				default: {
+					// read-only, everything else stays here
+				} break;
+			}
+		}
+
+		if (quit) {
+			LOG("[SpectatorRelay] %s left", client.name.c_str());
+
+			client.link->Close(true);
+			clients.erase(clients.begin() + i);
+			continue;
+		}
+
+		haveSyncSource |= client.isSyncSource;
+		i++;
+	}
+
+	if (haveSyncSource)
+		return;
+
+	// only a client that runs the current frames can answer sync checks in time
+	for (RelayClient& client: clients) {
+		if (client.cacheCursor.IsActive())
+			continue;
+
+		client.isSyncSource = true;
+		break;
+	}
+}
+
+void CSpectatorRelay::UpdateCatchup()
+{
+	const spring_time curTime = spring_gettime();
+	const float timeElapsed = std::min((curTime - lastCatchupUpdate).toSecsf(), 1.0f);
+
+	lastCatchupUpdate = curTime;
+
+	for (RelayClient& client: clients) {
+		if (client.cacheCursor.IsActive())
+			SendCachedPackets(client, (catchupRate <= 0)? size_t(-1): size_t(catchupRate * timeElapsed));
+	}
+}
+
+void CSpectatorRelay::SendCachedPackets(RelayClient& client, size_t maxBytes)
+{
+	std::vector< std::shared_ptr<const RawPacket> > packets;
+
+	// once the cursor reaches the end this client gets live packets again
+	if (packetCache.Read(client.cacheCursor, maxBytes, packets))
+		client.cacheCursor.Stop();
+
+	for (const std::shared_ptr<const RawPacket>& packet: packets)
+		client.link->SendData(packet);
+}
+
+
+void CSpectatorRelay::Broadcast(const std::shared_ptr<const RawPacket>& packet)
+{
+	for (RelayClient& client: clients) {
+		// still catching up, gets this one from the cache
+		if (client.cacheCursor.IsActive())
+			continue;
+
+		client.link->SendData(packet);
+	}
+
+	packetCache.Add(*packet);
+}
+
+void CSpectatorRelay::KillClient(RelayClient& client, const std::string& reason)
+{
+	client.link->SendData(CBaseNetProtocol::Get().SendQuit(reason));
+	client.link->Close(true);
+}
+
+void CSpectatorRelay::Finish(const std::string& reason)
+{
+	LOG("[SpectatorRelay] finished: %s", reason.c_str());
+
+	for (RelayClient& client: clients) {
+		KillClient(client, reason);
+	}
+
+	clients.clear();
+
+	upstream->SendData(CBaseNetProtocol::Get().SendQuit("Relay shutdown"));
+	upstream->Close(true);
+
+	finished = true;
+}
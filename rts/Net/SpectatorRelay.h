@@ -0,0 +1,118 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _SPECTATOR_RELAY_H
+#define _SPECTATOR_RELAY_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "PacketCache.h"
+#include "System/Misc/NonCopyable.h"
+#include "System/Misc/SpringTime.h"
+#include "System/Net/EventWaiter.h"
+
+namespace netcode
+{
+	class RawPacket;
+	class UDPConnection;
+	class UDPListener;
+}
+
+/**
+ * @brief Takes spectators off a game server
+ * Joins an upstream server (or another relay) as a single spectator and
+ * hands everything it receives to its own clients, which connect to the
+ * relay exactly like they would to a server. Late joiners and reconnects
+ * are served from the relay's own packet cache, so the upstream host only
+ * pays for one connection no matter how many clients hang off the relay.
+ * Relays can be chained into a tree since they answer connection attempts
+ * the same way a server does.
+ *
+ * All clients share the player number of the relay and are read-only: their
+ * chat and commands are dropped. Sync responses of one caught-up client are
+ * forwarded upstream in the relay's name. If a client password is set, only
+ * clients that join with it are let in.
+ */
+class CSpectatorRelay : spring::noncopyable
+{
+public:
+	CSpectatorRelay(
+		const std::string& upstreamHost,
+		int upstreamPort,
+		const std::string& listenIP,
+		int listenPort,
+		const std::string& relayName,
+		const std::string& relayPassword,
+		const std::string& clientPassword
+	);
+	~CSpectatorRelay();
+
+	/// waits for network events and handles them, call until HasFinished
+	void Update();
+
+	bool HasFinished() const { return finished; }
+
+	size_t GetNumClients() const { return clients.size(); }
+
+private:
+	struct RelayClient {
+		std::shared_ptr<netcode::UDPConnection> link;
+		std::string name;
+
+		PacketCache::Cursor cacheCursor;
+		spring_time lastPingTime;
+
+		/// sync responses of this client are sent upstream
+		bool isSyncSource = false;
+	};
+
+	void WaitForEvents();
+
+	void ReadUpstream();
+	void HandleUpstreamPacket(const std::shared_ptr<const netcode::RawPacket>& packet);
+
+	void HandleConnectionAttempts();
+	void RejectConnectionAttempt(const std::shared_ptr<netcode::UDPConnection>& link, const std::string& reason);
+	void BindClient(std::shared_ptr<netcode::UDPConnection> link, const std::string& clientName, const std::string& clientVersion, bool reconnect, int netloss);
+
+	void ReadClients();
+	void UpdateCatchup();
+	void SendCachedPackets(RelayClient& client, size_t maxBytes);
+
+	void Broadcast(const std::shared_ptr<const netcode::RawPacket>& packet);
+	void KillClient(RelayClient& client, const std::string& reason);
+	void Finish(const std::string& reason);
+
+private:
+	// listener socket lives on its context, declared first
+	netcode::EventWaiter waiter;
+
+	std::unique_ptr<netcode::UDPListener> listener;
+	/// shares the listener socket, so the waiter sees upstream traffic too
+	std::shared_ptr<netcode::UDPConnection> upstream;
+
+	std::string relayName;
+	std::string relayPassword;
+	/// what downstream clients have to join with, empty to let anyone in
+	std::string clientPassword;
+
+	/// everything the upstream sent up to and including NETMSG_SETPLAYERNUM
+	std::vector< std::shared_ptr<const netcode::RawPacket> > joinPackets;
+	/// everything it sent afterwards
+	PacketCache packetCache;
+
+	std::vector<RelayClient> clients;
+
+	int upstreamFrameNum = 0;
+	int catchupRate = 0;
+	int loopSleepTime = 0;
+	int loopIdleWaitTime = 0;
+
+	spring_time lastCatchupUpdate;
+
+	bool joined = false;
+	bool finished = false;
+};
+
+#endif // _SPECTATOR_RELAY_H
@@ -60,6 +60,7 @@
 
 CONFIG(int, GroundScarAlphaFade).deprecated(true);
 CONFIG(bool, HighQualityDecals).defaultValue(false).description("Forces MSAA processing of decals. Improves decals quality, but may ruin the performance.");
+CONFIG(int, MaxTrackDecals).defaultValue(1 << 15).minimumValue(0).description("Maximum number of unit track decals kept alive, the oldest ones are evicted first once exceeded. 0 means no limit.");
 
 
 CR_BIND(CGroundDecalHandler::UnitMinMaxHeight, )
@@ -73,12 +74,14 @@ CR_BIND(CGroundDecalHandler::DecalUpdateList, )
 CR_REG_METADATA_SUB(CGroundDecalHandler, DecalUpdateList,
 (
 	CR_MEMBER(updateList),
+	CR_IGNORED(dirtyBlocks),
 	CR_MEMBER(changed)
 ))
 
 CR_BIND_DERIVED(CGroundDecalHandler, IGroundDecalDrawer, )
 CR_REG_METADATA(CGroundDecalHandler, (
 	CR_MEMBER_UN(maxUniqueScars),
+	CR_MEMBER_UN(maxTrackDecals),
 	CR_MEMBER_UN(atlasMain),
 	CR_MEMBER_UN(atlasNorm),
 	CR_MEMBER_UN(decalShader),
@@ -106,6 +109,7 @@ CR_REG_METADATA(CGroundDecalHandler, (
 CGroundDecalHandler::CGroundDecalHandler()
 	: CEventClient("[CGroundDecalHandler]", 314159, false)
 	, maxUniqueScars{ 0 }
+	, maxTrackDecals{ configHandler->GetInt("MaxTrackDecals") }
 	, atlasMain{ nullptr }
 	, atlasNorm{ nullptr }
 	, decalShader{ nullptr }
@@ -1358,7 +1362,7 @@ void CGroundDecalHandler::AddTrack(const CUnit* unit, const float3& newPos, bool
 	// replace the old entry
 	decalOwners[unit] = decals.size() - 1;
 
-	idToPos[newDecal.info.id], decals.size() - 1;
+	idToPos[newDecal.info.id] = decals.size() - 1;
 	decalsUpdateList.EmplaceBackUpdate();
 }
 
@@ -1376,6 +1380,7 @@ void CGroundDecalHandler::CompactDecalsVector(int frameNum)
 		return;
 
 	size_t numToDelete = 0;
+	size_t numTracks = 0;
 	for (auto& decal : decals) {
 		if (!decal.IsValid()) {
 			numToDelete++;
@@ -1385,9 +1390,15 @@ void CGroundDecalHandler::CompactDecalsVector(int frameNum)
 		if (decal.info.type != static_cast<uint8_t>(GroundDecal::Type::DECAL_LUA) && frameNum - decal.createFrameMax > targetExpirationFrame) {
 			decal.MarkInvalid();
 			numToDelete++;
+			continue;
 		}
+
+		numTracks += (decal.info.type == static_cast<uint8_t>(GroundDecal::Type::DECAL_TRACK));
 	}
 
+	if (maxTrackDecals > 0 && numTracks > static_cast<size_t>(maxTrackDecals))
+		numToDelete += EvictOldestTracks(maxTrackDecals);
+
 	if (numToDelete == 0)
 		return;
 
@@ -1479,6 +1490,45 @@ void CGroundDecalHandler::CompactDecalsVector(int frameNum)
 #endif
 }
 
+size_t CGroundDecalHandler::EvictOldestTracks(size_t maxNumTracks)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	std::vector<float> trackFrames;
+
+	for (const auto& decal : decals) {
+		if (decal.info.type != static_cast<uint8_t>(GroundDecal::Type::DECAL_TRACK))
+			continue;
+
+		trackFrames.push_back(decal.createFrameMax);
+	}
+
+	if (trackFrames.size() <= maxNumTracks)
+		return 0;
+
+	// find the last-extended frame of the newest track that has to go;
+	// tracks still being extended by a moving unit are never that old
+	const size_t numToEvict = trackFrames.size() - maxNumTracks;
+	std::nth_element(trackFrames.begin(), trackFrames.begin() + (numToEvict - 1), trackFrames.end());
+	const float cutoffFrame = trackFrames[numToEvict - 1];
+
+	size_t numEvicted = 0;
+	for (auto& decal : decals) {
+		if (numEvicted == numToEvict)
+			break;
+
+		if (decal.info.type != static_cast<uint8_t>(GroundDecal::Type::DECAL_TRACK))
+			continue;
+
+		if (decal.createFrameMax > cutoffFrame)
+			continue;
+
+		decal.MarkInvalid();
+		numEvicted++;
+	}
+
+	return numEvicted;
+}
+
 void CGroundDecalHandler::UpdateDecalsVisibility()
 {
 	RECOIL_DETAILED_TRACY_ZONE;
@@ -1680,21 +1730,43 @@ void CGroundDecalHandler::UnitMoved(const CUnit* unit) { AddTrack(unit, unit->po
 void CGroundDecalHandler::DecalUpdateList::SetNeedUpdateAll()
 {
 	RECOIL_DETAILED_TRACY_ZONE;
+	// dirtyBlocks is not serialized, (re)size it here as well
+	dirtyBlocks.resize(NumBlocks(updateList.size()));
+
 	std::fill(updateList.begin(), updateList.end(), true);
+	std::fill(dirtyBlocks.begin(), dirtyBlocks.end(), true);
 	changed = true;
 }
 
 void CGroundDecalHandler::DecalUpdateList::ResetNeedUpdateAll()
 {
 	RECOIL_DETAILED_TRACY_ZONE;
-	std::fill(updateList.begin(), updateList.end(), false);
+	for (size_t blk = 0, n = dirtyBlocks.size(); blk < n; ++blk) {
+		if (!dirtyBlocks[blk])
+			continue;
+
+		const auto blkBeg = updateList.begin() + blk * BLOCK_SIZE;
+		const auto blkEnd = updateList.begin() + std::min((blk + 1) * BLOCK_SIZE, updateList.size());
+
+		std::fill(blkBeg, blkEnd, false);
+		dirtyBlocks[blk] = false;
+	}
+
 	changed = false;
 }
 
 void CGroundDecalHandler::DecalUpdateList::SetUpdate(const CGroundDecalHandler::DecalUpdateList::IteratorPair& it)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
+	if (it.first == it.second)
+		return;
+
 	std::fill(it.first, it.second, true);
+
+	const size_t begBlk = std::distance(updateList.begin(), it.first) / BLOCK_SIZE;
+	const size_t endBlk = (std::distance(updateList.begin(), it.second) - 1) / BLOCK_SIZE;
+
+	std::fill(dirtyBlocks.begin() + begBlk, dirtyBlocks.begin() + endBlk + 1, true);
 	changed = true;
 }
 
@@ -1703,6 +1775,7 @@ void CGroundDecalHandler::DecalUpdateList::SetUpdate(size_t offset)
 	RECOIL_DETAILED_TRACY_ZONE;
 	assert(offset < updateList.size());
 	updateList[offset] = true;
+	SetBlockDirty(offset);
 	changed = true;
 }
 
@@ -1710,20 +1783,41 @@ void CGroundDecalHandler::DecalUpdateList::EmplaceBackUpdate()
 {
 	RECOIL_DETAILED_TRACY_ZONE;
 	updateList.emplace_back(true);
+	dirtyBlocks.resize(NumBlocks(updateList.size()));
+	SetBlockDirty(updateList.size() - 1);
 	changed = true;
 }
 
 std::optional<CGroundDecalHandler::DecalUpdateList::IteratorPair> CGroundDecalHandler::DecalUpdateList::GetNext(const std::optional<CGroundDecalHandler::DecalUpdateList::IteratorPair>& prev)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
-	auto beg = prev.has_value() ? prev.value().second : updateList.begin();
-	     beg = std::find(beg, updateList.end(),  true);
-	auto end = std::find(beg, updateList.end(), false);
+	size_t idx = prev.has_value() ? std::distance(updateList.begin(), prev.value().second) : 0;
 
-	if (beg == end)
-		return std::nullopt;
+	while (idx < updateList.size()) {
+		const size_t blk = idx / BLOCK_SIZE;
+		const size_t blkEndIdx = std::min((blk + 1) * BLOCK_SIZE, updateList.size());
+
+		// every pending entry lives in a dirty block, skip the clean ones
+		if (!dirtyBlocks[blk]) {
+			idx = blkEndIdx;
+			continue;
+		}
+
+		const auto blkEnd = updateList.begin() + blkEndIdx;
+		const auto beg = std::find(updateList.begin() + idx, blkEnd, true);
+
+		if (beg == blkEnd) {
+			idx = blkEndIdx;
+			continue;
+		}
+
+		// a run may continue into the next block, which is then dirty too
+		const auto end = std::find(beg, updateList.end(), false);
+
+		return std::make_optional(std::make_pair(beg, end));
+	}
 
-	return std::make_optional(std::make_pair(beg, end));
+	return std::nullopt;
 }
 
 std::pair<size_t, size_t> CGroundDecalHandler::DecalUpdateList::GetOffsetAndSize(const CGroundDecalHandler::DecalUpdateList::IteratorPair& it)
@@ -45,11 +45,12 @@ public:
 	public:
 		DecalUpdateList()
 			: updateList()
+			, dirtyBlocks()
 			, changed(true)
 		{}
 
 		void Resize(size_t newSize) { updateList.resize(newSize); SetNeedUpdateAll(); }
-		void Reserve(size_t reservedSize) { updateList.reserve(reservedSize); }
+		void Reserve(size_t reservedSize) { updateList.reserve(reservedSize); dirtyBlocks.reserve(NumBlocks(reservedSize)); }
 
 		void SetUpdate(const IteratorPair& it);
 		void SetUpdate(size_t offset);
@@ -63,8 +64,16 @@ public:
 
 		std::optional<IteratorPair> GetNext(const std::optional<IteratorPair>& prev = std::nullopt);
 		std::pair<size_t, size_t> GetOffsetAndSize(const IteratorPair& it);
+	private:
+		// updateList is split into blocks of this many entries, so GetNext and
+		// ResetNeedUpdateAll only have to visit blocks with pending updates
+		static constexpr size_t BLOCK_SIZE = 1024;
+		static constexpr size_t NumBlocks(size_t size) { return ((size + BLOCK_SIZE - 1) / BLOCK_SIZE); }
+
+		void SetBlockDirty(size_t offset) { dirtyBlocks[offset / BLOCK_SIZE] = true; }
 	private:
 		std::vector<bool> updateList;
+		std::vector<bool> dirtyBlocks;
 		bool changed;
 	};
 public:
@@ -163,6 +172,7 @@ private:
 	void RemoveSolidObject(const CSolidObject* object, const GhostSolidObject* gb);
 
 	void CompactDecalsVector(int frameNum);
+	size_t EvictOldestTracks(size_t maxNumTracks);
 
 	void UpdateDecalsVisibility();
 
@@ -183,6 +193,7 @@ private:
 		float max;
 	};
 	int maxUniqueScars;
+	int maxTrackDecals;
 
 	std::unique_ptr<CTextureRenderAtlas> atlasMain;
 	std::unique_ptr<CTextureRenderAtlas> atlasNorm;
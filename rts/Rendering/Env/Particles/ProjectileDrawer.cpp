@@ -3,8 +3,8 @@
 
 #include "ProjectileDrawer.h"
 
-#include <tuple>
 #include <bit>
+#include <utility>
 
 #include "Game/Camera.h"
 #include "Game/CameraHandler.h"
@@ -45,14 +45,55 @@
 
 CONFIG(int, SoftParticles).defaultValue(1).safemodeValue(0).description("Soften up CEG particles on clipping edges");
 
-static uint32_t sortCamType = 0;
-static bool CProjectileDrawOrderSortingPredicate(const CProjectile* p1, const CProjectile* p2) noexcept {
-	return std::forward_as_tuple(p2->drawOrder, p1->GetSortDist(sortCamType), p1) > std::forward_as_tuple(p1->drawOrder, p2->GetSortDist(sortCamType), p2);
+// maps a float onto an unsigned integer with the same ordering
+static inline uint32_t FloatToSortableBits(float f) {
+	const uint32_t u = std::bit_cast<uint32_t>(f);
+	return (u & 0x80000000u)? ~u: (u | 0x80000000u);
 }
 
-static bool CProjectileSortingPredicate(const CProjectile* p1, const CProjectile* p2) noexcept {
-	return std::forward_as_tuple(p1->GetSortDist(sortCamType), p1) > std::forward_as_tuple(p2->GetSortDist(sortCamType), p2);
-};
+// ascending drawOrder (if wanted) first, then back-to-front by sort-distance
+static inline uint64_t GetProjectileSortKey(const CProjectile* p, uint32_t camType, bool useDrawOrder) {
+	const uint64_t orderBits = static_cast<uint32_t>(p->drawOrder) ^ 0x80000000u;
+	const uint64_t distBits = ~FloatToSortableBits(p->GetSortDist(camType));
+
+	return ((orderBits * useDrawOrder) << 32) | distBits;
+}
+
+// stable LSD radix sort on 8-bit digits; digits shared by all keys (e.g.
+// the drawOrder half when it is unused or constant) cost a single count
+template<typename T>
+static void RadixSortByKey(std::vector<std::pair<uint64_t, T>>& items, std::vector<std::pair<uint64_t, T>>& temp) {
+	static constexpr uint32_t NUM_DIGITS = sizeof(uint64_t);
+
+	std::array<std::array<uint32_t, 256>, NUM_DIGITS> counts = {};
+
+	for (const auto& item: items) {
+		for (uint32_t d = 0; d < NUM_DIGITS; d++) {
+			counts[d][(item.first >> (d * 8)) & 0xFF]++;
+		}
+	}
+
+	temp.resize(items.size());
+
+	for (uint32_t d = 0; d < NUM_DIGITS; d++) {
+		auto& digitCounts = counts[d];
+
+		if (digitCounts[(items[0].first >> (d * 8)) & 0xFF] == items.size())
+			continue;
+
+		for (uint32_t i = 0, sum = 0; i < digitCounts.size(); i++) {
+			const uint32_t cnt = digitCounts[i];
+			digitCounts[i] = sum;
+			sum += cnt;
+		}
+
+		for (const auto& item: items) {
+			temp[digitCounts[(item.first >> (d * 8)) & 0xFF]++] = item;
+		}
+
+		std::swap(items, temp);
+	}
+}
 
 CProjectileDrawer* projectileDrawer = nullptr;
 
@@ -737,6 +778,27 @@ void CProjectileDrawer::DrawOpaque(bool drawReflection, bool drawRefraction)
 	glDisable(GL_FOG);
 }
 
+void CProjectileDrawer::SortDrawParticles(uint32_t camType)
+{
+	auto& sortedParticles = drawParticles[true];
+
+	if (sortedParticles.size() <= 1)
+		return;
+
+	sortKeys.resize(sortedParticles.size());
+
+	// key generation touches every projectile, do it in parallel
+	for_mt(0, sortedParticles.size(), [&](int i) {
+		sortKeys[i] = {GetProjectileSortKey(sortedParticles[i], camType, wantDrawOrder), sortedParticles[i]};
+	});
+
+	RadixSortByKey(sortKeys, sortKeysTemp);
+
+	for (size_t i = 0, n = sortKeys.size(); i < n; i++) {
+		sortedParticles[i] = sortKeys[i].second;
+	}
+}
+
 void CProjectileDrawer::DrawAlpha(bool drawAboveWater, bool drawBelowWater, bool drawReflection, bool drawRefraction)
 {
 	ZoneScopedN("ProjectileDrawer::DrawAlpha");
@@ -767,15 +829,9 @@ void CProjectileDrawer::DrawAlpha(bool drawAboveWater, bool drawBelowWater, bool
 		}
 	}
 
-	// set static variable to facilite sorting
-	sortCamType = camera->GetCamType();
-
 	{
 		ZoneScopedN("ProjectileDrawer::DrawAlpha(SO)");
-		if (wantDrawOrder)
-			std::sort(drawParticles[true].begin(), drawParticles[true].end(), CProjectileDrawOrderSortingPredicate);
-		else
-			std::sort(drawParticles[true].begin(), drawParticles[true].end(), CProjectileSortingPredicate);
+		SortDrawParticles(camera->GetCamType());
 	}
 
 	{
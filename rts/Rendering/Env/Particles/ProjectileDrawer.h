@@ -134,6 +134,8 @@ private:
 	void DrawProjectilesShadow(int modelType);
 	void DrawFlyingPieces(int modelType) const;
 
+	void SortDrawParticles(uint32_t camType);
+
 	static void DrawProjectileModel(const CProjectile* projectile);
 
 	void UpdatePerlin();
@@ -167,6 +169,10 @@ private:
 	/// used to render particle effects in back-to-front order. {unsorted, sorted}
 	std::array<std::vector<CProjectile*>, 2> drawParticles;
 
+	/// (key, projectile) scratch buffers for SortDrawParticles
+	std::vector<std::pair<uint64_t, CProjectile*>> sortKeys;
+	std::vector<std::pair<uint64_t, CProjectile*>> sortKeysTemp;
+
 	bool drawSorted = true;
 
 	std::array<Shader::IProgramObject*, 2> fxShaders = { nullptr };
@@ -16,6 +16,7 @@
 #endif
 
 #include "Bitmap.h"
+#include "BitmapCache.h"
 #include "Rendering/GL/myGL.h"
 #include "Rendering/GL/TexBind.h"
 #include "System/ScopedFPUSettings.h"
@@ -1297,6 +1298,10 @@ bool CBitmap::Load(std::string const& filename, float defaultAlpha, uint32_t req
 		buffer = std::move(file.GetBuffer());
 	}
 
+	const uint64_t cacheKey = BitmapCache::IsEnabled()? BitmapCache::GetKey(buffer, defaultAlpha, reqChannel, reqDataType, forceReplaceAlpha): 0;
+
+	if (cacheKey != 0 && LoadCached(cacheKey, curMemSize))
+		return true;
 
 	{
 		std::scoped_lock lck(ITexMemPool::texMemPool->GetMutex());
@@ -1418,6 +1423,44 @@ bool CBitmap::Load(std::string const& filename, float defaultAlpha, uint32_t req
 	if (!hasAlpha || forceReplaceAlpha)
 		ReplaceAlpha(defaultAlpha);
 
+	if (cacheKey != 0)
+		BitmapCache::Write(cacheKey, xsize, ysize, channels, dataType, GetRawMem(), GetMemSize());
+
+	return true;
+}
+
+bool CBitmap::LoadCached(uint64_t cacheKey, size_t curMemSize)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	BitmapCache::Header header;
+	std::vector<uint8_t> pixels;
+
+	if (!BitmapCache::Read(cacheKey, header, pixels))
+		return false;
+
+	const size_t memSize = size_t(header.xsize) * header.ysize * header.channels * GetDataTypeSize(header.dataType);
+
+	if (memSize != pixels.size()) {
+		// would miss again on every load, let the decode path rewrite it
+		BitmapCache::Remove(cacheKey);
+		return false;
+	}
+
+	{
+		// no libIL involvement here, only the pool itself needs protection
+		std::scoped_lock lck(ITexMemPool::texMemPool->GetMutex());
+
+		ITexMemPool::texMemPool->FreeRaw(GetRawMem(), curMemSize);
+
+		xsize = header.xsize;
+		ysize = header.ysize;
+		channels = header.channels;
+		dataType = header.dataType;
+		memIdx = ITexMemPool::texMemPool->AllocIdxRaw(GetMemSize());
+
+		std::memcpy(GetRawMem(), pixels.data(), GetMemSize());
+	}
+
 	return true;
 }
 
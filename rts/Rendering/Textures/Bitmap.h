@@ -104,6 +104,10 @@ public:
 
 	size_t GetMemSize() const { return (xsize * ysize * channels * GetDataTypeSize()); }
 
+private:
+	/// fill from the decoded-image disk cache, see BitmapCache.h
+	bool LoadCached(uint64_t cacheKey, size_t curMemSize);
+
 private:
 	// managed by pool
 	size_t memIdx = size_t(-1);
@@ -0,0 +1,203 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <zlib.h>
+
+#include "BitmapCache.h"
+#include "Rendering/GL/myGL.h"
+#include "System/SpringHash.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/FileSystem/CacheDirLimiter.h"
+#include "System/FileSystem/DataDirsAccess.h"
+#include "System/FileSystem/FileQueryFlags.h"
+#include "System/FileSystem/FileSystem.h"
+#include "System/Log/ILog.h"
+
+#include "System/Misc/TracyDefs.h"
+
+CONFIG(bool, TextureDecodeCache).defaultValue(true).description("Keep decoded unit, feature and map textures in the cache directory to skip image decoding on subsequent launches.");
+CONFIG(int, TextureDecodeCacheSize).defaultValue(1024).minimumValue(16).description("Size limit of the texture decode cache in megabytes; the least recently used entries are deleted when it is exceeded.");
+
+static constexpr uint32_t BITMAP_CACHE_MAGIC   = 0x43504D42; // "BMPC"
+static constexpr uint32_t BITMAP_CACHE_VERSION = 2;
+
+// larger images are not cached, keeps rawSize within the header field
+static constexpr size_t MAX_CACHED_IMAGE_SIZE = 1u << 30;
+
+
+static const std::string& GetBitmapCacheDir()
+{
+	// LocateDir is not cheap and this is called from multiple preload threads
+	static const std::string cacheDir = dataDirsAccess.LocateDir(
+		FileSystem::GetCacheDir() + FileSystemAbstraction::GetNativePathSeparator() + "textures" + FileSystemAbstraction::GetNativePathSeparator(),
+		FileQueryFlags::WRITE | FileQueryFlags::CREATE_DIRS
+	);
+
+	return cacheDir;
+}
+
+static std::string GetBitmapCacheFileName(uint64_t key)
+{
+	char buf[32];
+	std::snprintf(buf, sizeof(buf), "%016llx.bmc", static_cast<unsigned long long>(key));
+	return (FileSystem::EnsurePathSepAtEnd(GetBitmapCacheDir()) + buf);
+}
+
+static uint64_t GetCacheSizeLimit()
+{
+	static const uint64_t limit = uint64_t(configHandler->GetInt("TextureDecodeCacheSize")) * 1024 * 1024;
+	return limit;
+}
+
+
+static CCacheDirLimiter cacheLimiter("BitmapCache", ".bmc");
+
+static bool IsValidDataType(uint32_t dataType)
+{
+	// the types CBitmap::GetDataTypeSize knows, it asserts on anything else
+	switch (dataType) {
+		case GL_FLOAT         : [[fallthrough]];
+		case GL_INT           : [[fallthrough]];
+		case GL_UNSIGNED_INT  : [[fallthrough]];
+		case GL_SHORT         : [[fallthrough]];
+		case GL_UNSIGNED_SHORT: [[fallthrough]];
+		case GL_BYTE          : [[fallthrough]];
+		case GL_UNSIGNED_BYTE : return true;
+		default               : break;
+	}
+
+	return false;
+}
+
+
+bool BitmapCache::IsEnabled()
+{
+	static const bool enabled = (configHandler != nullptr && configHandler->GetBool("TextureDecodeCache"));
+	return enabled;
+}
+
+uint64_t BitmapCache::GetKey(const std::vector<uint8_t>& fileData, float defaultAlpha, uint32_t reqChannel, uint32_t reqDataType, bool forceReplaceAlpha)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	struct {
+		float defaultAlpha;
+		uint32_t reqChannel;
+		uint32_t reqDataType;
+		uint32_t forceReplaceAlpha;
+	} params = {defaultAlpha, reqChannel, reqDataType, forceReplaceAlpha};
+
+	const uint64_t seed = XXH3_64bits(&params, sizeof(params));
+	const uint64_t key = XXH3_64bits_withSeed(fileData.data(), fileData.size(), seed);
+
+	// zero is reserved for "no key"
+	return (key + (key == 0));
+}
+
+bool BitmapCache::Read(uint64_t key, Header& header, std::vector<uint8_t>& pixels)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	const std::string fileName = GetBitmapCacheFileName(key);
+
+	FILE* file = std::fopen(fileName.c_str(), "rb");
+
+	if (file == nullptr)
+		return false;
+
+	std::vector<uint8_t> packedData;
+
+	bool valid = (std::fread(&header, sizeof(header), 1, file) == 1);
+
+	valid = valid && (header.magic == BITMAP_CACHE_MAGIC);
+	valid = valid && (header.version == BITMAP_CACHE_VERSION);
+	valid = valid && (header.key == key);
+	valid = valid && (header.xsize > 0 && header.ysize > 0);
+	valid = valid && (header.channels > 0 && header.channels <= 4);
+	valid = valid && IsValidDataType(header.dataType);
+	valid = valid && (header.rawSize > 0 && header.rawSize <= MAX_CACHED_IMAGE_SIZE);
+	valid = valid && (header.packedSize > 0);
+
+	if (valid) {
+		packedData.resize(header.packedSize);
+
+		valid = (std::fread(packedData.data(), packedData.size(), 1, file) == 1);
+		// anything after the packed data means the entry was not written by us
+		valid = valid && (std::fgetc(file) == EOF);
+	}
+
+	std::fclose(file);
+
+	if (valid) {
+		// whether rawSize matches the dimensions is checked by the caller
+		uLongf rawSize = header.rawSize;
+
+		pixels.resize(header.rawSize);
+
+		valid = (uncompress(pixels.data(), &rawSize, packedData.data(), packedData.size()) == Z_OK);
+		valid = valid && (rawSize == header.rawSize);
+	}
+
+	if (!valid) {
+		LOG_L(L_WARNING, "[BitmapCache::%s] removing corrupt entry \"%s\"", __func__, fileName.c_str());
+		FileSystem::Remove(fileName);
+		return false;
+	}
+
+	// reads count as uses for eviction
+	CCacheDirLimiter::Touch(fileName);
+	return true;
+}
+
+bool BitmapCache::Write(uint64_t key, int32_t xsize, int32_t ysize, int32_t channels, uint32_t dataType, const uint8_t* pixels, size_t size)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	static std::atomic<uint32_t> tmpFileCounter = {0};
+
+	if (size == 0 || size > MAX_CACHED_IMAGE_SIZE)
+		return false;
+
+	// favor decompression speed, a hit has to beat decoding the original
+	std::vector<uint8_t> packedData(compressBound(size));
+	uLongf packedSize = packedData.size();
+
+	if (compress2(packedData.data(), &packedSize, pixels, size, Z_BEST_SPEED) != Z_OK)
+		return false;
+
+	const Header header = {BITMAP_CACHE_MAGIC, BITMAP_CACHE_VERSION, key, xsize, ysize, channels, dataType, uint32_t(size), uint32_t(packedSize)};
+
+	const std::string fileName = GetBitmapCacheFileName(key);
+	// several preload threads can decode the same image, write to a unique
+	// temporary and rename so readers never observe a partial entry
+	const std::string tempName = fileName + "." + std::to_string(tmpFileCounter.fetch_add(1)) + ".tmp";
+
+	FILE* file = std::fopen(tempName.c_str(), "wb");
+
+	if (file == nullptr)
+		return false;
+
+	bool written = true;
+
+	written = written && (std::fwrite(&header, sizeof(header), 1, file) == 1);
+	written = written && (std::fwrite(packedData.data(), packedSize, 1, file) == 1);
+	written = (std::fclose(file) == 0) && written;
+	written = written && (std::rename(tempName.c_str(), fileName.c_str()) == 0);
+
+	if (!written) {
+		std::remove(tempName.c_str());
+		return false;
+	}
+
+	cacheLimiter.AddEntry(GetBitmapCacheDir(), sizeof(header) + packedSize, GetCacheSizeLimit());
+	return true;
+}
+
+void BitmapCache::Remove(uint64_t key)
+{
+	const std::string fileName = GetBitmapCacheFileName(key);
+
+	LOG_L(L_WARNING, "[BitmapCache::%s] removing unusable entry \"%s\"", __func__, fileName.c_str());
+	FileSystem::Remove(fileName);
+}
@@ -0,0 +1,50 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _BITMAP_CACHE_H
+#define _BITMAP_CACHE_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * On-disk cache of decoded images, stored as deflated pixel dumps under
+ * <CacheDir>/textures/. Entries are keyed by a hash over the encoded
+ * file contents and the conversion parameters passed to CBitmap::Load,
+ * so a hit lets Load skip libIL (and its global lock) altogether.
+ * Since the engine cache-dir is already versioned, stale entries from
+ * older builds are never picked up.
+ *
+ * The directory is capped at TextureDecodeCacheSize megabytes; reads
+ * refresh an entry's modification time and the least recently used
+ * entries are deleted once a write pushes the total over the cap.
+ *
+ * Only the base level that CBitmap holds is stored; mipmaps and any block
+ * compression are still produced when the texture is uploaded.
+ */
+namespace BitmapCache {
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint64_t key;
+
+		int32_t xsize;
+		int32_t ysize;
+		int32_t channels;
+		uint32_t dataType;
+
+		uint32_t rawSize;
+		uint32_t packedSize;
+	};
+
+	bool IsEnabled();
+
+	uint64_t GetKey(const std::vector<uint8_t>& fileData, float defaultAlpha, uint32_t reqChannel, uint32_t reqDataType, bool forceReplaceAlpha);
+
+	/// returns false on a miss or if the entry is truncated or corrupt
+	bool Read(uint64_t key, Header& header, std::vector<uint8_t>& pixels);
+	bool Write(uint64_t key, int32_t xsize, int32_t ysize, int32_t channels, uint32_t dataType, const uint8_t* pixels, size_t size);
+	/// deletes an entry Read returned but the caller could not use
+	void Remove(uint64_t key);
+}
+
+#endif // _BITMAP_CACHE_H
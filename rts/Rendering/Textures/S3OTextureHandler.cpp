@@ -17,6 +17,7 @@
 #include "System/Platform/Threading.h"
 
 #include <algorithm>
+#include <array>
 #include <cctype>
 #include <set>
 #include <sstream>
@@ -93,11 +94,61 @@ void CS3OTextureHandler::Reload()
 }
 
 
+static void LoadTextureBitmap(CBitmap& bitmap, const S3DModel* model, unsigned int texNum, bool invertAxis, bool invertAlpha)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	const auto& textureName = model->texs[texNum];
+
+	if (!bitmap.Load(textureName) && !bitmap.Load("unittextures/" + textureName)) {
+		if (texNum == 0)
+			LOG_L(L_WARNING, "[%s] could not load primary texture \"%s\" from model \"%s\"", __func__, textureName.c_str(), model->name.c_str());
+
+		// file not found (or headless build), set a single pixel so model is visible
+		bitmap.AllocDummy(SColor(255 * (texNum == 0), 0, 0, 255 * (1 - invertAlpha)));
+	}
+
+	if (invertAxis)
+		bitmap.ReverseYAxis();
+	if (invertAlpha)
+		bitmap.InvertAlpha();
+}
+
+
 void CS3OTextureHandler::PreloadTexture(S3DModel* model, bool invertAxis, bool invertAlpha)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
+	// PreloadTexture runs on the model-preload workers; decode outside of the
+	// models-lock so those do not serialize on image decoding. Two workers can
+	// race to decode the same texture, in which case the first insert wins.
+	std::array<CBitmap, 2> bitmaps;
+	std::array<bool, 2> decoded = {false, false};
+
+	for (unsigned int texNum = 0; texNum < 2; texNum++) {
+		{
+			auto lock = CModelsLock::GetScopedLock();
+
+			if (textureCache.find(model->texs[texNum]) != textureCache.end())
+				continue;
+			if (bitmapCache.find(model->texs[texNum]) != bitmapCache.end())
+				continue;
+		}
+
+		// never invert alpha for tex2
+		LoadTextureBitmap(bitmaps[texNum], model, texNum, invertAxis, invertAlpha && (texNum == 0));
+		decoded[texNum] = true;
+	}
+
 	auto lock = CModelsLock::GetScopedLock();
 
+	for (unsigned int texNum = 0; texNum < 2; texNum++) {
+		if (!decoded[texNum])
+			continue;
+		if (textureCache.find(model->texs[texNum]) != textureCache.end())
+			continue;
+
+		bitmapCache.emplace(model->texs[texNum], std::move(bitmaps[texNum]));
+	}
+
 	LoadAndCacheTexture(model, 0, invertAxis, invertAlpha, true);
 	LoadAndCacheTexture(model, 1, invertAxis,       false, true); // never invert alpha for tex2
 }
@@ -158,18 +209,7 @@ unsigned int CS3OTextureHandler::LoadAndCacheTexture(
 
 		bitmap = &(iter->second);
 
-		if (!bitmap->Load(textureName) && !bitmap->Load("unittextures/" + textureName)) {
-			if (texNum == 0)
-				LOG_L(L_WARNING, "[%s] could not load primary texture \"%s\" from model \"%s\"", __func__, textureName.c_str(), model->name.c_str());
-
-			// file not found (or headless build), set a single pixel so model is visible
-			bitmap->AllocDummy(SColor(255 * (texNum == 0), 0, 0, 255 * (1 - invertAlpha)));
-		}
-
-		if (invertAxis)
-			bitmap->ReverseYAxis();
-		if (invertAlpha)
-			bitmap->InvertAlpha();
+		LoadTextureBitmap(*bitmap, model, texNum, invertAxis, invertAlpha);
 	}
 
 	const unsigned int texID = preloadCall ? 0 : bitmap->CreateMipMapTexture();
@@ -38,7 +38,7 @@ CR_BIND(CGlobalSynced, )
 CR_REG_METADATA(CGlobalSynced, (
 	CR_MEMBER(frameNum),
 	CR_MEMBER(tempNum),
-	CR_MEMBER(mtTempNum),
+	CR_IGNORED(mtTempNum), // sized by THREADPOOL_MAX_THREADS, counters stay >= 1
 	CR_MEMBER(godMode),
 
 	CR_MEMBER(speedFactor),
@@ -7,6 +7,7 @@
 #include "Sim/Units/UnitHandler.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "Sim/Misc/ModInfo.h"
+#include "Sim/Misc/SimStageGraph.h"
 #include "Map/ReadMap.h"
 #include "System/Log/ILog.h"
 #include "System/SpringHash.h"
@@ -820,6 +821,7 @@ void CLosHandler::UnitLoaded(const CUnit* unit, const CUnit* transport)
 void CLosHandler::Update()
 {
 	SCOPED_TIMER("Sim::Los");
+	SIM_STAGE_ACCESS(SIM_RES_UNITS | SIM_RES_HEIGHTMAP, SIM_RES_LOS);
 
 	const std::vector<CUnit*>& activeUnits = unitHandler.GetActiveUnits();
 
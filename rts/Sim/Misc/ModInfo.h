@@ -194,6 +194,10 @@ public:
 	/// Point at which a region is considered bad for raw path tracing.
 	float pfRawMoveSpeedThreshold;
 
+	/// HAPFS: let identical path requests issued in the same frame share
+	/// their estimator searches through the path cache.
+	bool pfCoalesceRequests;
+
 	/// Limits how many nodes the QTPFS pathing system is permitted to search. A smaller number
 	/// improves CPU performance, but a larger number will resolve longer paths better, without
 	/// needing to refresh the path.
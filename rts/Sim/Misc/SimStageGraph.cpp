@@ -0,0 +1,153 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+#include <cassert>
+
+#include "SimStageGraph.h"
+#include "System/Log/ILog.h"
+#include "System/Threading/ThreadPool.h"
+
+#include "System/Misc/TracyDefs.h"
+
+#ifdef DEBUG_SIM_STAGE_ACCESS
+static thread_local const char* curStageName = nullptr;
+static thread_local uint32_t curStageReads = SIM_RES_ALL;
+static thread_local uint32_t curStageWrites = SIM_RES_ALL;
+#endif
+
+
+void CSimStageGraph::AddStage(const char* name, StageFunc func, uint32_t reads, uint32_t writes, SyncLane lane)
+{
+	// Lua call-ins can reach any part of the simulation
+	if ((writes & SIM_RES_LUA) != 0)
+		reads = (writes = SIM_RES_ALL);
+
+	stages.push_back({name, func, reads | writes, writes, lane});
+}
+
+void CSimStageGraph::Clear()
+{
+	stages.clear();
+	waveOrder.clear();
+	waveStarts.clear();
+}
+
+
+bool CSimStageGraph::Conflict(const Stage& a, const Stage& b)
+{
+	if (IsExclusive(a) || IsExclusive(b))
+		return true;
+
+	return (((a.writes & b.reads) | (b.writes & a.reads)) != 0);
+}
+
+void CSimStageGraph::Build()
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	std::vector<int> stageWaves(stages.size(), 0);
+
+	int numWaves = 0;
+
+	// a stage goes into the first wave after every earlier stage it conflicts with
+	for (size_t j = 0; j < stages.size(); j++) {
+		for (size_t i = 0; i < j; i++) {
+			if (!Conflict(stages[i], stages[j]))
+				continue;
+
+			stageWaves[j] = std::max(stageWaves[j], stageWaves[i] + 1);
+		}
+
+		numWaves = std::max(numWaves, stageWaves[j] + 1);
+	}
+
+	waveOrder.clear();
+	waveOrder.reserve(stages.size());
+	waveStarts.clear();
+	waveStarts.reserve(numWaves + 1);
+
+	for (int w = 0; w < numWaves; w++) {
+		waveStarts.push_back(waveOrder.size());
+
+		for (size_t i = 0; i < stages.size(); i++) {
+			if (stageWaves[i] == w)
+				waveOrder.push_back(i);
+		}
+	}
+
+	waveStarts.push_back(waveOrder.size());
+
+	for (int w = 0; w < numWaves; w++) {
+		const int numStages = waveStarts[w + 1] - waveStarts[w];
+
+		if (numStages == 1)
+			continue;
+
+		for (int i = waveStarts[w]; i < waveStarts[w + 1]; i++) {
+			LOG_L(L_DEBUG, "[SimStageGraph::%s] wave %d runs \"%s\" alongside %d other stage(s)", __func__, w, stages[waveOrder[i]].name, numStages - 1);
+
+			// exclusive stages must never share a wave
+			assert(!IsExclusive(stages[waveOrder[i]]));
+		}
+	}
+}
+
+
+void CSimStageGraph::ExecuteStage(const Stage& s)
+{
+	#ifdef DEBUG_SIM_STAGE_ACCESS
+	curStageName = s.name;
+	curStageReads = s.reads;
+	curStageWrites = s.writes;
+	#endif
+
+	s.func();
+
+	#ifdef DEBUG_SIM_STAGE_ACCESS
+	curStageName = nullptr;
+	curStageReads = SIM_RES_ALL;
+	curStageWrites = SIM_RES_ALL;
+	#endif
+}
+
+void CSimStageGraph::Execute(bool threaded) const
+{
+	if (!threaded || waveStarts.empty()) {
+		for (const Stage& s: stages) {
+			SCOPED_SYNC_LANE(s.lane);
+			ExecuteStage(s);
+		}
+
+		return;
+	}
+
+	for (size_t w = 0, n = waveStarts.size() - 1; w < n; w++) {
+		const int waveBeg = waveStarts[w    ];
+		const int waveEnd = waveStarts[w + 1];
+
+		if ((waveEnd - waveBeg) == 1) {
+			const Stage& s = stages[waveOrder[waveBeg]];
+
+			SCOPED_SYNC_LANE(s.lane);
+			ExecuteStage(s);
+			continue;
+		}
+
+		for_mt(waveBeg, waveEnd, [&](const int i) {
+			ExecuteStage(stages[waveOrder[i]]);
+		});
+	}
+}
+
+
+void CSimStageGraph::CheckAccess(uint32_t reads, uint32_t writes, const char* caller)
+{
+	#ifdef DEBUG_SIM_STAGE_ACCESS
+	const uint32_t undeclared = (reads & ~curStageReads) | (writes & ~curStageWrites);
+
+	if (undeclared == 0)
+		return;
+
+	LOG_L(L_ERROR, "[SimStageGraph::%s] stage \"%s\" accessed undeclared resources 0x%x (reads=0x%x writes=0x%x) in %s", __func__, curStageName, undeclared, reads, writes, caller);
+	assert(false);
+	#endif
+}
@@ -0,0 +1,99 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef SIM_STAGE_GRAPH_H
+#define SIM_STAGE_GRAPH_H
+
+#include <cstdint>
+#include <vector>
+
+#include "System/Sync/SyncChecker.h"
+
+/**
+ * Coarse pieces of simulation state a SimFrame stage can declare to read
+ * or write. Anything that may run synced Lua call-ins must write SIM_RES_LUA
+ * (which implies everything, since gadgets can touch all of it), anything
+ * that performs synced assignments or draws from gsRNG must write SIM_RES_SYNC.
+ */
+enum SimStageResource : uint32_t {
+	SIM_RES_HEIGHTMAP    = 1u <<  0,
+	SIM_RES_HEIGHTBOUNDS = 1u <<  1,
+	SIM_RES_SMOOTHMESH   = 1u <<  2,
+	SIM_RES_UNITS        = 1u <<  3,
+	SIM_RES_FEATURES     = 1u <<  4,
+	SIM_RES_PROJECTILES  = 1u <<  5,
+	SIM_RES_PATHING      = 1u <<  6,
+	SIM_RES_LOS          = 1u <<  7,
+	SIM_RES_QUADFIELD    = 1u <<  8,
+	SIM_RES_WIND         = 1u <<  9,
+	SIM_RES_UNSYNCED     = 1u << 10, // drawer-side state updated from sim (ghosts, decals)
+	SIM_RES_SYNC         = 1u << 11, // sync checksum, gsRNG
+	SIM_RES_LUA          = 1u << 12,
+	SIM_RES_ALL          = (1u << 13) - 1,
+};
+
+
+#ifdef DEBUG_SIM_STAGE_ACCESS
+	#define SIM_STAGE_ACCESS(reads, writes) CSimStageGraph::CheckAccess(reads, writes, __func__)
+#else
+	#define SIM_STAGE_ACCESS(reads, writes)
+#endif
+
+
+/**
+ * Dependency graph over the stages of CGame::SimFrame.
+ *
+ * Stages are added in their serial order; two stages conflict if either one
+ * writes a resource the other reads or writes, and conflicting stages always
+ * run in the order they were added. Build() levels the graph into waves of
+ * mutually independent stages, each wave runs on the ThreadPool and finishes
+ * before the next starts. Since the wave layout only depends on the declared
+ * sets, the schedule is identical on every client.
+ *
+ * Stages that write SIM_RES_SYNC or SIM_RES_LUA are exclusive: they always get
+ * a wave of their own and run on the main thread, so the sync checksum only
+ * ever sees the serial order. Their SyncLane is applied while they execute.
+ *
+ * With DEBUG_SIM_STAGE_ACCESS defined, subsystems annotated with
+ * SIM_STAGE_ACCESS verify that the running stage declared what they touch.
+ */
+class CSimStageGraph {
+public:
+	typedef void (*StageFunc)();
+
+	void AddStage(const char* name, StageFunc func, uint32_t reads, uint32_t writes, SyncLane lane = SYNC_LANE_MISC);
+	void Build();
+	void Clear();
+
+	/// runs all stages; serially in declaration order if threaded is false
+	void Execute(bool threaded) const;
+
+	bool Empty() const { return stages.empty(); }
+	int GetNumWaves() const { return (static_cast<int>(waveStarts.size()) - 1); }
+
+	static void CheckAccess(uint32_t reads, uint32_t writes, const char* caller);
+
+private:
+	struct Stage {
+		const char* name;
+		StageFunc func;
+
+		uint32_t reads;
+		uint32_t writes;
+
+		SyncLane lane;
+	};
+
+	static bool IsExclusive(const Stage& s) { return ((s.writes & (SIM_RES_SYNC | SIM_RES_LUA)) != 0); }
+	static bool Conflict(const Stage& a, const Stage& b);
+
+	static void ExecuteStage(const Stage& s);
+
+private:
+	std::vector<Stage> stages;
+
+	/// stage indices grouped by wave, wave i is [waveStarts[i], waveStarts[i + 1])
+	std::vector<int> waveOrder;
+	std::vector<int> waveStarts;
+};
+
+#endif // SIM_STAGE_GRAPH_H
@@ -9,6 +9,7 @@
 #include "Map/Ground.h"
 #include "Map/ReadMap.h"
 #include "Sim/Misc/ModInfo.h"
+#include "Sim/Misc/SimStageGraph.h"
 #include "System/float3.h"
 #include "System/Log/ILog.h"
 #include "System/SpringMath.h"
@@ -436,6 +437,7 @@ inline static void CheckInvariants(
 
 void SmoothHeightMesh::MapChanged(int x1, int y1, int x2, int y2) {
 	RECOIL_DETAILED_TRACY_ZONE;
+	SIM_STAGE_ACCESS(0, SIM_RES_SMOOTHMESH);
 
 	if (!enabled) return;
 
@@ -556,7 +558,11 @@ LOG("%s: quad area in world space (%f,%f) (%f,%f)", __func__
 void SmoothHeightMesh::UpdateSmoothMesh() {
 	if (!enabled) return;
 
-	SCOPED_TIMER("Sim::SmoothHeightMesh::UpdateSmoothMesh");
+	// runs on a pool thread alongside the HeightBounds stage, and SCOPED_TIMER
+	// is main-thread only
+	static TimerNameRegistrar timerName("Sim::SmoothHeightMesh::UpdateSmoothMesh");
+	SCOPED_MT_TIMER("Sim::SmoothHeightMesh::UpdateSmoothMesh");
+	SIM_STAGE_ACCESS(SIM_RES_HEIGHTMAP, SIM_RES_SMOOTHMESH);
 
 	if (!UpdateSmoothMeshRequired(mapChangeTrack)) return;
 
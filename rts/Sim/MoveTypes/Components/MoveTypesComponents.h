@@ -7,6 +7,8 @@
 #include "System/Ecs/Components/BaseComponents.h"
 #include <System/Threading/ThreadPool.h>
 
+#include <vector>
+
 struct CUnit;
 struct CFeature;
 
@@ -43,6 +45,11 @@ void serializeComponents(Archive &archive, Snapshot &snapshot) {
 struct GroundMoveSystemComponent {
 	static constexpr std::size_t page_size = 1;
     static constexpr std::size_t INITIAL_TRAP_UNIT_LIST_ALLOC_SIZE = 64;
+
+    // Scratch space for reducing FeatureMoveEvents: feature id -> slot in
+    // movedFeatures (or -1), slots are assigned in the order of first push.
+    std::vector<int> featureMoveSlots;
+    std::vector<std::pair<CFeature*, float3>> movedFeatures;
 };
 
 struct YardmapTrapCheckSystemComponent {
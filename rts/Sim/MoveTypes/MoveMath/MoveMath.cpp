@@ -481,16 +481,20 @@ CMoveMath::BlockType CMoveMath::RangeIsBlockedHashedSt(int xmin, int xmax, int z
 	return ret;
 }
 
-static std::array<spring::unordered_map<CSolidObject*, CMoveMath::BlockType>, ThreadPool::MAX_THREADS> blockMaps;
-static std::array<int, ThreadPool::MAX_THREADS> lastTempNums;
+// one cache line per thread, workers update lastTempNum on most queries
+struct alignas(64) RangeIsBlockedCache {
+	spring::unordered_map<CSolidObject*, CMoveMath::BlockType> blockMap;
+	int lastTempNum = -1;
+};
+
+static std::array<RangeIsBlockedCache, ThreadPool::MAX_THREADS> blockCaches;
 
 // Called by GeneralMoveSystem::Init()
 void CMoveMath::InitRangeIsBlockedHashes() {
-	for (auto& blockMap : blockMaps) {
-		blockMap.reserve(10);
-	}
-	for (auto& lastTempNum : lastTempNums) {
-		lastTempNum = -1;
+	// drop the old tables instead of reserving here, so each map gets
+	// allocated by the worker that uses it (memory local to its node)
+	for (auto& blockCache : blockCaches) {
+		blockCache = {};
 	}
 }
 
@@ -499,8 +503,8 @@ CMoveMath::BlockType CMoveMath::RangeIsBlockedHashedMt(int xmin, int xmax, int z
 	RECOIL_DETAILED_TRACY_ZONE;
 	BlockType ret = BLOCK_NONE;
 
-	spring::unordered_map<CSolidObject*, CMoveMath::BlockType>& blockMap = blockMaps[thread];
-	int& lastTempNum = lastTempNums[thread];
+	spring::unordered_map<CSolidObject*, CMoveMath::BlockType>& blockMap = blockCaches[thread].blockMap;
+	int& lastTempNum = blockCaches[thread].lastTempNum;
 
 	if (lastTempNum != tempNum){
 		blockMap.clear();
@@ -538,7 +542,7 @@ CMoveMath::BlockType CMoveMath::RangeIsBlockedHashedMt(int xmin, int xmax, int z
 void CMoveMath::FloodFillRangeIsBlocked(const MoveDef& moveDef, const CSolidObject* collider, const SRectangle& areaToSample, std::vector<std::uint8_t>& results, int thread)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
-	spring::unordered_map<CSolidObject*, CMoveMath::BlockType>& blockMap = blockMaps[thread];
+	spring::unordered_map<CSolidObject*, CMoveMath::BlockType>& blockMap = blockCaches[thread].blockMap;
 	blockMap.clear();
 
 	results.clear();
@@ -28,6 +28,8 @@ void GeneralMoveSystem::Update() {
     RECOIL_DETAILED_TRACY_ZONE;
     auto view = Sim::registry.view<GeneralMoveType>();
 	{
+        // unlike GroundMoveSystem this stays serial: air and script move types
+        // read and push the live positions of units updated before them
         SCOPED_TIMER("Sim::Unit::MoveType::5::Update");
         view.each([](GeneralMoveType& unitId){
             CUnit* unit = unitHandler.GetUnit(unitId.value);
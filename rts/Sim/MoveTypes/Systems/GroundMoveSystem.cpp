@@ -6,6 +6,7 @@
 
 #include "Sim/Ecs/Registry.h"
 #include "Sim/Features/Feature.h"
+#include "Sim/Misc/GlobalConstants.h"
 #include "Sim/Misc/QuadField.h"
 #include "Sim/MoveTypes/Components/MoveTypesComponents.h"
 #include "Sim/Units/Unit.h"
@@ -18,7 +19,9 @@
 using namespace MoveTypes;
 
 void GroundMoveSystem::Init() {
-    Sim::systemGlobals.CreateSystemComponent<GroundMoveSystemComponent>();
+    auto& comp = Sim::systemGlobals.CreateSystemComponent<GroundMoveSystemComponent>();
+
+    comp.featureMoveSlots.resize(MAX_FEATURES, -1);
 }
 
 template<typename T, typename F>
@@ -143,11 +146,30 @@ void GroundMoveSystem::Update() {
         issue_events<FeatureCollisionEvents>([](const FeatureCollisionEvent& event) {
             eventHandler.UnitFeatureCollision(event.collider, event.collidee);
         });
-        issue_events<FeatureMoveEvents>([](const FeatureMoveEvent& event) {
-            quadField.RemoveFeature(event.collidee);
-            event.collidee->Move(event.moveImpulse, true);
-            quadField.AddFeature(event.collidee);
+        // A feature pushed by many units (e.g. a wreck in a choke point) is
+        // moved once with the sum of all its pushes rather than being taken
+        // out of and re-inserted into the QuadField per push. Summation runs
+        // in registry order, so the result is identical on every client.
+        issue_events<FeatureMoveEvents>([&comp](const FeatureMoveEvent& event) {
+            int& slot = comp.featureMoveSlots[event.collidee->id];
+
+            if (slot < 0) {
+                slot = static_cast<int>(comp.movedFeatures.size());
+                comp.movedFeatures.emplace_back(event.collidee, ZeroVector);
+            }
+
+            comp.movedFeatures[slot].second += event.moveImpulse;
         });
+
+        for (const auto& [feature, impulse]: comp.movedFeatures) {
+            quadField.RemoveFeature(feature);
+            feature->Move(impulse, true);
+            quadField.AddFeature(feature);
+
+            comp.featureMoveSlots[feature->id] = -1;
+        }
+
+        comp.movedFeatures.clear();
 	}
 	{
         // TODO: the vars are synced and that's what is stoping this being MT'ed.
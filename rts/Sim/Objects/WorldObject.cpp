@@ -11,7 +11,7 @@ CR_BIND_DERIVED(CWorldObject, CObject, )
 CR_REG_METADATA(CWorldObject, (
 	CR_MEMBER(id),
 	CR_MEMBER(tempNum),
-	CR_MEMBER(mtTempNum),
+	CR_IGNORED(mtTempNum), // per-query scratch, sized by THREADPOOL_MAX_THREADS
 	CR_MEMBER(radius),
 	CR_MEMBER(height),
 	CR_MEMBER(sqRadius),
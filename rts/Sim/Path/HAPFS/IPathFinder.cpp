@@ -162,9 +162,8 @@ IPath::SearchResult IPathFinder::GetPath(
 		FinishSearch(moveDef, pfDef, path);
 
 		//if (ci.pathType == -1)
-		// When the MT 'Pathing System' is running, it will handle updating the cache separately.
-		if (!ThreadPool::inMultiThreadedSection)
-			AddCache(&path, result, mStartBlock, goalBlock, pfDef.sqGoalRadius, moveDef.pathType, pfDef.synced);
+		// When the MT 'Pathing System' is running, PathingState defers (or drops) the write itself.
+		AddCache(&path, result, mStartBlock, goalBlock, pfDef.sqGoalRadius, moveDef.pathType, pfDef.synced);
 		// else{
 		// 	if (debugLoggingActive == ThreadPool::GetThreadNum()){
 		// 	if (ci.path.path.size() != path.path.size())
@@ -5,11 +5,13 @@
 #include "PathCache.h"
 #include "Sim/Misc/GlobalConstants.h"
 #include "Sim/Misc/GlobalSynced.h"
+#include "Sim/Misc/ModInfo.h"
 #include "System/Log/ILog.h"
 
 #include "System/Misc/TracyDefs.h"
 
 #define MAX_CACHE_QUEUE_SIZE   200
+#define MAX_CACHE_QUEUE_LENGTH (256 * 1024)
 #define MAX_PATH_LIFETIME_SECS   6
 #define USE_NONCOLLIDABLE_HASH   1
 
@@ -21,9 +23,12 @@ CPathCache::CPathCache(int blocksX, int blocksZ)
 	, numBlocks(numBlocksX * numBlocksZ)
 
 	, maxCacheSize(0)
+	, curCacheLength(0)
+	, maxCacheLength(0)
 	, numCacheHits(0)
 	, numCacheMisses(0)
 	, numHashCollisions(0)
+	, numEvictions(0)
 {
 	LOG("Path cache (%d, %d) initialized.", numBlocksX, numBlocksZ);
 	// {result, path, strtBlock, goalBlock, goalRadius, pathType}
@@ -53,8 +58,10 @@ bool CPathCache::AddPath(
 	int pathType
 ) {
 	RECOIL_DETAILED_TRACY_ZONE;
-	if (cacheQue.size() > MAX_CACHE_QUEUE_SIZE)
+	if (cacheQue.size() > MAX_CACHE_QUEUE_SIZE) {
 		RemoveFrontQueItem();
+		numEvictions += 1;
+	}
 
 	const std::uint64_t hash = GetHash(strtBlock, goalBlock, goalRadius, pathType);
 	const std::uint32_t cols = numHashCollisions;
@@ -74,12 +81,27 @@ bool CPathCache::AddPath(
 	if (iter != cachedPaths.end())
 		return ((numHashCollisions += HashCollision(iter->second, strtBlock, goalBlock, goalRadius, pathType)) != cols);
 
-	cachedPaths[hash] = CacheItem{result, *path, strtBlock, goalBlock, goalRadius, pathType};
+	CacheItem ci = {result, *path, strtBlock, goalBlock, goalRadius, pathType};
+	const std::uint64_t length = GetItemLength(ci);
+
+	// with request coalescing the cache is also bounded by its total waypoint
+	// and square count, long paths from mass orders would otherwise be kept
+	// alive for their whole lifetime; games that do not opt in keep the plain
+	// entry-count bound and thus the same cache contents as before
+	// note: evicting from the front keeps the queue sorted by timeout
+	while (modInfo.pfCoalesceRequests && !cacheQue.empty() && (curCacheLength + length) > MAX_CACHE_QUEUE_LENGTH) {
+		RemoveFrontQueItem();
+		numEvictions += 1;
+	}
+
+	cachedPaths[hash] = std::move(ci);
 
 	const int lifeTime = (result == IPath::Ok) ? GAME_SPEED * MAX_PATH_LIFETIME_SECS : GAME_SPEED * (MAX_PATH_LIFETIME_SECS / 2);
 
-	cacheQue.push_back({gs->frameNum + lifeTime, hash});
+	cacheQue.push_back({gs->frameNum + lifeTime, hash, length});
+	curCacheLength += length;
 	maxCacheSize = std::max<std::uint64_t>(maxCacheSize, cacheQue.size());
+	maxCacheLength = std::max<std::uint64_t>(maxCacheLength, curCacheLength);
 
 	return false;
 }
@@ -119,6 +141,19 @@ const CPathCache::CacheItem& CPathCache::GetCachedPath(
 	return dummyCacheItem;
 }
 
+void CPathCache::PrintDebugInfo(const char* name) const
+{
+	LOG("[%s][%s(%ux%u)] hits=%u misses=%u hitPercentage=%.0f%% hashColls=%u evictions=%u",
+		__func__, name, numBlocksX, numBlocksZ,
+		numCacheHits, numCacheMisses, GetCacheHitPercentage(), numHashCollisions, numEvictions
+	);
+	LOG("[%s][%s(%ux%u)] items=%u (peak %u) length=%u (peak %u)",
+		__func__, name, numBlocksX, numBlocksZ,
+		static_cast<unsigned int>(cacheQue.size()), static_cast<unsigned int>(maxCacheSize),
+		static_cast<unsigned int>(curCacheLength), static_cast<unsigned int>(maxCacheLength)
+	);
+}
+
 void CPathCache::Update()
 {
 	RECOIL_DETAILED_TRACY_ZONE;
@@ -133,6 +168,8 @@ void CPathCache::RemoveFrontQueItem()
 
 	assert(it != cachedPaths.end());
 	cachedPaths.erase(it);
+
+	curCacheLength -= (cacheQue.front()).length;
 	cacheQue.pop_front();
 }
 
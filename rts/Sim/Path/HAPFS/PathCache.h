@@ -44,9 +44,17 @@ public:
 		int pathType
 	);
 
+	void PrintDebugInfo(const char* name) const;
+
 private:
 	void RemoveFrontQueItem();
 
+	// counts rather than bytes, the latter depend on ABI and allocator
+	// and evictions from the synced cache have to match on every client
+	static std::uint64_t GetItemLength(const CacheItem& ci) {
+		return (ci.path.path.size() + ci.path.squares.size());
+	}
+
 	std::uint64_t GetHash(
 		const int2 strtBlk,
 		const int2 goalBlk,
@@ -73,6 +81,7 @@ private:
 	struct CacheQueItem {
 		std::int32_t timeout;
 		std::uint64_t hash;
+		std::uint64_t length;
 	};
 
 	// returned on any cache-miss
@@ -86,9 +95,12 @@ private:
 	std::uint64_t numBlocks;
 
 	std::uint64_t maxCacheSize;
+	std::uint64_t curCacheLength;
+	std::uint64_t maxCacheLength;
 	std::uint32_t numCacheHits;
 	std::uint32_t numCacheMisses;
 	std::uint32_t numHashCollisions;
+	std::uint32_t numEvictions;
 };
 
 }
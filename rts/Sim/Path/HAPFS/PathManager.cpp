@@ -818,9 +818,8 @@ void CPathManager::Update()
 		SCOPED_TIMER("Sim::PathRequests");
 
 		auto pathSearchView = registry.view<PathSearch>();
-		for_mt(0, pathSearchView.size(), [this, &pathSearchView](int idx){
-			entt::entity searchEntity = pathSearchView.begin()[idx];
 
+		const auto ProcessSearch = [this, &pathSearchView](entt::entity searchEntity) {
 			PathSearch& pathSearch = pathSearchView.get<PathSearch>( searchEntity );
 			PathExtension* pathExtend = registry.try_get<PathExtension>( searchEntity );
 
@@ -845,13 +844,110 @@ void CPathManager::Update()
 			// LOG("%s: ent = %x, pathId = %d, result = %d, steps = %d", __func__
 			// 		, entt::to_integral(entities[idx]), pathSearch.pathId, newPath.searchResult
 			// 		, (int)newPath.maxResPath.path.size());
-		});
+		};
+
+		if (!modInfo.pfCoalesceRequests) {
+			for_mt(0, pathSearchView.size(), [&pathSearchView, &ProcessSearch](int idx){
+				ProcessSearch(pathSearchView.begin()[idx]);
+			});
+		} else {
+			ProcessCoalescedSearches(ProcessSearch);
+		}
 
 		// Clear out the search entities.
 		pathSearchView.each([](entt::entity ent){ registry.destroy(ent); });
 	}
 }
 
+template<typename ProcessSearchFunc>
+void CPathManager::ProcessCoalescedSearches(const ProcessSearchFunc& ProcessSearch)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	auto pathSearchView = registry.view<PathSearch>();
+
+	// identical requests (e.g. from a large group given one move order) are
+	// split into a leader and followers; leaders are searched first and their
+	// estimator results cached, so the followers' estimator queries are hits
+	// instead of repeating the same searches. Grouping follows the med-res
+	// cache key and leaders are picked in view order, so every client makes
+	// the same choices.
+	searchLeaders.clear();
+	searchFollowers.clear();
+	searchGroupKeys.clear();
+
+	constexpr float blockScale = 1.0f / (MEDRES_PE_BLOCKSIZE * SQUARE_SIZE);
+
+	for (size_t idx = 0, n = pathSearchView.size(); idx < n; idx++) {
+		const entt::entity searchEntity = pathSearchView.begin()[idx];
+		const PathSearch& pathSearch = pathSearchView.get<PathSearch>(searchEntity);
+
+		// extensions continue an existing path, never share them
+		if (registry.all_of<PathExtension>(searchEntity)) {
+			searchLeaders.push_back(searchEntity);
+			continue;
+		}
+
+		const SearchGroupKey key = {
+			pathSearch.moveDef->pathType,
+			int(pathSearch.startPos.x * blockScale), int(pathSearch.startPos.z * blockScale),
+			int(pathSearch.goalPos.x * blockScale), int(pathSearch.goalPos.z * blockScale),
+			pathSearch.goalRadius,
+		};
+
+		searchGroupKeys.emplace_back(key, idx);
+	}
+
+	// stable, ties keep view order
+	std::stable_sort(searchGroupKeys.begin(), searchGroupKeys.end(), [](const auto& a, const auto& b) { return (a.first < b.first); });
+
+	for (size_t i = 0; i < searchGroupKeys.size(); i++) {
+		const entt::entity searchEntity = pathSearchView.begin()[ searchGroupKeys[i].second ];
+
+		if (i == 0 || searchGroupKeys[i - 1].first < searchGroupKeys[i].first) {
+			searchLeaders.push_back(searchEntity);
+		} else {
+			searchFollowers.push_back(searchEntity);
+		}
+	}
+
+	const auto ProcessBatch = [&ProcessSearch](const std::vector<entt::entity>& searches) {
+		for (auto& ps: pathingStates) {
+			ps.SetDeferCacheWrites(true);
+		}
+
+		for_mt(0, searches.size(), [&searches, &ProcessSearch](int idx) {
+			const int threadNum = ThreadPool::GetThreadNum();
+
+			for (auto& ps: pathingStates) {
+				ps.SetDeferredCacheOrdinal(threadNum, idx);
+			}
+
+			ProcessSearch(searches[idx]);
+		});
+
+		for (auto& ps: pathingStates) {
+			ps.SetDeferCacheWrites(false);
+			ps.FlushDeferredCache();
+		}
+	};
+
+	ProcessBatch(searchLeaders);
+	ProcessBatch(searchFollowers);
+
+	numCoalescedRequests += searchFollowers.size();
+}
+
+void CPathManager::PrintDebugInfo() const
+{
+	if (!IsFinalized())
+		return;
+
+	LOG("[HAPFS::%s] coalescing=%d coalescedRequests=%u", __func__, modInfo.pfCoalesceRequests, numCoalescedRequests);
+
+	pathingStates[PATH_MED_RES].PrintDebugInfo();
+	pathingStates[PATH_LOW_RES].PrintDebugInfo();
+}
+
 // used to deposit heat on the heat-map as a unit moves along its path
 void CPathManager::UpdatePath(const CSolidObject* owner, unsigned int pathID)
 {
@@ -14,6 +14,8 @@
 #include "System/UnorderedMap.hpp"
 
 #include <mutex>
+#include <tuple>
+#include <vector>
 
 class CSolidObject;
 class PathFlowMap;
@@ -265,6 +267,12 @@ private:
 
 	void SavePathCacheForPathId(int pathIdToSave) override;
 
+	void PrintDebugInfo() const override;
+
+private:
+	template<typename ProcessSearchFunc>
+	void ProcessCoalescedSearches(const ProcessSearchFunc& ProcessSearch);
+
 private:
 	mutable std::mutex pathMapUpdate;
 
@@ -290,6 +298,15 @@ private:
 	CPathFinder* maxResPFs;
 
 	std::vector<IPathFinder*> pathFinders;
+
+	// {pathType, start-block, goal-block, goalRadius} at med-res
+	typedef std::tuple<int, int, int, int, int, float> SearchGroupKey;
+
+	std::vector< std::pair<SearchGroupKey, size_t> > searchGroupKeys;
+	std::vector<entt::entity> searchLeaders;
+	std::vector<entt::entity> searchFollowers;
+
+	std::uint32_t numCoalescedRequests = 0;
 };
 
 }
@@ -2,8 +2,7 @@
 
 #include "PathingState.h"
 
-#include "zlib.h"
-#include "minizip/zip.h"
+#include <cstdio>
 
 #include "Game/GlobalUnsynced.h"
 #include "Game/LoadScreen.h"
@@ -21,12 +20,11 @@
 #include "PathMemPool.h"
 
 #include "System/Config/ConfigHandler.h"
-#include "System/FileSystem/Archives/IArchive.h"
-#include "System/FileSystem/ArchiveLoader.h"
 #include "System/FileSystem/DataDirsAccess.h"
 #include "System/FileSystem/FileSystem.h"
 #include "System/FileSystem/FileQueryFlags.h"
 #include "System/Platform/Threading.h"
+#include "System/SpringHash.h"
 #include "System/StringUtil.h"
 #include "System/Threading/ThreadPool.h" // for_mt
 
@@ -53,7 +51,23 @@ static const std::string GetPathCacheDir() {
 
 static const std::string GetCacheFileName(const std::string& fileHashCode, const std::string& peFileName, const std::string& mapFileName) {
 	RECOIL_DETAILED_TRACY_ZONE;
-	return (GetPathCacheDir() + mapFileName + "." + peFileName + "-" + fileHashCode + ".zip");
+	return (GetPathCacheDir() + mapFileName + "." + peFileName + "-" + fileHashCode + ".pecache");
+}
+
+static void RemoveLegacyCacheFiles() {
+	RECOIL_DETAILED_TRACY_ZONE;
+	static bool removed = false;
+
+	if (removed)
+		return;
+
+	removed = true;
+
+	// caches of older builds were deflated archives, nothing reads them anymore
+	for (const std::string& file: dataDirsAccess.FindFiles(GetPathCacheDir(), "*.zip", 0)) {
+		LOG("[PathEstimator::%s] removing obsolete cache-file \"%s\"", __func__, file.c_str());
+		FileSystem::Remove(dataDirsAccess.LocateFile(file, FileQueryFlags::WRITE));
+	}
 }
 
 void PathingState::KillStatic() { pathingStates = 0; }
@@ -117,6 +131,10 @@ void PathingState::Init(std::vector<IPathFinder*> pathFinderlist, PathingState*
 		updatedBlocks.clear();
 		consumedBlocks.clear();
 		offsetBlocksSortedByCost.clear();
+
+		deferredCacheItems.clear();
+		deferredCacheOrdinals.clear();
+		deferCacheWrites = false;
 	}
 
 	PathingState*  childPE = this;
@@ -489,6 +507,29 @@ void PathingState::CalcVertexPathCost(
 }
 
 
+/**
+ * Cache-file layout: a CacheFileHeader followed by one section of
+ * block-offsets per MoveDef and finally the vertex-costs. Sections are
+ * stored uncompressed and read straight into blockStates / vertexCosts.
+ * The header carries an XXH3 hash over all sections to catch corrupted files;
+ * CalcChecksum is not used for this since it feeds the synced state and
+ * must run exactly once per estimator.
+ */
+struct CacheFileHeader {
+	std::uint32_t magic;
+	std::uint32_t formatVersion;
+	std::uint32_t estimatorVersion;
+	std::uint32_t fileHashCode;
+	std::uint32_t numMoveDefs;
+	std::uint32_t numBlocks;
+	std::uint32_t numVertexCosts;
+	std::uint32_t padding;
+	std::uint64_t dataHash;
+};
+
+static constexpr std::uint32_t CACHE_FILE_MAGIC   = 0x45434550; // "PECE"
+static constexpr std::uint32_t CACHE_FILE_VERSION = 2;
+
 /**
  * Try to read offset and vertices data from file, return false on failure
  */
@@ -503,57 +544,45 @@ bool PathingState::ReadFile(const std::string& peFileName, const std::string& ma
 	if (!FileSystem::FileExists(cacheFileName))
 		return false;
 
-	std::unique_ptr<IArchive> upfile(archiveLoader.OpenArchive(dataDirsAccess.LocateFile(cacheFileName), "sdz"));
+	FILE* file = std::fopen(dataDirsAccess.LocateFile(cacheFileName).c_str(), "rb");
 
-	if (upfile == nullptr || !upfile->IsOpen()) {
-		FileSystem::Remove(cacheFileName);
+	if (file == nullptr)
 		return false;
-	}
 
 	char calcMsg[512];
 	sprintf(calcMsg, "Reading Estimate PathCosts [%d]", BLOCK_SIZE);
 	loadscreen->SetLoadMessage(calcMsg);
 
-	const unsigned fid = upfile->FindFile("pathinfo");
-	if (fid >= upfile->NumFiles()) {
-		FileSystem::Remove(cacheFileName);
-		return false;
-	}
-
-	std::vector<std::uint8_t> buffer;
+	CacheFileHeader header;
 
-	if (!upfile->GetFile(fid, buffer) || buffer.size() < 4) {
-		FileSystem::Remove(cacheFileName);
-		return false;
-	}
+	bool valid = (std::fread(&header, sizeof(header), 1, file) == 1);
 
-	const unsigned int filehash = *(reinterpret_cast<unsigned int*>(&buffer[0]));
-	const unsigned int blockSize = blockStates.GetSize() * sizeof(short2);
-	unsigned int pos = sizeof(unsigned);
+	valid = valid && (header.magic == CACHE_FILE_MAGIC);
+	valid = valid && (header.formatVersion == CACHE_FILE_VERSION);
+	valid = valid && (header.estimatorVersion == PATHESTIMATOR_VERSION);
+	valid = valid && (header.fileHashCode == fileHashCode);
+	valid = valid && (header.numMoveDefs == moveDefHandler.GetNumMoveDefs());
+	valid = valid && (header.numBlocks == blockStates.GetSize());
+	valid = valid && (header.numVertexCosts == vertexCosts.size());
 
-	if (filehash != fileHashCode) {
-		FileSystem::Remove(cacheFileName);
-		return false;
+	// read center-offset data, one section per MoveDef
+	for (unsigned int pathType = 0; valid && pathType < header.numMoveDefs; ++pathType) {
+		auto& offsets = blockStates.peNodeOffsets[pathType];
+		valid = (std::fread(offsets.data(), sizeof(short2), offsets.size(), file) == offsets.size());
 	}
 
-	if (buffer.size() < (pos + blockSize * moveDefHandler.GetNumMoveDefs())) {
-		FileSystem::Remove(cacheFileName);
-		return false;
-	}
+	// read vertex-cost data
+	valid = valid && (std::fread(vertexCosts.data(), sizeof(float), vertexCosts.size(), file) == vertexCosts.size());
+	valid = valid && (header.dataHash == CalcDataHash());
 
-	// read center-offset data
-	for (int pathType = 0; pathType < moveDefHandler.GetNumMoveDefs(); ++pathType) {
-		std::memcpy(&blockStates.peNodeOffsets[pathType][0], &buffer[pos], blockSize);
-		pos += blockSize;
-	}
+	std::fclose(file);
 
-	// read vertex-cost data
-	if (buffer.size() < (pos + vertexCosts.size() * sizeof(float))) {
+	if (!valid) {
+		LOG_L(L_WARNING, "[PathEstimator::%s] discarding invalid cache-file \"%s\"", __func__, cacheFileName.c_str());
 		FileSystem::Remove(cacheFileName);
 		return false;
 	}
 
-	std::memcpy(&vertexCosts[0], &buffer[pos], vertexCosts.size() * sizeof(float));
 	return true;
 }
 
@@ -568,44 +597,56 @@ bool PathingState::WriteFile(const std::string& peFileName, const std::string& m
 	if (!FileSystem::CreateDirectory(GetPathCacheDir()))
 		return false;
 
+	RemoveLegacyCacheFiles();
+
 	const std::string hashHexString = IntToString(fileHashCode, "%x");
 	const std::string cacheFileName = GetCacheFileName(hashHexString, peFileName, mapFileName);
 
 	LOG("[PathEstimator::%s] hash=%s file=\"%s\" (exists=%d)", __func__, hashHexString.c_str(), cacheFileName.c_str(), FileSystem::FileExists(cacheFileName));
 
-	// open file for writing in a suitable location
-	zipFile file = zipOpen(dataDirsAccess.LocateFile(cacheFileName, FileQueryFlags::WRITE).c_str(), APPEND_STATUS_CREATE);
+	// open file for writing in a suitable location; write to a temporary
+	// first so an interrupted run can not leave a truncated cache behind
+	const std::string filePath = dataDirsAccess.LocateFile(cacheFileName, FileQueryFlags::WRITE);
+	const std::string tempPath = filePath + ".tmp";
+
+	FILE* file = std::fopen(tempPath.c_str(), "wb");
 
 	if (file == nullptr)
 		return false;
 
-	zipOpenNewFileInZip(file, "pathinfo", nullptr, nullptr, 0, nullptr, 0, nullptr, Z_DEFLATED, Z_BEST_COMPRESSION);
+	const CacheFileHeader header = {
+		CACHE_FILE_MAGIC,
+		CACHE_FILE_VERSION,
+		PATHESTIMATOR_VERSION,
+		fileHashCode,
+		static_cast<std::uint32_t>(moveDefHandler.GetNumMoveDefs()),
+		static_cast<std::uint32_t>(blockStates.GetSize()),
+		static_cast<std::uint32_t>(vertexCosts.size()),
+		0,
+		CalcDataHash(),
+	};
 
-	// write hash-code (NOTE: this also affects the CRC!)
-	zipWriteInFileInZip(file, (const void*) &fileHashCode, 4);
+	bool written = (std::fwrite(&header, sizeof(header), 1, file) == 1);
 
 	// write center-offsets
-	for (int pathType = 0; pathType < moveDefHandler.GetNumMoveDefs(); ++pathType) {
-		zipWriteInFileInZip(file, (const void*) &blockStates.peNodeOffsets[pathType][0], blockStates.peNodeOffsets[pathType].size() * sizeof(short2));
+	for (int pathType = 0; written && pathType < moveDefHandler.GetNumMoveDefs(); ++pathType) {
+		const auto& offsets = blockStates.peNodeOffsets[pathType];
+		written = (std::fwrite(offsets.data(), sizeof(short2), offsets.size(), file) == offsets.size());
 	}
 
 	// write vertex-costs
-	zipWriteInFileInZip(file, vertexCosts.data(), vertexCosts.size() * sizeof(float));
-
-	zipCloseFileInZip(file);
-	zipClose(file, nullptr);
+	written = written && (std::fwrite(vertexCosts.data(), sizeof(float), vertexCosts.size(), file) == vertexCosts.size());
+	written = (std::fclose(file) == 0) && written;
 
+	// rename does not replace existing files on all platforms
+	FileSystem::Remove(filePath);
 
-	// get the CRC over the written path data
-	std::unique_ptr<IArchive> upfile(archiveLoader.OpenArchive(dataDirsAccess.LocateFile(cacheFileName), "sdz"));
+	written = written && (std::rename(tempPath.c_str(), filePath.c_str()) == 0);
 
-	if (upfile == nullptr || !upfile->IsOpen()) {
-		FileSystem::Remove(cacheFileName);
-		return false;
-	}
+	if (!written)
+		std::remove(tempPath.c_str());
 
-	assert(upfile->FindFile("pathinfo") < upfile->NumFiles());
-	return true;
+	return written;
 }
 
 
@@ -819,6 +860,19 @@ void PathingState::MapChanged(unsigned int x1, unsigned int z1, unsigned int x2,
 }
 
 
+std::uint64_t PathingState::CalcDataHash() const
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	std::uint64_t hash = 0;
+
+	// each section seeds the next
+	for (const auto& pathTypeOffsets: blockStates.peNodeOffsets) {
+		hash = XXH3_64bits_withSeed(pathTypeOffsets.data(), pathTypeOffsets.size() * sizeof(short2), hash);
+	}
+
+	return (XXH3_64bits_withSeed(vertexCosts.data(), vertexCosts.size() * sizeof(float), hash));
+}
+
 std::uint32_t PathingState::CalcChecksum() const
 {
 	RECOIL_DETAILED_TRACY_ZONE;
@@ -897,10 +951,67 @@ std::uint32_t PathingState::CalcChecksum() const
 void PathingState::AddCache(const IPath::Path* path, const IPath::SearchResult result, const int2 strtBlock, const int2 goalBlock, float goalRadius, int pathType, const bool synced)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
+	if (ThreadPool::inMultiThreadedSection) {
+		// only synced requests are batched, see CPathManager::Update
+		if (!deferCacheWrites || !synced)
+			return;
+
+		const int threadNum = ThreadPool::GetThreadNum();
+		deferredCacheItems[threadNum].push_back({deferredCacheOrdinals[threadNum], result, *path, strtBlock, goalBlock, goalRadius, pathType});
+		return;
+	}
+
 	const std::lock_guard<std::mutex> lock(cacheAccessLock);
 	pathCache[synced]->AddPath(path, result, strtBlock, goalBlock, goalRadius, pathType);
 }
 
+void PathingState::SetDeferCacheWrites(bool b)
+{
+	// the pool can be resized between batches, and the queues are
+	// empty here since every batch is flushed before the next starts
+	if ((deferCacheWrites = b)) {
+		deferredCacheItems.resize(ThreadPool::GetNumThreads());
+		deferredCacheOrdinals.resize(ThreadPool::GetNumThreads(), 0);
+	}
+}
+
+void PathingState::FlushDeferredCache()
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	assert(!ThreadPool::inMultiThreadedSection);
+
+	flushedCacheItems.clear();
+
+	for (auto& threadItems: deferredCacheItems) {
+		for (auto& item: threadItems) {
+			flushedCacheItems.emplace_back(std::move(item));
+		}
+
+		threadItems.clear();
+	}
+
+	// all items of one request were produced by one thread in program order,
+	// so a stable sort by request ordinal yields the same sequence everywhere
+	std::stable_sort(flushedCacheItems.begin(), flushedCacheItems.end(), [](const DeferredCacheItem& a, const DeferredCacheItem& b) {
+		return (a.ordinal < b.ordinal);
+	});
+
+	for (const DeferredCacheItem& item: flushedCacheItems) {
+		pathCache[true]->AddPath(&item.path, item.result, item.strtBlock, item.goalBlock, item.goalRadius, item.pathType);
+	}
+
+	flushedCacheItems.clear();
+}
+
+void PathingState::PrintDebugInfo() const
+{
+	const std::lock_guard<std::mutex> lock(cacheAccessLock);
+	const std::string name = "PE" + IntToString(BLOCK_SIZE);
+
+	pathCache[0]->PrintDebugInfo((name + " unsynced").c_str());
+	pathCache[1]->PrintDebugInfo((name +   " synced").c_str());
+}
+
 void PathingState::AddPathForCurrentFrame(const IPath::Path* path, const IPath::SearchResult result, const int2 strtBlock, const int2 goalBlock, float goalRadius, int pathType, const bool synced)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
@@ -54,6 +54,7 @@ public:
     int  BlockPosToIdx(const int2 pos) const { return (pos.y * mapDimensionsInBlocks.x + pos.x); }
 
 	std::uint32_t CalcChecksum() const;
+	std::uint64_t CalcDataHash() const;
 	std::uint32_t CalcHash(const char* caller) const;
 
 	unsigned int GetBlockSize() const { return BLOCK_SIZE; }
@@ -121,6 +122,19 @@ public:
 		const bool synced
 	);
 
+	/**
+	 * Estimator results produced inside the multi-threaded request batch
+	 * can not go into the cache directly since the insertion order would
+	 * depend on thread scheduling. When enabled they are queued per thread
+	 * together with the ordinal of the request that produced them, and are
+	 * added in request order by FlushDeferredCache.
+	 */
+	void SetDeferCacheWrites(bool b);
+	void SetDeferredCacheOrdinal(unsigned int threadNum, std::uint32_t ordinal) { deferredCacheOrdinals[threadNum] = ordinal; }
+	void FlushDeferredCache();
+
+	void PrintDebugInfo() const;
+
 	PathNodeStateBuffer& GetNodeStateBuffer() { return blockStates; }
 
 private:
@@ -187,6 +201,22 @@ private:
 		SingleBlock(const int2& pos, const MoveDef* md) : blockPos(pos), moveDef(md) {}
 	};
 
+	struct DeferredCacheItem {
+		std::uint32_t ordinal;
+		IPath::SearchResult result;
+		IPath::Path path;
+		int2 strtBlock;
+		int2 goalBlock;
+		float goalRadius;
+		int pathType;
+	};
+
+	std::vector< std::vector<DeferredCacheItem> > deferredCacheItems; // [threadNum]
+	std::vector<std::uint32_t> deferredCacheOrdinals; // [threadNum]
+	std::vector<DeferredCacheItem> flushedCacheItems;
+
+	bool deferCacheWrites = false;
+
     std::vector<SingleBlock> consumedBlocks;
 	std::vector<SOffsetBlock> offsetBlocksSortedByCost;
 };
@@ -180,6 +180,9 @@ public:
 	virtual int2 GetNumQueuedUpdates() const { return (int2(0, 0)); }
 
 	virtual void SavePathCacheForPathId(int pathIdToSave) {};
+
+	/// logs cache and request statistics, see /debuginfo pathing
+	virtual void PrintDebugInfo() const {}
 };
 
 extern IPathManager* pathManager;
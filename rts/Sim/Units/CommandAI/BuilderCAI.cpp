@@ -23,6 +23,7 @@
 #include "Sim/Units/UnitTypes/Builder.h"
 #include "Sim/Units/UnitTypes/Building.h"
 #include "Sim/Units/UnitTypes/Factory.h"
+#include "System/ContainerUtil.h"
 #include "System/SpringMath.h"
 #include "System/StringUtil.h"
 #include "System/EventHandler.h"
@@ -56,11 +57,9 @@ CR_REG_METADATA(CBuilderCAI , (
 ))
 
 // not adding to members, should repopulate itself
-spring::unordered_set<int> CBuilderCAI::reclaimers;
-spring::unordered_set<int> CBuilderCAI::featureReclaimers;
-spring::unordered_set<int> CBuilderCAI::resurrecters;
-
-std::vector<int> CBuilderCAI::removees;
+CBuilderCAI::TargetRegistry CBuilderCAI::reclaimers;
+CBuilderCAI::TargetRegistry CBuilderCAI::featureReclaimers;
+CBuilderCAI::TargetRegistry CBuilderCAI::resurrecters;
 
 
 static std::string GetUnitDefBuildOptionToolTip(const UnitDef* ud, bool disabled) {
@@ -231,9 +230,9 @@ CBuilderCAI::~CBuilderCAI()
 void CBuilderCAI::InitStatic()
 {
 	RECOIL_DETAILED_TRACY_ZONE;
-	spring::clear_unordered_set(reclaimers);
-	spring::clear_unordered_set(featureReclaimers);
-	spring::clear_unordered_set(resurrecters);
+	reclaimers.Clear();
+	featureReclaimers.Clear();
+	resurrecters.Clear();
 }
 
 void CBuilderCAI::PostLoad()
@@ -1043,7 +1042,7 @@ void CBuilderCAI::ExecuteReclaim(Command& c)
 					StopMoveAndFinishCommand();
 					RemoveUnitFromFeatureReclaimers(owner);
 				} else {
-					AddUnitToFeatureReclaimers(owner);
+					AddUnitToFeatureReclaimers(owner, feature->id);
 				}
 			} else {
 				StopMoveAndFinishCommand();
@@ -1078,7 +1077,7 @@ void CBuilderCAI::ExecuteReclaim(Command& c)
 				if (!ReclaimObject(unit)) {
 					StopMoveAndFinishCommand();
 				} else {
-					AddUnitToReclaimers(owner);
+					AddUnitToReclaimers(owner, unit->id);
 				}
 			} else {
 				RemoveUnitFromReclaimers(owner);
@@ -1153,7 +1152,7 @@ void CBuilderCAI::ExecuteResurrect(Command& c)
 					StopMoveAndFinishCommand();
 				}
 				else {
-					AddUnitToResurrecters(owner);
+					AddUnitToResurrecters(owner, feature->id);
 				}
 			} else {
 				RemoveUnitFromResurrecters(owner);
@@ -1386,131 +1385,122 @@ int CBuilderCAI::GetDefaultCmd(const CUnit* pointed, const CFeature* feature)
 }
 
 
-void CBuilderCAI::AddUnitToReclaimers(CUnit* unit) { reclaimers.insert(unit->id); }
-void CBuilderCAI::RemoveUnitFromReclaimers(CUnit* unit) { reclaimers.erase(unit->id); }
+void CBuilderCAI::TargetRegistry::Add(int builderID, int targetID)
+{
+	const auto it = builderTargets.find(builderID);
 
-void CBuilderCAI::AddUnitToFeatureReclaimers(CUnit* unit) { featureReclaimers.insert(unit->id); }
-void CBuilderCAI::RemoveUnitFromFeatureReclaimers(CUnit* unit) { featureReclaimers.erase(unit->id); }
+	if (it != builderTargets.end()) {
+		if (it->second == targetID)
+			return;
 
-void CBuilderCAI::AddUnitToResurrecters(CUnit* unit) { resurrecters.insert(unit->id); }
-void CBuilderCAI::RemoveUnitFromResurrecters(CUnit* unit) { resurrecters.erase(unit->id); }
+		Remove(builderID);
+	}
 
+	builderTargets[builderID] = targetID;
+	targetBuilders[targetID].push_back(builderID);
+}
 
-/**
- * Checks if a unit is being reclaimed by a friendly con.
- *
- * We assume that there will not be a lot of reclaimers, because performance
- * would suck if there were. Ideally, reclaimers should be assigned on a
- * per-unit basis, but this requires tracking of deaths, which albeit
- * already done, is not exactly simple to follow.
- *
- * TODO easy: store reclaiming units per allyteam
- * TODO harder: update reclaimers as they start/finish reclaims and/or die
- */
-bool CBuilderCAI::IsUnitBeingReclaimed(const CUnit* unit, const CUnit* friendUnit)
+void CBuilderCAI::TargetRegistry::Remove(int builderID)
 {
-	bool retval = false;
+	const auto it = builderTargets.find(builderID);
 
-	removees.clear();
-	removees.reserve(reclaimers.size());
+	if (it == builderTargets.end())
+		return;
 
-	for (auto it = reclaimers.begin(); it != reclaimers.end(); ++it) {
-		const CUnit* u = unitHandler.GetUnit(*it);
-		const CCommandAI* cai = u->commandAI;
-		const CCommandQueue& cq = cai->commandQue;
+	const auto jt = targetBuilders.find(it->second);
 
-		if (cq.empty()) {
-			removees.push_back(u->id);
-			continue;
-		}
-		const Command& c = cq.front();
-		if (c.GetID() != CMD_RECLAIM || (c.GetNumParams() != 1 && c.GetNumParams() != 5)) {
-			removees.push_back(u->id);
-			continue;
-		}
-		const int cmdUnitId = (int)c.GetParam(0);
-		if (cmdUnitId == unit->id && (friendUnit == nullptr || teamHandler.Ally(friendUnit->allyteam, u->allyteam))) {
-			retval = true;
-			break;
-		}
-	}
+	assert(jt != targetBuilders.end());
+	spring::VectorErase(jt->second, builderID);
 
-	for (auto it = removees.begin(); it != removees.end(); ++it)
-		RemoveUnitFromReclaimers(unitHandler.GetUnit(*it));
+	if (jt->second.empty())
+		targetBuilders.erase(jt);
 
-	return retval;
+	builderTargets.erase(it);
 }
 
-
-bool CBuilderCAI::IsFeatureBeingReclaimed(int featureId, const CUnit* friendUnit)
+void CBuilderCAI::TargetRegistry::Clear()
 {
-	RECOIL_DETAILED_TRACY_ZONE;
-	bool retval = false;
+	spring::clear_unordered_map(builderTargets);
+	spring::clear_unordered_map(targetBuilders);
+}
+
+
+void CBuilderCAI::AddUnitToReclaimers(CUnit* unit, int unitID) { reclaimers.Add(unit->id, unitID); }
+void CBuilderCAI::RemoveUnitFromReclaimers(CUnit* unit) { reclaimers.Remove(unit->id); }
+
+void CBuilderCAI::AddUnitToFeatureReclaimers(CUnit* unit, int featureID) { featureReclaimers.Add(unit->id, featureID); }
+void CBuilderCAI::RemoveUnitFromFeatureReclaimers(CUnit* unit) { featureReclaimers.Remove(unit->id); }
 
-	removees.clear();
-	removees.reserve(featureReclaimers.size());
+void CBuilderCAI::AddUnitToResurrecters(CUnit* unit, int featureID) { resurrecters.Add(unit->id, featureID); }
+void CBuilderCAI::RemoveUnitFromResurrecters(CUnit* unit) { resurrecters.Remove(unit->id); }
 
-	for (auto it = featureReclaimers.begin(); it != featureReclaimers.end(); ++it) {
-		const CUnit* u = unitHandler.GetUnit(*it);
-		const CCommandAI* cai = u->commandAI;
-		const CCommandQueue& cq = cai->commandQue;
 
-		if (cq.empty()) {
-			removees.push_back(u->id);
+/**
+ * Returns true if any builder registered for <targetID> is allied to
+ * <friendUnit> (if given) and still executing the command that made it
+ * register, i.e. its current order is <cmdID> aimed at <cmdTargetID>.
+ * Builders whose order has since changed are skipped here and dropped
+ * from the registry when they start or stop their next reclaim/resurrect
+ * (or die), so the per-query cost is bounded by the builders of a single
+ * target rather than by all active reclaimers.
+ */
+static bool IsTargetBeingProcessed(
+	const CBuilderCAI::TargetRegistry& registry,
+	int targetID,
+	int cmdID,
+	int cmdTargetID,
+	const CUnit* friendUnit
+) {
+	const std::vector<int>* builderIDs = registry.GetBuilders(targetID);
+
+	if (builderIDs == nullptr)
+		return false;
+
+	for (const int builderID: *builderIDs) {
+		const CUnit* u = unitHandler.GetUnit(builderID);
+		const CCommandQueue& cq = u->commandAI->commandQue;
+
+		if (cq.empty())
 			continue;
-		}
+
 		const Command& c = cq.front();
-		if (c.GetID() != CMD_RECLAIM || (c.GetNumParams() != 1 && c.GetNumParams() != 5)) {
-			removees.push_back(u->id);
+
+		if (c.GetID() != cmdID)
+			continue;
+		// reclaim can also be given as {id, x, y, z, radius}
+		if (c.GetNumParams() != 1 && (cmdID != CMD_RECLAIM || c.GetNumParams() != 5))
+			continue;
+		if ((int)c.GetParam(0) != cmdTargetID)
 			continue;
-		}
-		const int cmdFeatureId = (int)c.GetParam(0);
-		if ((cmdFeatureId - unitHandler.MaxUnits()) == featureId && (friendUnit == nullptr || teamHandler.Ally(friendUnit->allyteam, u->allyteam))) {
-			retval = true;
-			break;
-		}
-	}
 
-	for (auto it = removees.begin(); it != removees.end(); ++it)
-		RemoveUnitFromFeatureReclaimers(unitHandler.GetUnit(*it));
+		if (friendUnit == nullptr || teamHandler.Ally(friendUnit->allyteam, u->allyteam))
+			return true;
+	}
 
-	return retval;
+	return false;
 }
 
-
-bool CBuilderCAI::IsFeatureBeingResurrected(int featureId, const CUnit* friendUnit)
+/**
+ * Checks if a unit is being reclaimed by a friendly con.
+ */
+bool CBuilderCAI::IsUnitBeingReclaimed(const CUnit* unit, const CUnit* friendUnit)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
-	bool retval = false;
-
-	removees.clear();
-	removees.reserve(resurrecters.size());
+	return (IsTargetBeingProcessed(reclaimers, unit->id, CMD_RECLAIM, unit->id, friendUnit));
+}
 
-	for (auto it = resurrecters.begin(); it != resurrecters.end(); ++it) {
-		const CUnit* u = unitHandler.GetUnit(*it);
-		const CCommandAI* cai = u->commandAI;
-		const CCommandQueue& cq = cai->commandQue;
 
-		if (cq.empty()) {
-			removees.push_back(u->id);
-			continue;
-		}
-		const Command& c = cq.front();
-		if (c.GetID() != CMD_RESURRECT || c.GetNumParams() != 1) {
-			removees.push_back(u->id);
-			continue;
-		}
-		const int cmdFeatureId = (int)c.GetParam(0);
-		if ((cmdFeatureId - unitHandler.MaxUnits()) == featureId && (friendUnit == nullptr || teamHandler.Ally(friendUnit->allyteam, u->allyteam))) {
-			retval = true;
-			break;
-		}
-	}
+bool CBuilderCAI::IsFeatureBeingReclaimed(int featureId, const CUnit* friendUnit)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	return (IsTargetBeingProcessed(featureReclaimers, featureId, CMD_RECLAIM, featureId + unitHandler.MaxUnits(), friendUnit));
+}
 
-	for (auto it = removees.begin(); it != removees.end(); ++it)
-		RemoveUnitFromResurrecters(unitHandler.GetUnit(*it));
 
-	return retval;
+bool CBuilderCAI::IsFeatureBeingResurrected(int featureId, const CUnit* friendUnit)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	return (IsTargetBeingProcessed(resurrecters, featureId, CMD_RESURRECT, featureId + unitHandler.MaxUnits(), friendUnit));
 }
 
 
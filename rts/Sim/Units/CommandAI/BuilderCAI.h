@@ -6,6 +6,7 @@
 #include "MobileCAI.h"
 #include "Sim/Units/BuildInfo.h"
 #include "System/Misc/BitwiseEnum.h"
+#include "System/UnorderedMap.hpp"
 #include "System/UnorderedSet.hpp"
 
 #include <vector>
@@ -66,11 +67,35 @@ public:
 public:
 	spring::unordered_set<int> buildOptions;
 
-	static spring::unordered_set<int> reclaimers;
-	static spring::unordered_set<int> featureReclaimers;
-	static spring::unordered_set<int> resurrecters;
+	/**
+	 * Reverse index from a reclaim or resurrect target (unit- or feature-id)
+	 * to the builders that started working on it, so the IsBeing* queries
+	 * only look at the builders of one target instead of all of them.
+	 * Every builder has at most one entry per registry.
+	 */
+	struct TargetRegistry {
+	public:
+		void Add(int builderID, int targetID);
+		void Remove(int builderID);
+		void Clear();
+
+		const std::vector<int>* GetBuilders(int targetID) const {
+			const auto it = targetBuilders.find(targetID);
+
+			if (it == targetBuilders.end())
+				return nullptr;
+
+			return &(it->second);
+		}
+
+	private:
+		spring::unordered_map<int, int> builderTargets;
+		spring::unordered_map<int, std::vector<int> > targetBuilders;
+	};
 
-	static std::vector<int> removees;
+	static TargetRegistry reclaimers;
+	static TargetRegistry featureReclaimers;
+	static TargetRegistry resurrecters;
 
 private:
 	enum ReclaimOptions {
@@ -125,15 +150,15 @@ private:
 	void ReclaimFeature(CFeature* f);
 
 	/// fix for patrolling cons repairing/resurrecting stuff that's being reclaimed
-	static void AddUnitToReclaimers(CUnit*);
+	static void AddUnitToReclaimers(CUnit*, int unitID);
 	static void RemoveUnitFromReclaimers(CUnit*);
 
 	/// fix for cons wandering away from their target circle
-	static void AddUnitToFeatureReclaimers(CUnit*);
+	static void AddUnitToFeatureReclaimers(CUnit*, int featureID);
 	static void RemoveUnitFromFeatureReclaimers(CUnit*);
 
 	/// fix for patrolling cons reclaiming stuff that is being resurrected
-	static void AddUnitToResurrecters(CUnit*);
+	static void AddUnitToResurrecters(CUnit*, int featureID);
 	static void RemoveUnitFromResurrecters(CUnit*);
 
 	inline float f3Dist(const float3& a, const float3& b) const {
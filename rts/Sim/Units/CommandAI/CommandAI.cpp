@@ -32,6 +32,7 @@
 #include "System/StringUtil.h"
 #include "System/creg/STL_Set.h"
 #include "System/creg/STL_Deque.h"
+#include <algorithm>
 #include <assert.h>
 
 #include "System/Misc/TracyDefs.h"
@@ -1247,6 +1248,10 @@ void CCommandAI::ExecuteRemove(const Command& c)
 
 	repeatOrders = false;
 
+	// tags or ids to remove, sorted so each queued command is looked up once
+	std::vector<int> removeValues;
+	removeValues.reserve(c.GetNumParams());
+
 	for (unsigned int p = 0; p < c.GetNumParams(); p++) {
 		const int removeValue = c.GetParam(p); // tag or id
 
@@ -1256,50 +1261,48 @@ void CCommandAI::ExecuteRemove(const Command& c)
 			continue;
 		}
 
-		CCommandQueue::iterator ci;
-
-		do {
-			for (ci = queue->begin(); ci != queue->end(); ++ci) {
-				const Command& qc = *ci;
+		removeValues.push_back(removeValue);
+	}
 
-				if (removeByID) {
-					if (qc.GetID() != removeValue)
-						continue;
-				} else {
-					if (qc.GetTag() != removeValue)
-						continue;
-				}
+	std::sort(removeValues.begin(), removeValues.end());
 
-				if (qc.GetID() == CMD_WAIT) {
-					waitCommandsAI.RemoveWaitCommand(owner, qc);
-				}
+	// a single pass over the queue handles all values; after an erase the scan
+	// resumes at the following command and only restarts when the front of the
+	// queue was popped (removing N tagged orders from a queue of M commands used
+	// to rescan it N*M times)
+	for (CCommandQueue::iterator ci = queue->begin(); ci != queue->end(); ) {
+		const Command& qc = *ci;
+		const int queuedValue = removeByID? qc.GetID(): qc.GetTag();
 
-				if (facBuildQueue) {
-					// if ci == queue->begin() and !queue->empty(), this pop_front()'s
-					// via CFAI::ExecuteStop; otherwise only modifies *ci (not <queue>)
-					if (facCAI->RemoveBuildCommand(ci)) {
-						ci = queue->begin();
-						break;
-					}
-				}
+		if (!std::binary_search(removeValues.begin(), removeValues.end(), queuedValue)) {
+			++ci;
+			continue;
+		}
 
-				if (!facCAI && (ci == queue->begin())) {
-					if (!active) {
-						active = true;
-						FinishCommand();
-						ci = queue->begin();
-						break;
-					}
-					active = true;
-				}
+		if (qc.GetID() == CMD_WAIT) {
+			waitCommandsAI.RemoveWaitCommand(owner, qc);
+		}
 
-				queue->erase(ci);
+		if (facBuildQueue) {
+			// if ci == queue->begin() and !queue->empty(), this pop_front()'s
+			// via CFAI::ExecuteStop; otherwise only modifies *ci (not <queue>)
+			if (facCAI->RemoveBuildCommand(ci)) {
 				ci = queue->begin();
+				continue;
+			}
+		}
 
-				// the removal may have corrupted the iterator
-				break;
+		if (!facCAI && (ci == queue->begin())) {
+			if (!active) {
+				active = true;
+				FinishCommand();
+				ci = queue->begin();
+				continue;
 			}
-		} while (ci != queue->end());
+			active = true;
+		}
+
+		ci = queue->erase(ci);
 	}
 
 	repeatOrders = prevRepeat;
@@ -0,0 +1,98 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+#include <vector>
+
+#include "CacheDirLimiter.h"
+#include "System/Log/ILog.h"
+
+#include "System/Misc/TracyDefs.h"
+
+
+namespace {
+	struct CacheEntry {
+		std::filesystem::path path;
+		std::filesystem::file_time_type lastUse;
+		uint64_t size;
+	};
+
+	uint64_t ListEntries(const std::string& cacheDir, const char* extension, std::vector<CacheEntry>& entries)
+	{
+		std::error_code err;
+		uint64_t totalSize = 0;
+
+		for (std::filesystem::directory_iterator it(cacheDir, err), end; !err && it != end; it.increment(err)) {
+			if (it->path().extension() != extension)
+				continue;
+
+			CacheEntry e = {it->path(), it->last_write_time(err), it->file_size(err)};
+
+			if (err) {
+				err.clear();
+				continue;
+			}
+
+			entries.push_back(e);
+			totalSize += e.size;
+		}
+
+		return totalSize;
+	}
+}
+
+
+void CCacheDirLimiter::AddEntry(const std::string& cacheDir, uint64_t entrySize, uint64_t sizeLimit)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (!cacheSizeKnown) {
+		// the new entry is already on disk and part of the scan
+		EvictEntries(cacheDir, sizeLimit);
+		return;
+	}
+
+	if ((cacheSize += entrySize) > sizeLimit)
+		EvictEntries(cacheDir, sizeLimit);
+}
+
+void CCacheDirLimiter::Touch(const std::string& fileName)
+{
+	std::error_code err;
+	std::filesystem::last_write_time(fileName, std::filesystem::file_time_type::clock::now(), err);
+}
+
+
+// called with mutex held
+void CCacheDirLimiter::EvictEntries(const std::string& cacheDir, uint64_t sizeLimit)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	std::vector<CacheEntry> entries;
+
+	cacheSize = ListEntries(cacheDir, extension, entries);
+	cacheSizeKnown = true;
+
+	if (cacheSize <= sizeLimit)
+		return;
+
+	std::sort(entries.begin(), entries.end(), [](const CacheEntry& a, const CacheEntry& b) { return (a.lastUse < b.lastUse); });
+
+	const uint64_t targetSize = sizeLimit * EVICT_TARGET;
+	size_t numEvicted = 0;
+
+	for (const CacheEntry& e: entries) {
+		if (cacheSize <= targetSize)
+			break;
+
+		std::error_code err;
+
+		if (!std::filesystem::remove(e.path, err))
+			continue;
+
+		cacheSize -= e.size;
+		numEvicted++;
+	}
+
+	LOG("[%s::%s] evicted %u least recently used entries, %uMB left", owner, __func__, unsigned(numEvicted), unsigned(cacheSize / (1024 * 1024)));
+}
@@ -0,0 +1,48 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _CACHE_DIR_LIMITER_H
+#define _CACHE_DIR_LIMITER_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+/**
+ * Keeps the files with one extension in a cache directory below a size
+ * limit. Writers report every entry they add; once the total exceeds the
+ * limit, the least recently used entries (by modification time) are
+ * deleted until it is down to EVICT_TARGET of the limit, so eviction does
+ * not run again on every following write. Readers call Touch on a hit to
+ * mark the entry as used.
+ *
+ * The total is unknown until the first write scans the directory, which
+ * covers entries left by earlier runs.
+ */
+class CCacheDirLimiter {
+public:
+	CCacheDirLimiter(const char* ownerName, const char* fileExtension)
+		: owner(ownerName)
+		, extension(fileExtension)
+	{}
+
+	/// to be called after an entry of entrySize bytes was written to cacheDir
+	void AddEntry(const std::string& cacheDir, uint64_t entrySize, uint64_t sizeLimit);
+
+	static void Touch(const std::string& fileName);
+
+	static constexpr float EVICT_TARGET = 0.75f;
+
+private:
+	void EvictEntries(const std::string& cacheDir, uint64_t sizeLimit);
+
+private:
+	const char* owner;
+	const char* extension;
+
+	std::mutex mutex;
+
+	uint64_t cacheSize = 0;
+	bool cacheSizeKnown = false;
+};
+
+#endif // _CACHE_DIR_LIMITER_H
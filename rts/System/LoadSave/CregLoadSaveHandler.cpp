@@ -107,8 +107,8 @@ void CGameStateCollector::Serialize(creg::ISerializer* s)
 	s->SerializeObjectInstance(&commandDescriptionCache, commandDescriptionCache.GetClass());
 	CSkirmishAIHandler::SerializeSkirmishAIHandler(s);
 	s->SerializeObjectInstance(eoh, eoh->GetClass());
-	std::unique_ptr<creg::IType> mapType = creg::DeduceType<decltype(CSplitLuaHandle::gameParams)>::Get();
-	mapType->Serialize(s, &CSplitLuaHandle::gameParams);
+	LuaRulesParams::SerializeKeys(s);
+	s->SerializeObjectInstance(&CSplitLuaHandle::gameParams, CSplitLuaHandle::gameParams.GetClass());
 
 	s->SerializeObjectInstance(CUnitDrawer::modelDrawerData->GetSavedData(), CUnitDrawer::modelDrawerData->GetSavedData()->GetClass());
 	//s->SerializeObjectInstance(groundDecals, groundDecals->GetClass());
@@ -35,6 +35,7 @@ public:
 		std::swap(file, r.file);
 
 		std::swap(demoName, r.demoName);
+		std::swap(demoStream, r.demoStream);
 		std::swap(playerStats, r.playerStats);
 		std::swap(teamStats, r.teamStats);
 		std::swap(winningAllyTeams, r.winningAllyTeams);
@@ -73,6 +74,9 @@ private:
 private:
 	gzFile file = nullptr;
 
+	/// everything written so far, compressed into file when the recorder dies
+	std::string demoStream;
+
 	std::vector<PlayerStatistics> playerStats;
 	std::vector< std::vector<TeamStatistics> > teamStats;
 	std::vector<unsigned char> winningAllyTeams;
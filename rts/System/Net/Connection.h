@@ -62,8 +62,11 @@ public:
 	virtual bool NeedsReconnect() = 0;
 
 	unsigned int GetDataReceived() const { return dataRecv; }
+	unsigned int GetDataSent() const { return dataSent; }
 	unsigned int GetNumQueuedPings() const { return numPings; }
 	virtual unsigned int GetPacketQueueSize() const { return 0; }
+	/// packets and chunks not yet sent or acknowledged
+	virtual unsigned int GetOutgoingQueueSize() const { return 0; }
 
 	virtual std::string Statistics() const = 0;
 	virtual std::string GetFullAddress() const = 0;
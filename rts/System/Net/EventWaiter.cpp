@@ -0,0 +1,60 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "EventWaiter.h"
+
+#include <chrono>
+
+#include <asio/executor_work_guard.hpp>
+#include <asio/post.hpp>
+
+
+namespace netcode
+{
+
+EventWaiter::EventWaiter(): state(std::make_shared<State>())
+{
+	using WorkGuard = asio::executor_work_guard<asio::io_context::executor_type>;
+
+	workGuard = std::make_shared<WorkGuard>(ioContext.get_executor());
+}
+
+EventWaiter::~EventWaiter()
+{
+	// pending handlers only hold on to state
+	if (socket != nullptr && state->socketWaitPending.load()) {
+		asio::error_code err;
+		socket->cancel(err);
+	}
+}
+
+
+void EventWaiter::Wake()
+{
+	state->events |= EVENT_WAKE;
+
+	// only needed to make run_one return
+	asio::post(ioContext, []() {});
+}
+
+
+unsigned int EventWaiter::Wait(spring_time deadline)
+{
+	if (socket != nullptr && !state->socketWaitPending.exchange(true)) {
+		const std::shared_ptr<State> s = state;
+
+		socket->async_wait(asio::ip::udp::socket::wait_read, [s](const asio::error_code& err) {
+			s->socketWaitPending = false;
+
+			if (!err)
+				s->events |= EVENT_SOCKET;
+		});
+	}
+
+	for (spring_time now = spring_gettime(); state->events.load() == EVENT_NONE && now < deadline; now = spring_gettime()) {
+		ioContext.run_one_for(std::chrono::microseconds((deadline - now).toMicroSecsi()));
+	}
+
+	return (state->events.exchange(EVENT_NONE));
+}
+
+}
@@ -0,0 +1,71 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _EVENT_WAITER_H
+#define _EVENT_WAITER_H
+
+#include <atomic>
+#include <memory>
+
+#include <asio/io_context.hpp>
+#include <asio/ip/udp.hpp>
+
+#include "System/Misc/NonCopyable.h"
+#include "System/Misc/SpringTime.h"
+
+namespace netcode
+{
+
+/**
+ * @brief Lets a network thread sleep until it has something to do
+ * Wait returns as soon as the watched socket becomes readable, Wake is
+ * called from any thread, or the deadline passes. The socket has to be
+ * created on GetIoContext(), which only the waiting thread runs; this
+ * keeps several waiters in one process (or netservice pollers) from
+ * swallowing each other's wakeups.
+ */
+class EventWaiter : spring::noncopyable
+{
+public:
+	enum {
+		EVENT_NONE   = 0,
+		EVENT_SOCKET = 1,
+		EVENT_WAKE   = 2,
+	};
+
+public:
+	EventWaiter();
+	~EventWaiter();
+
+	asio::io_context& GetIoContext() { return ioContext; }
+
+	void WatchSocket(std::shared_ptr<asio::ip::udp::socket> sock) { socket = std::move(sock); }
+
+	/// thread-safe
+	void Wake();
+
+	/**
+	 * @return EVENT_* flags of everything that happened since the last
+	 *   call, EVENT_NONE if the deadline passed first
+	 */
+	unsigned int Wait(spring_time deadline);
+
+private:
+	// destroyed last, after everything that uses it
+	asio::io_context ioContext;
+
+	// outlives the waiter inside pending handlers
+	struct State {
+		std::atomic<unsigned int> events = {EVENT_NONE};
+		std::atomic<bool> socketWaitPending = {false};
+	};
+
+	std::shared_ptr<State> state;
+	std::shared_ptr<asio::ip::udp::socket> socket;
+
+	/// keeps ioContext from running out of work while nothing is pending
+	std::shared_ptr<void> workGuard;
+};
+
+}
+
+#endif // _EVENT_WAITER_H
@@ -66,9 +66,19 @@ void CLocalConnection::SendData(std::shared_ptr<const RawPacket> pkt)
 			instancePtrs[RemoteInstanceIdx()]->numPings += (pkt->data[0] == NETMSG_PING);
 
 		pktQueues[RemoteInstanceIdx()].push_back(pkt);
+
+		if (instancePtrs[RemoteInstanceIdx()] != nullptr && instancePtrs[RemoteInstanceIdx()]->incomingDataCallback)
+			instancePtrs[RemoteInstanceIdx()]->incomingDataCallback();
 	}
 }
 
+void CLocalConnection::SetIncomingDataCallback(std::function<void()> callback)
+{
+	// SendData reads it under the same lock
+	std::lock_guard<spring::mutex> scoped_lock(mutexes[instanceIdx]);
+	incomingDataCallback = std::move(callback);
+}
+
 std::shared_ptr<const RawPacket> CLocalConnection::GetData()
 {
 	std::lock_guard<spring::mutex> scoped_lock(mutexes[instanceIdx]);
@@ -4,6 +4,7 @@
 #define _LOCAL_CONNECTION_H
 
 #include <deque>
+#include <functional>
 #include "System/Threading/SpringThreading.h"
 
 #include "Connection.h"
@@ -52,6 +53,9 @@ public:
 
 	// END overriding CConnection
 
+	/// called on the sending thread whenever the other instance sends us a packet
+	void SetIncomingDataCallback(std::function<void()> callback);
+
 private:
 	static constexpr unsigned int MAX_INSTANCES = 2;
 
@@ -66,6 +70,8 @@ private:
 	static unsigned int numInstances;
 	/// which instance we are
 	unsigned int instanceIdx;
+
+	std::function<void()> incomingDataCallback;
 };
 
 } // namespace netcode
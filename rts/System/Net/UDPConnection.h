@@ -106,6 +106,7 @@ public:
 	bool NeedsReconnect() override;
 
 	unsigned int GetPacketQueueSize() const override { return msgQueue.size(); }
+	unsigned int GetOutgoingQueueSize() const override { return (outgoingData.size() + newChunks.size() + unackedChunks.size()); }
 
 	std::string Statistics() const override;
 	std::string GetFullAddress() const override;
@@ -113,6 +114,9 @@ public:
 	void Update() override;
 	// END overriding CConnection
 
+	/// true while data is queued, unacknowledged or waiting to be resent
+	bool HasPendingOutgoing() const { return (!outgoingData.empty() || !newChunks.empty() || !unackedChunks.empty() || !resendRequested.empty()); }
+
 
 	/**
 	 * @brief strip and parse header data and add data to waitingPackets
@@ -25,10 +25,10 @@ namespace netcode
 {
 using namespace asio;
 
-UDPListener::UDPListener(int port, const std::string& ip): acceptNewConnections(false)
+UDPListener::UDPListener(int port, const std::string& ip, asio::io_context* ioContext): acceptNewConnections(false)
 {
 	// resets socket on any exception
-	const std::string err = TryBindSocket(port, socket, ip);
+	const std::string err = TryBindSocket(port, socket, ip, ioContext);
 
 	if (!err.empty())
 		throw network_error(err);
@@ -46,7 +46,7 @@ UDPListener::~UDPListener() {
 }
 
 
-std::string UDPListener::TryBindSocket(int port, std::shared_ptr<asio::ip::udp::socket>& sock, const std::string& ip)
+std::string UDPListener::TryBindSocket(int port, std::shared_ptr<asio::ip::udp::socket>& sock, const std::string& ip, asio::io_context* ioContext)
 {
 	std::string errorMsg;
 
@@ -56,7 +56,7 @@ std::string UDPListener::TryBindSocket(int port, std::shared_ptr<asio::ip::udp::
 		if ((port < 0) || (port > 65535))
 			throw std::range_error("Port is out of range [0, 65535]: " + IntToString(port));
 
-		sock.reset(new ip::udp::socket(netservice));
+		sock.reset(new ip::udp::socket((ioContext != nullptr)? *ioContext: netservice));
 		sock->open(ip::udp::v6(), err); // test IP v6 support
 
 		const bool supportsIPv6 = !err;
@@ -186,6 +186,19 @@ void UDPListener::Update() {
 }
 
 
+bool UDPListener::HasPendingOutgoing() const
+{
+	for (const auto& p: connMap) {
+		const std::shared_ptr<UDPConnection> conn = p.second.lock();
+
+		if (conn != nullptr && conn->HasPendingOutgoing())
+			return true;
+	}
+
+	return false;
+}
+
+
 std::shared_ptr<UDPConnection> UDPListener::SpawnConnection(const std::string& ip, const unsigned port)
 {
 	std::shared_ptr<UDPConnection> newConn(new UDPConnection(socket, ip::udp::endpoint(WrapIP(ip), port)));
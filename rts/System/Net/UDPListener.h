@@ -28,8 +28,9 @@ public:
 	 * @brief Open a socket and make it ready for listening
 	 * @param  port the port to bind the socket to
 	 * @param  ip local IP to bind to, or "" for any
+	 * @param  ioContext context to create the socket on, netservice if null
 	 */
-	UDPListener(int port, const std::string& ip = "");
+	UDPListener(int port, const std::string& ip = "", asio::io_context* ioContext = nullptr);
 
 	/**
 	 * @brief close the socket and DELETE all connections
@@ -45,8 +46,9 @@ public:
 	 * @param  ip local IP (v4 or v6) to bind to,
 	 *         the default value "" results in the v6 any address "::",
 	 *         or the v4 equivalent "0.0.0.0", if v6 is no supported
+	 * @param  ioContext context to create the socket on, netservice if null
 	 */
-	static std::string TryBindSocket(int port, std::shared_ptr<asio::ip::udp::socket>& sock, const std::string& ip = "");
+	static std::string TryBindSocket(int port, std::shared_ptr<asio::ip::udp::socket>& sock, const std::string& ip = "", asio::io_context* ioContext = nullptr);
 
 	/**
 	 * @brief Run this from time to time
@@ -63,6 +65,11 @@ public:
 	bool IsAcceptingConnections() const { return acceptNewConnections; }
 	bool HasIncomingConnections() const { return (!waiting.empty()); }
 
+	/// whether any connection still needs regular Update calls to send
+	bool HasPendingOutgoing() const;
+
+	const std::shared_ptr<asio::ip::udp::socket>& GetSocket() const { return socket; }
+
 	/**
 	 * @brief Initiate a connection
 	 * Make a new connection to ip:port. It will be pushed back in conn.
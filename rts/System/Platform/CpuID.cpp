@@ -10,12 +10,21 @@
 #ifdef _MSC_VER
 	#include <intrin.h>
 #endif
+#ifdef _WIN32
+	#include <windows.h>
+#endif
 
 #include "System/Threading/SpringThreading.h"
 #include "System/UnorderedSet.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <cinttypes>
 #include <cassert>
+#include <cstdio>
+#include <cstdlib>
 #include <tuple>
+#include <vector>
 
 
 namespace springproc {
@@ -82,6 +91,70 @@ namespace springproc {
 	void ExecCPUID(unsigned int* a, unsigned int* b, unsigned int* c, unsigned int* d) {}
 #endif
 
+
+#if defined(__linux__)
+	static int ReadSysInt(const char* path)
+	{
+		FILE* file = std::fopen(path, "r");
+		int value = -1;
+
+		if (file == nullptr)
+			return value;
+
+		if (std::fscanf(file, "%d", &value) != 1)
+			value = -1;
+
+		std::fclose(file);
+		return value;
+	}
+
+	// parses a sysfs cpu-list such as "0-7,64-71"; cpus past the 64th are dropped
+	static bool ReadSysCpuList(const char* path, uint64_t& mask)
+	{
+		FILE* file = std::fopen(path, "r");
+		char buf[1024] = {0};
+
+		if (file == nullptr)
+			return false;
+
+		const bool haveList = (std::fgets(buf, sizeof(buf), file) != nullptr);
+		std::fclose(file);
+
+		if (!haveList)
+			return false;
+
+		mask = 0;
+
+		for (const char* pos = buf; *pos != 0 && *pos != '\n'; ) {
+			char* end = nullptr;
+
+			const long beg = std::strtol(pos, &end, 10);
+			long last = beg;
+
+			if (end == pos)
+				return false;
+
+			if (*(pos = end) == '-') {
+				last = std::strtol(pos + 1, &end, 10);
+
+				if (end == (pos + 1))
+					return false;
+
+				pos = end;
+			}
+
+			for (long n = beg; n <= std::min(last, 63L); n++) {
+				mask |= (uint64_t(1) << n);
+			}
+
+			pos += (*pos == ',');
+		}
+
+		return (mask != 0);
+	}
+#endif
+
+
 	CPUID& CPUID::GetInstance() {
 		static CPUID cpuid;
 		return cpuid;
@@ -108,12 +181,13 @@ namespace springproc {
 		}
 
 		EnumerateCores();
+		EnumerateCacheGroups();
 	}
 
 	void CPUID::EnumerateCores() {
 		const auto oldAffinity = Threading::GetAffinity();
 
-		LOG("%s: thread affinity %x", __func__, Threading::GetAffinity());
+		LOG("%s: thread affinity %" PRIx64, __func__, Threading::GetAffinity());
 
 		availableProceesorAffinityMask = 0;
 		numLogicalCores = 0;
@@ -142,7 +216,7 @@ namespace springproc {
 		auto& [raw_array, system, badResult] = cpuID.Get();
 
 		Threading::SetAffinity(oldAffinity);
-		LOG("%s: thread affinity %x ...", __func__, Threading::GetAffinity());
+		LOG("%s: thread affinity %" PRIx64 " ...", __func__, Threading::GetAffinity());
 		if (badResult) {
 			LOG_L(L_WARNING, "[CpuId] error: %s", cpuid_error());
 			return;
@@ -165,18 +239,19 @@ namespace springproc {
 			// ignore case PURPOSE_EFFICIENCY:
 			}
 		}
+
+		// the mask can not describe more processors than this anyway
+		numLogicalCores = std::min(numLogicalCores, MAX_PROCESSORS);
 	}
 
 	void CPUID::SetDefault()
 	{
-		numLogicalCores = spring::thread::hardware_concurrency();
+		// affinity masks are uint64_t, so at most MAX_PROCESSORS can be addressed
+		numLogicalCores = std::min(int(spring::thread::hardware_concurrency()), MAX_PROCESSORS);
 		numPhysicalCores = numLogicalCores >> 1; //In 2022 HyperThreading is likely more common rather than not
 		availableProceesorAffinityMask = 1;
 		totalNumPackages = 1;
 
-		// affinity mask is a uint64_t, but spring uses uint32_t
-		assert(numLogicalCores <= MAX_PROCESSORS);
-
 		static_assert(sizeof(affinityMaskOfCores   ) == (MAX_PROCESSORS * sizeof(affinityMaskOfCores   [0])), "");
 		static_assert(sizeof(affinityMaskOfPackages) == (MAX_PROCESSORS * sizeof(affinityMaskOfPackages[0])), "");
 
@@ -185,12 +260,143 @@ namespace springproc {
 		memset(processorApicIds      , 0, sizeof(processorApicIds      ));
 
 		for (int i = 0; i<numLogicalCores; ++i)
-			availableProceesorAffinityMask |= 1 << i;
+			availableProceesorAffinityMask |= (uint64_t(1) << i);
 
 		// failed to determine CPU anatomy, just set affinity mask to (-1)
 		for (int i = 0; i < numLogicalCores; i++) {
 			affinityMaskOfCores[i] = affinityMaskOfPackages[i] = -1;
 		}
+
+		SetDefaultCacheGroups();
+	}
+
+	void CPUID::SetDefaultCacheGroups()
+	{
+		memset(affinityMaskOfCacheGroups, 0, sizeof(affinityMaskOfCacheGroups));
+		memset(threadIndexOfProcessors  , 0, sizeof(threadIndexOfProcessors  ));
+
+		// one group with everything, every processor counts as a physical core
+		numCacheGroups = 1;
+		affinityMaskOfCacheGroups[0] = availableProceesorAffinityMask;
+	}
+
+	void CPUID::EnumerateCacheGroups()
+	{
+		// libcpuid only reports the number of L3 instances, not which
+		// processors share them; ask the OS for the actual mapping
+		int numGroups = 0;
+
+		const auto AddCacheGroup = [&](uint64_t groupMask) {
+			if ((groupMask &= availableProceesorAffinityMask) == 0)
+				return;
+
+			for (int i = 0; i < numGroups; i++) {
+				if (affinityMaskOfCacheGroups[i] == groupMask)
+					return;
+			}
+
+			affinityMaskOfCacheGroups[numGroups++] = groupMask;
+		};
+
+		memset(affinityMaskOfCacheGroups, 0, sizeof(affinityMaskOfCacheGroups));
+
+	#if defined(__linux__)
+		char path[128];
+
+		for (int cpu = 0; cpu < MAX_PROCESSORS; cpu++) {
+			if ((availableProceesorAffinityMask & (uint64_t(1) << cpu)) == 0)
+				continue;
+
+			uint64_t cacheMask = 0;
+			uint64_t coreMask = 0;
+
+			// the last-level cache is the highest level listed for this cpu
+			for (int idx = 0, cacheLevel = 0; ; idx++) {
+				std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/level", cpu, idx);
+
+				const int level = ReadSysInt(path);
+
+				if (level < 0)
+					break;
+				if (level < cacheLevel)
+					continue;
+
+				std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/shared_cpu_list", cpu, idx);
+
+				uint64_t levelMask = 0;
+
+				if (!ReadSysCpuList(path, levelMask))
+					continue;
+
+				cacheLevel = level;
+				cacheMask = levelMask;
+			}
+
+			std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", cpu);
+
+			if (cacheMask == 0 || !ReadSysCpuList(path, coreMask))
+				break;
+
+			threadIndexOfProcessors[cpu] = std::popcount(coreMask & ((uint64_t(1) << cpu) - 1));
+			AddCacheGroup(cacheMask);
+		}
+
+	#elif defined(_WIN32)
+		DWORD size = 0;
+		GetLogicalProcessorInformation(nullptr, &size);
+
+		std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> infos(size / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+
+		if (!infos.empty() && GetLogicalProcessorInformation(infos.data(), &size)) {
+			int cacheLevel = 0;
+
+			for (const auto& info: infos) {
+				if (info.Relationship == RelationCache && info.Cache.Type != CacheInstruction)
+					cacheLevel = std::max(cacheLevel, static_cast<int>(info.Cache.Level));
+			}
+
+			for (const auto& info: infos) {
+				const uint64_t procMask = static_cast<uint64_t>(info.ProcessorMask);
+
+				switch (info.Relationship) {
+					case RelationProcessorCore: {
+						for (int cpu = 0, n = 0; cpu < MAX_PROCESSORS; cpu++) {
+							if ((procMask & (uint64_t(1) << cpu)) != 0)
+								threadIndexOfProcessors[cpu] = n++;
+						}
+					} break;
+					case RelationCache: {
+						if (info.Cache.Level == cacheLevel && info.Cache.Type != CacheInstruction)
+							AddCacheGroup(procMask);
+					} break;
+					default: {
+					} break;
+				}
+			}
+		}
+	#endif
+
+		uint64_t coveredMask = 0;
+
+		for (int i = 0; i < numGroups; i++) {
+			coveredMask |= affinityMaskOfCacheGroups[i];
+		}
+
+		if (numGroups == 0 || coveredMask != availableProceesorAffinityMask) {
+			SetDefaultCacheGroups();
+			return;
+		}
+
+		// order groups by their lowest processor so the layout is the same on every OS
+		std::sort(affinityMaskOfCacheGroups, affinityMaskOfCacheGroups + numGroups, [](uint64_t a, uint64_t b) {
+			return (std::countr_zero(a) < std::countr_zero(b));
+		});
+
+		numCacheGroups = numGroups;
+
+		for (int i = 0; i < numGroups; i++) {
+			LOG("[CpuId] last-level cache group %d: logical cpu mask 0x%" PRIx64, i, affinityMaskOfCacheGroups[i]);
+		}
 	}
 
 }
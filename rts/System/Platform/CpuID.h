@@ -53,15 +53,28 @@ namespace springproc {
 		uint64_t GetCoreAffinityMask(int x) const { return affinityMaskOfCores[x & (MAX_PROCESSORS - 1)]; }
 		uint64_t GetPackageAffinityMask(int x) { return affinityMaskOfPackages[x & (MAX_PROCESSORS - 1)]; }
 
+		/** Number of groups of logical processors that share a last-level
+		    cache (e.g. one per CCX on Zen), ordered by their lowest processor.
+		    A single group holding all processors if the OS does not tell. */
+		int GetNumCacheGroups() const { return numCacheGroups; }
+		uint64_t GetCacheGroupAffinityMask(int x) const { return affinityMaskOfCacheGroups[x & (MAX_PROCESSORS - 1)]; }
+
+		/** Rank of logical processor <x> among the hardware threads of its
+		    physical core, 0 for the first (non-SMT) one. */
+		int GetProcessorThreadIndex(int x) const { return threadIndexOfProcessors[x & (MAX_PROCESSORS - 1)]; }
+
 	private:
 		CPUID();
 
 		void SetDefault();
+		void SetDefaultCacheGroups();
 		void EnumerateCores();
+		void EnumerateCacheGroups();
 
 		int numLogicalCores;
 		int numPhysicalCores;
 		int totalNumPackages;
+		int numCacheGroups;
 
 		static constexpr int MAX_PROCESSORS = 64;
 
@@ -69,8 +82,11 @@ namespace springproc {
 		    core the affinity mask. */
 		uint64_t affinityMaskOfCores[MAX_PROCESSORS];
 		uint64_t affinityMaskOfPackages[MAX_PROCESSORS];
+		uint64_t affinityMaskOfCacheGroups[MAX_PROCESSORS];
 		uint64_t availableProceesorAffinityMask;
 
+		uint8_t threadIndexOfProcessors[MAX_PROCESSORS];
+
 		////////////////////////
 		// Intel specific fields
 
@@ -109,13 +109,13 @@ namespace Threading {
 	 *
 	 * Interpret <cores_bitmask> as a bit-mask indicating on which of the
 	 * available system CPU's (which are numbered logically from 1 to N) we
-	 * want to run. Note that this approach will fail when N > 32.
+	 * want to run. Note that this approach will fail when N > 64.
 	 */
 	void DetectCores();
-	std::uint32_t GetAffinity();
-	std::uint32_t SetAffinity(std::uint32_t cores_bitmask, bool hard = true);
-	void SetAffinityHelper(const char* threadName, std::uint32_t affinity);
-	std::uint32_t GetAvailableCoresMask();
+	std::uint64_t GetAffinity();
+	std::uint64_t SetAffinity(std::uint64_t cores_bitmask, bool hard = true);
+	void SetAffinityHelper(const char* threadName, std::uint64_t affinity);
+	std::uint64_t GetAvailableCoresMask();
 
 	/**
 	 * returns count of cpu cores/ hyperthreadings cores
@@ -848,6 +848,21 @@ bool SpringApp::Update()
 	if (!activeController->Draw())
 		return true;
 	#else
+	if (activeController != nullptr && activeController->UpdateAfterDraw()) {
+		// draw what the previous Update produced and flush it, so the GPU
+		// works through the frame while Update runs the due sim frames
+		auto lock = CLoadLock::GetUniqueLock();
+		swap = activeController->Draw();
+		glFlush();
+
+		lock.unlock();
+		retc = (activeController == nullptr || activeController->Update());
+		lock.lock();
+
+		globalRendering->SwapBuffers(retc && swap, false);
+		return retc;
+	}
+
 	// sic; Update can set the controller to null
 	retc = (        activeController == nullptr || activeController->Update());
 
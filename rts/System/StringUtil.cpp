@@ -245,7 +245,7 @@ std::string utf8::FromUnicode(char32_t ch)
 }
 
 
-#if !defined(UNITSYNC) && !defined(UNIT_TEST) && !defined(BUILDING_AI)
+#if !defined(UNITSYNC) && !defined(BUILDING_AI)
 std::vector<std::uint8_t> zlib::deflate(const std::vector<std::uint8_t>& inflData) { return (zlib::deflate(inflData.data(), inflData.size())); }
 std::vector<std::uint8_t> zlib::deflate(const std::uint8_t* inflData, unsigned long inflSize) {
 	std::vector<std::uint8_t> deflData(compressBound(inflSize));
@@ -232,7 +232,7 @@ namespace utf8 {
 	}
 };
 
-#if !defined(UNITSYNC) && !defined(UNIT_TEST) && !defined(BUILDING_AI)
+#if !defined(UNITSYNC) && !defined(BUILDING_AI)
 namespace zlib {
 	std::vector<std::uint8_t> deflate(const std::uint8_t* inflData, unsigned long inflSize);
 	std::vector<std::uint8_t> inflate(const std::uint8_t* deflData, unsigned long deflSize);
@@ -110,7 +110,7 @@ namespace {
 }
 
 
-void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod, std::optional<bool> outputFloats, bool serverRequest)
+void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod, std::optional<bool> outputFloats, bool serverRequest, uint32_t syncLaneMask)
 {
 	if (outputFloats.has_value())
 		onlyHash = !outputFloats.value();
@@ -182,7 +182,18 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod, std::
 	const auto& activeFeatureIDs = featureHandler.GetActiveFeatureIDs();
 	const auto& projectiles = projectileHandler.GetActiveProjectiles(true);
 
-	file << "frame: " << gs->frameNum << ", seed: " << gsRNG.GetLastSeed() << "\n";
+	// pathing, Lua and RNG have no sections of their own; a mask naming only
+	// those would leave a header-only dump, so fall back to dumping everything
+	constexpr uint32_t sectionLaneMask =
+		(1u << SYNC_LANE_MISC) | (1u << SYNC_LANE_UNITS) | (1u << SYNC_LANE_FEATURES) |
+		(1u << SYNC_LANE_PROJECTILES) | (1u << SYNC_LANE_LOS);
+
+	if ((syncLaneMask & sectionLaneMask) == 0)
+		syncLaneMask = SYNC_LANE_MASK_ALL;
+
+	file << "frame: " << gs->frameNum << ", seed: " << gsRNG.GetLastSeed() << ", syncLaneMask: " << syncLaneMask << "\n";
+
+	const auto DumpLane = [syncLaneMask](SyncLane lane) { return ((syncLaneMask & (1u << lane)) != 0); };
 
 	#define DUMP_MATH_CONST
 	#define DUMP_MODEL_DATA
@@ -205,7 +216,7 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod, std::
 	#define DUMP_SMOOTHMESH_CHECKSUM
 
 	#ifdef DUMP_MATH_CONST
-	if (gs->frameNum == gMinFrameNum) { //dump once
+	if (gs->frameNum == gMinFrameNum && DumpLane(SYNC_LANE_MISC)) { //dump once
 		file << "\tmath constants:\n";
 		#define TAP_MATH_CONST(name) file << "\t\t" << #name << ": " << TapFloats(math::name)
 		TAP_MATH_CONST(PI);
@@ -232,7 +243,7 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod, std::
 	#endif
 
 	#ifdef DUMP_CS_DATA
-	if (gs->frameNum == gMinFrameNum) { //dump once
+	if (gs->frameNum == gMinFrameNum && DumpLane(SYNC_LANE_MISC)) { //dump once
 		sha512::hex_digest hexDigest;
 		{
 			hexDigest = { 0 };
@@ -258,7 +269,7 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod, std::
 	#endif
 
 	#ifdef DUMP_MODEL_DATA
-	if (gs->frameNum == gMinFrameNum) { //dump once
+	if (gs->frameNum == gMinFrameNum && DumpLane(SYNC_LANE_UNITS)) { //dump once
 		// models no longer have same order and IDs across different runs due to MT preload.
 		// Need to sort them to ease comparison
 		std::map<std::string, size_t> sortedModelNames;
@@ -317,337 +328,349 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod, std::
 	}
 	#endif
 
-	file << "\tunits: " << activeUnits.size() << "\n";
-
-	#ifdef DUMP_UNIT_DATA
-	for (const CUnit* u: activeUnits) {
-		const std::vector<CWeapon*>& weapons = u->weapons;
-		const LocalModel& lm = u->localModel;
-		const std::vector<LocalModelPiece>& pieces = lm.pieces;
-
-		const auto& pos  = u->pos;
-		const auto& xdir = u->rightdir;
-		const auto& ydir = u->updir;
-		const auto& zdir = u->frontdir;
-		const auto& speed = u->speed;
-
-		file << "\t\tunitID: " << u->id << " (name: " << u->unitDef->name << ")\n";
-		file << "\t\t\tpos: " << TapFloats(pos);
-		file << "\t\t\tspeed: " << TapFloats(speed);
-		file << "\t\t\txdir: " << TapFloats(xdir);
-		file << "\t\t\tydir: " << TapFloats(ydir);
-		file << "\t\t\tzdir: " << TapFloats(zdir);
-		file << "\t\t\trelMidPos: " << TapFloats(u->relMidPos);
-		file << "\t\t\trelAimPos: " << TapFloats(u->relAimPos);
-		file << "\t\t\tmidPos: " << TapFloats(u->midPos);
-		file << "\t\t\theading: " << int(u->heading) << ", mapSquare: " << u->mapSquare << "\n";
-		file << "\t\t\thealth: " << TapFloats(u->health);
-		file << "\t\t\texperience: " << TapFloats(u->experience);
-		file << "\t\t\tisDead: " << u->isDead << ", activated: " << u->activated << "\n";
-		file << "\t\t\tphysicalState: " << u->physicalState << "\n";
-		file << "\t\t\tfireState: " << u->fireState << ", moveState: " << u->moveState << "\n";
-		file << "\t\t\tpieces: " << pieces.size() << "\n";
-		file << "\t\t\tinBuildStance " << u->inBuildStance << "\n";
-
-		#ifdef DUMP_UNIT_PIECE_DATA
-		for (const LocalModelPiece& lmp: pieces) {
-			const S3DModelPiece* omp = lmp.original;
-			const S3DModelPiece* par = omp->parent;
-			const float3& ppos = lmp.GetPosition();
-			const float3& prot = lmp.GetRotation();
-
-			file << "\t\t\t\tname: " << omp->name << " (parentName: " << ((par != nullptr)? par->name: "[null]") << ")\n";
-			file << "\t\t\t\tpos: " << TapFloats(ppos);
-			file << "\t\t\t\trot: " << TapFloats(prot);
-			file << "\t\t\t\tvisible: " << lmp.GetScriptVisible() << "\n";
-			file << "\n";
-		}
-		#endif
+	if (DumpLane(SYNC_LANE_UNITS)) {
+		file << "\tunits: " << activeUnits.size() << "\n";
+
+		#ifdef DUMP_UNIT_DATA
+		for (const CUnit* u: activeUnits) {
+			const std::vector<CWeapon*>& weapons = u->weapons;
+			const LocalModel& lm = u->localModel;
+			const std::vector<LocalModelPiece>& pieces = lm.pieces;
+
+			const auto& pos  = u->pos;
+			const auto& xdir = u->rightdir;
+			const auto& ydir = u->updir;
+			const auto& zdir = u->frontdir;
+			const auto& speed = u->speed;
+
+			file << "\t\tunitID: " << u->id << " (name: " << u->unitDef->name << ")\n";
+			file << "\t\t\tpos: " << TapFloats(pos);
+			file << "\t\t\tspeed: " << TapFloats(speed);
+			file << "\t\t\txdir: " << TapFloats(xdir);
+			file << "\t\t\tydir: " << TapFloats(ydir);
+			file << "\t\t\tzdir: " << TapFloats(zdir);
+			file << "\t\t\trelMidPos: " << TapFloats(u->relMidPos);
+			file << "\t\t\trelAimPos: " << TapFloats(u->relAimPos);
+			file << "\t\t\tmidPos: " << TapFloats(u->midPos);
+			file << "\t\t\theading: " << int(u->heading) << ", mapSquare: " << u->mapSquare << "\n";
+			file << "\t\t\thealth: " << TapFloats(u->health);
+			file << "\t\t\texperience: " << TapFloats(u->experience);
+			file << "\t\t\tisDead: " << u->isDead << ", activated: " << u->activated << "\n";
+			file << "\t\t\tphysicalState: " << u->physicalState << "\n";
+			file << "\t\t\tfireState: " << u->fireState << ", moveState: " << u->moveState << "\n";
+			file << "\t\t\tpieces: " << pieces.size() << "\n";
+			file << "\t\t\tinBuildStance " << u->inBuildStance << "\n";
+
+			#ifdef DUMP_UNIT_PIECE_DATA
+			for (const LocalModelPiece& lmp: pieces) {
+				const S3DModelPiece* omp = lmp.original;
+				const S3DModelPiece* par = omp->parent;
+				const float3& ppos = lmp.GetPosition();
+				const float3& prot = lmp.GetRotation();
+
+				file << "\t\t\t\tname: " << omp->name << " (parentName: " << ((par != nullptr)? par->name: "[null]") << ")\n";
+				file << "\t\t\t\tpos: " << TapFloats(ppos);
+				file << "\t\t\t\trot: " << TapFloats(prot);
+				file << "\t\t\t\tvisible: " << lmp.GetScriptVisible() << "\n";
+				file << "\n";
+			}
+			#endif
 
-		file << "\t\t\tweapons: " << weapons.size() << "\n";
-
-		#ifdef DUMP_UNIT_WEAPON_DATA
-		for (const CWeapon* w: weapons) {
-			const float3& awp = w->aimFromPos;
-			const float3& rwp = w->relAimFromPos;
-			const float3& amp = w->weaponMuzzlePos;
-			const float3& rmp = w->relWeaponMuzzlePos;
-
-			file << "\t\t\t\tweaponID: " << w->weaponNum << " (name: " << w->weaponDef->name << ")\n";
-			file << "\t\t\t\tweaponDir: " << TapFloats(w->weaponDir);
-			file << "\t\t\t\tabsWeaponPos: " << TapFloats(awp);
-			file << "\t\t\t\trelAimFromPos: " << TapFloats(rwp);
-			file << "\t\t\t\tabsWeaponMuzzlePos: " << TapFloats(amp);
-			file << "\t\t\t\trelWeaponMuzzlePos: " << TapFloats(rmp);
-			file << "\n";
-		}
-		#endif
+			file << "\t\t\tweapons: " << weapons.size() << "\n";
+
+			#ifdef DUMP_UNIT_WEAPON_DATA
+			for (const CWeapon* w: weapons) {
+				const float3& awp = w->aimFromPos;
+				const float3& rwp = w->relAimFromPos;
+				const float3& amp = w->weaponMuzzlePos;
+				const float3& rmp = w->relWeaponMuzzlePos;
+
+				file << "\t\t\t\tweaponID: " << w->weaponNum << " (name: " << w->weaponDef->name << ")\n";
+				file << "\t\t\t\tweaponDir: " << TapFloats(w->weaponDir);
+				file << "\t\t\t\tabsWeaponPos: " << TapFloats(awp);
+				file << "\t\t\t\trelAimFromPos: " << TapFloats(rwp);
+				file << "\t\t\t\tabsWeaponMuzzlePos: " << TapFloats(amp);
+				file << "\t\t\t\trelWeaponMuzzlePos: " << TapFloats(rmp);
+				file << "\n";
+			}
+			#endif
 
-		#ifdef DUMP_UNIT_COMMANDAI_DATA
-		const CCommandAI* cai = u->commandAI;
-		const CCommandQueue& cq = cai->commandQue;
+			#ifdef DUMP_UNIT_COMMANDAI_DATA
+			const CCommandAI* cai = u->commandAI;
+			const CCommandQueue& cq = cai->commandQue;
 
-		file << "\t\t\tcommandAI:\n";
-		file << "\t\t\t\torderTarget->id: " << ((cai->orderTarget != nullptr)? cai->orderTarget->id: -1) << "\n";
-		file << "\t\t\t\tcommandQue.size(): " << cq.size() << "\n";
+			file << "\t\t\tcommandAI:\n";
+			file << "\t\t\t\torderTarget->id: " << ((cai->orderTarget != nullptr)? cai->orderTarget->id: -1) << "\n";
+			file << "\t\t\t\tcommandQue.size(): " << cq.size() << "\n";
 
-		for (const Command& c: cq) {
-			file << "\t\t\t\t\tcommandID: " << c.GetID() << "\n";
-			file << "\t\t\t\t\ttag: " << c.GetTag() << ", options: " << +c.GetOpts() << "\n";
-			file << "\t\t\t\t\tparams: " << c.GetNumParams() << "\n";
+			for (const Command& c: cq) {
+				file << "\t\t\t\t\tcommandID: " << c.GetID() << "\n";
+				file << "\t\t\t\t\ttag: " << c.GetTag() << ", options: " << +c.GetOpts() << "\n";
+				file << "\t\t\t\t\tparams: " << c.GetNumParams() << "\n";
 
-			for (unsigned int n = 0; n < c.GetNumParams(); n++) {
-				file << "\t\t\t\t\t\t" << c.GetParam(n) << "\n";
+				for (unsigned int n = 0; n < c.GetNumParams(); n++) {
+					file << "\t\t\t\t\t\t" << c.GetParam(n) << "\n";
+				}
 			}
+			#endif
+
+			#ifdef DUMP_UNIT_MOVETYPE_DATA
+			const AMoveType* amt = u->moveType;
+			const float3& goalPos = amt->goalPos;
+			const float3& oldUpdatePos = amt->oldPos;
+			const float3& oldSlowUpPos = amt->oldSlowUpdatePos;
+
+			file << "\t\t\tmoveType:\n";
+			file << "\t\t\t\tgoalPos: " << TapFloats(goalPos);
+			file << "\t\t\t\toldUpdatePos: " << TapFloats(oldUpdatePos);
+			file << "\t\t\t\toldSlowUpPos: " << TapFloats(oldSlowUpPos);
+			file << "\t\t\t\tmaxSpeed: " << TapFloats(amt->GetMaxSpeed());
+			file << "\t\t\t\tmaxWantedSpeed: " << TapFloats(amt->GetMaxWantedSpeed());
+			file << "\t\t\t\tprogressState: " << amt->progressState << "\n";
+
+			if (const auto* gmt = dynamic_cast<const CGroundMoveType*>(amt)) {
+				file << "\t\t\t\tCGroundMoveType:\n";
+				file << "\t\t\t\t\tcurrWayPoint: " << TapFloats(gmt->GetCurrWayPoint());
+				file << "\t\t\t\t\tnextWayPoint: " << TapFloats(gmt->GetNextWayPoint());
+			}
+			#endif
+
+			#ifdef DUMP_UNIT_BUILDER_DATA
+			if (const CBuilder* b = dynamic_cast<const CBuilder*>(u); b != nullptr) {
+				file << "\t\t\tThe unit is CBuilder:\n";
+				file << "\t\t\t\tcurResurrect: " << DumpSolidObjectID(b->curResurrect);
+				file << "\t\t\t\tlastResurrected: " << b->lastResurrected << "\n";
+				file << "\t\t\t\tcurBuild: " << DumpSolidObjectID(b->curBuild);
+				file << "\t\t\t\tcurCapture: " << DumpSolidObjectID(b->curCapture);
+				file << "\t\t\t\tcurReclaim: " << DumpSolidObjectID(b->curReclaim);
+				file << "\t\t\t\treclaimingUnit: " << (b->reclaimingUnit ? 1 : 0) << "\n";
+				file << "\t\t\t\thelpTerraform: " << DumpSolidObjectID(b->helpTerraform);
+				file << "\t\t\t\tterraforming: " << (b->terraforming ? 1 : 0) << "\n";
+				file << "\t\t\t\tterraformHelp: " << TapFloats(b->terraformHelp);
+				file << "\t\t\t\tmyTerraformLeft: " << TapFloats(b->myTerraformLeft);
+				file << "\t\t\t\tterraformType: " << std::to_string(b->terraformType) << "\n";
+				file << "\t\t\t\ttx1,tx2,tz1,tz2: " << b->tx1 << "," << b->tx2 << "," << b->tz1 << "," << b->tz2 << "\n";
+				file << "\t\t\t\tterraformCenter: " << TapFloats(b->terraformCenter);
+				file << "\t\t\t\tterraformRadius: " << TapFloats(b->terraformRadius);
+			}
+			#endif
+		}
+		file << "\tunitsToBeRemoved: " << unitHandler.GetUnitsToBeRemoved().size() << "\n";
+		for (auto* u : unitHandler.GetUnitsToBeRemoved()) {
+			file << "\t\tunitID: " << u->id << " (name: " << u->unitDef->name << ")\n";
 		}
 		#endif
+		#ifdef DUMP_UNIT_SCRIPT_DATA
+		{
+			file << "\tCobEngine:\n";
+			file << "\t\tcurrentTime: " << cobEngine->GetCurrTime();
+			file << "\t\tCobThreads: " << cobEngine->GetThreadInstances().size() << "\n";
+			for (const auto& [tid, thread] : cobEngine->GetThreadInstances()) {
+				auto ownerID = thread.cobInst->GetUnit() ? thread.cobInst->GetUnit()->id : -1;
+				file << "\t\t\tid: " << tid << " t.id " << thread.GetID() << " t.wt " << thread.GetWakeTime()
+					 << " owner " << ownerID
+					 << " t.state " << +thread.GetState() << " t.sigmask " << thread.GetSignalMask()
+					 << " t.retc " << thread.GetRetCode()
+					 << " dead|gargage|waiting " << thread.IsDead() << "|" << thread.IsGarbage() << "|" << thread.IsWaiting() << "\n";
+			}
+			file << "\t\tWaitingThreads: " << cobEngine->GetWaitingThreadIDs().size();
+			file << "\t\t\tids:";
+			for (const auto id : cobEngine->GetWaitingThreadIDs()) {
+				file << " " << id;
+			}
+			file << "\n";
 
-		#ifdef DUMP_UNIT_MOVETYPE_DATA
-		const AMoveType* amt = u->moveType;
-		const float3& goalPos = amt->goalPos;
-		const float3& oldUpdatePos = amt->oldPos;
-		const float3& oldSlowUpPos = amt->oldSlowUpdatePos;
-
-		file << "\t\t\tmoveType:\n";
-		file << "\t\t\t\tgoalPos: " << TapFloats(goalPos);
-		file << "\t\t\t\toldUpdatePos: " << TapFloats(oldUpdatePos);
-		file << "\t\t\t\toldSlowUpPos: " << TapFloats(oldSlowUpPos);
-		file << "\t\t\t\tmaxSpeed: " << TapFloats(amt->GetMaxSpeed());
-		file << "\t\t\t\tmaxWantedSpeed: " << TapFloats(amt->GetMaxWantedSpeed());
-		file << "\t\t\t\tprogressState: " << amt->progressState << "\n";
-
-		if (const auto* gmt = dynamic_cast<const CGroundMoveType*>(amt)) {
-			file << "\t\t\t\tCGroundMoveType:\n";
-			file << "\t\t\t\t\tcurrWayPoint: " << TapFloats(gmt->GetCurrWayPoint());
-			file << "\t\t\t\t\tnextWayPoint: " << TapFloats(gmt->GetNextWayPoint());
+			auto zzzThreads = cobEngine->GetSleepingThreadIDs(); //copied on purpose
+			file << "\t\tSleepingThreads: " << zzzThreads.size();
+			file << "\t\t\twts|ids:";
+			while (!zzzThreads.empty()) {
+				const auto& zt = zzzThreads.top();
+				file << " " << zt.wt << "|" << zt.id;
+				zzzThreads.pop();
+			}
+			file << "\n";
 		}
 		#endif
+	}
 
-		#ifdef DUMP_UNIT_BUILDER_DATA
-		if (const CBuilder* b = dynamic_cast<const CBuilder*>(u); b != nullptr) {
-			file << "\t\t\tThe unit is CBuilder:\n";
-			file << "\t\t\t\tcurResurrect: " << DumpSolidObjectID(b->curResurrect);
-			file << "\t\t\t\tlastResurrected: " << b->lastResurrected << "\n";
-			file << "\t\t\t\tcurBuild: " << DumpSolidObjectID(b->curBuild);
-			file << "\t\t\t\tcurCapture: " << DumpSolidObjectID(b->curCapture);
-			file << "\t\t\t\tcurReclaim: " << DumpSolidObjectID(b->curReclaim);
-			file << "\t\t\t\treclaimingUnit: " << (b->reclaimingUnit ? 1 : 0) << "\n";
-			file << "\t\t\t\thelpTerraform: " << DumpSolidObjectID(b->helpTerraform);
-			file << "\t\t\t\tterraforming: " << (b->terraforming ? 1 : 0) << "\n";
-			file << "\t\t\t\tterraformHelp: " << TapFloats(b->terraformHelp);
-			file << "\t\t\t\tmyTerraformLeft: " << TapFloats(b->myTerraformLeft);
-			file << "\t\t\t\tterraformType: " << std::to_string(b->terraformType) << "\n";
-			file << "\t\t\t\ttx1,tx2,tz1,tz2: " << b->tx1 << "," << b->tx2 << "," << b->tz1 << "," << b->tz2 << "\n";
-			file << "\t\t\t\tterraformCenter: " << TapFloats(b->terraformCenter);
-			file << "\t\t\t\tterraformRadius: " << TapFloats(b->terraformRadius);
+	if (DumpLane(SYNC_LANE_FEATURES)) {
+		file << "\tfeatures: " << activeFeatureIDs.size() << "\n";
+
+		#ifdef DUMP_FEATURE_DATA
+		for (const int featureID: activeFeatureIDs) {
+			const CFeature* f = featureHandler.GetFeature(featureID);
+
+			const auto& pos  = f->pos;
+			const auto& xdir = f->rightdir;
+			const auto& ydir = f->updir;
+			const auto& zdir = f->frontdir;
+			const auto& speed = f->speed;
+
+			file << "\t\tfeatureID: " << f->id << " (name: " << f->def->name << ")\n";
+			file << "\t\t\tpos: " << TapFloats(pos);
+			file << "\t\t\tspeed: " << TapFloats(speed);
+			file << "\t\t\txdir: " << TapFloats(xdir);
+			file << "\t\t\tydir: " << TapFloats(ydir);
+			file << "\t\t\tzdir: " << TapFloats(zdir);
+			file << "\t\t\trelMidPos: " << TapFloats(f->relMidPos);
+			file << "\t\t\trelAimPos: " << TapFloats(f->relAimPos);
+			file << "\t\t\tmidPos: " << TapFloats(f->midPos);
+			file << "\t\t\thealth: " << TapFloats(f->health);
+			file << "\t\t\treclaimLeft: " << TapFloats(f->reclaimLeft);
 		}
 		#endif
 	}
-	file << "\tunitsToBeRemoved: " << unitHandler.GetUnitsToBeRemoved().size() << "\n";
-	for (auto* u : unitHandler.GetUnitsToBeRemoved()) {
-		file << "\t\tunitID: " << u->id << " (name: " << u->unitDef->name << ")\n";
-	}
-	#endif
-	#ifdef DUMP_UNIT_SCRIPT_DATA
-	{
-		file << "\tCobEngine:\n";
-		file << "\t\tcurrentTime: " << cobEngine->GetCurrTime();
-		file << "\t\tCobThreads: " << cobEngine->GetThreadInstances().size() << "\n";
-		for (const auto& [tid, thread] : cobEngine->GetThreadInstances()) {
-			auto ownerID = thread.cobInst->GetUnit() ? thread.cobInst->GetUnit()->id : -1;
-			file << "\t\t\tid: " << tid << " t.id " << thread.GetID() << " t.wt " << thread.GetWakeTime()
-				 << " owner " << ownerID
-				 << " t.state " << +thread.GetState() << " t.sigmask " << thread.GetSignalMask()
-				 << " t.retc " << thread.GetRetCode()
-				 << " dead|gargage|waiting " << thread.IsDead() << "|" << thread.IsGarbage() << "|" << thread.IsWaiting() << "\n";
-		}
-		file << "\t\tWaitingThreads: " << cobEngine->GetWaitingThreadIDs().size();
-		file << "\t\t\tids:";
-		for (const auto id : cobEngine->GetWaitingThreadIDs()) {
-			file << " " << id;
-		}
-		file << "\n";
 
-		auto zzzThreads = cobEngine->GetSleepingThreadIDs(); //copied on purpose
-		file << "\t\tSleepingThreads: " << zzzThreads.size();
-		file << "\t\t\twts|ids:";
-		while (!zzzThreads.empty()) {
-			const auto& zt = zzzThreads.top();
-			file << " " << zt.wt << "|" << zt.id;
-			zzzThreads.pop();
+	if (DumpLane(SYNC_LANE_PROJECTILES)) {
+		file << "\tprojectiles: " << projectiles.size() << "\n";
+
+		#ifdef DUMP_PROJECTILE_DATA
+		for (const CProjectile* p: projectiles) {
+			file << "\t\tprojectileID: " << p->id << "\n";
+			file << "\t\t\tpos: <" << TapFloats(p->pos);
+			file << "\t\t\tdir: <" << TapFloats(p->dir);
+			file << "\t\t\tspeed: <" << TapFloats(p->speed);
+			file << "\t\t\tweapon: " << p->weapon << ", piece: " << p->piece << "\n";
+			file << "\t\t\tcheckCol: " << p->checkCol << ", deleteMe: " << p->deleteMe << "\n";
 		}
-		file << "\n";
+		#endif
 	}
-	#endif
 
-	file << "\tfeatures: " << activeFeatureIDs.size() << "\n";
-
-	#ifdef DUMP_FEATURE_DATA
-	for (const int featureID: activeFeatureIDs) {
-		const CFeature* f = featureHandler.GetFeature(featureID);
-
-		const auto& pos  = f->pos;
-		const auto& xdir = f->rightdir;
-		const auto& ydir = f->updir;
-		const auto& zdir = f->frontdir;
-		const auto& speed = f->speed;
-
-		file << "\t\tfeatureID: " << f->id << " (name: " << f->def->name << ")\n";
-		file << "\t\t\tpos: " << TapFloats(pos);
-		file << "\t\t\tspeed: " << TapFloats(speed);
-		file << "\t\t\txdir: " << TapFloats(xdir);
-		file << "\t\t\tydir: " << TapFloats(ydir);
-		file << "\t\t\tzdir: " << TapFloats(zdir);
-		file << "\t\t\trelMidPos: " << TapFloats(f->relMidPos);
-		file << "\t\t\trelAimPos: " << TapFloats(f->relAimPos);
-		file << "\t\t\tmidPos: " << TapFloats(f->midPos);
-		file << "\t\t\thealth: " << TapFloats(f->health);
-		file << "\t\t\treclaimLeft: " << TapFloats(f->reclaimLeft);
+	if (DumpLane(SYNC_LANE_MISC)) {
+		file << "\tteams: " << teamHandler.ActiveTeams() << "\n";
+
+		#ifdef DUMP_TEAM_DATA
+		for (int a = 0; a < teamHandler.ActiveTeams(); ++a) {
+			const CTeam* t = teamHandler.Team(a);
+
+			file << "\t\tteamID: " << t->teamNum << " (controller: " << t->GetControllerName() << ")\n";
+			file << "\t\t\tmetal: " << TapFloats(t->res.metal);
+			file << "\t\t\tenergy: " << TapFloats(t->res.energy);
+			file << "\t\t\tmetalPull: " << TapFloats(t->resPull.metal);
+			file << "\t\t\tenergyPull: " << TapFloats(t->resPull.energy);
+			file << "\t\t\tmetalIncome: " << TapFloats(t->resIncome.metal);
+			file << "\t\t\tenergyIncome: " << TapFloats(t->resIncome.energy);
+			file << "\t\t\tmetalExpense: " << TapFloats(t->resExpense.metal);
+			file << "\t\t\tenergyExpense: " << TapFloats(t->resExpense.energy);
+		}
+		#endif
 	}
-	#endif
 
-	file << "\tprojectiles: " << projectiles.size() << "\n";
+	if (DumpLane(SYNC_LANE_LOS)) {
+		file << "\tallyteams: " << teamHandler.ActiveAllyTeams() << "\n";
+
+		std::array<ILosType*, 7> losTypes = {
+			&losHandler->los,
+			&losHandler->airLos,
+			&losHandler->radar,
+			&losHandler->sonar,
+			&losHandler->seismic,
+			&losHandler->jammer,
+			&losHandler->sonarJammer
+		};
+		#if defined(DUMP_ALLYTEAM_DATA) || defined(DUMP_ALLYTEAM_DATA_CHECKSUM)
+		for (int a = 0; a < teamHandler.ActiveAllyTeams(); ++a) {
+			file << "\t\tallyteamID: " << a << "\n";
+
+			for (int lti = 0; lti < losTypes.size(); ++lti) {
+				file << "\t\t\tLOS-map type:" << lti << "\n";
+				const auto lt = losTypes[lti];
+				const auto* lm = &lt->losMaps[a].front();
+
+				#ifdef DUMP_ALLYTEAM_DATA
+				file << "\t\t\t\t";
+				for (unsigned int i = 0; i < (lt->size.x * lt->size.y); i++) {
+					file << lm[i] << " ";
+				}
+				file << "\n";
+				#endif
 
-	#ifdef DUMP_PROJECTILE_DATA
-	for (const CProjectile* p: projectiles) {
-		file << "\t\tprojectileID: " << p->id << "\n";
-		file << "\t\t\tpos: <" << TapFloats(p->pos);
-		file << "\t\t\tdir: <" << TapFloats(p->dir);
-		file << "\t\t\tspeed: <" << TapFloats(p->speed);
-		file << "\t\t\tweapon: " << p->weapon << ", piece: " << p->piece << "\n";
-		file << "\t\t\tcheckCol: " << p->checkCol << ", deleteMe: " << p->deleteMe << "\n";
+				#ifdef DUMP_ALLYTEAM_DATA_CHECKSUM
+				uint32_t adCs = 0;
+				for (unsigned int i = 0; i < (lt->size.x * lt->size.y); i++) {
+					adCs = spring::LiteHash(lm[i], adCs);
+				}
+				file << "\t\t\t\thash: " << adCs << "\n";
+				#endif
+			}
+		}
+		#endif
 	}
-	#endif
 
-	file << "\tteams: " << teamHandler.ActiveTeams() << "\n";
-
-	#ifdef DUMP_TEAM_DATA
-	for (int a = 0; a < teamHandler.ActiveTeams(); ++a) {
-		const CTeam* t = teamHandler.Team(a);
-
-		file << "\t\tteamID: " << t->teamNum << " (controller: " << t->GetControllerName() << ")\n";
-		file << "\t\t\tmetal: " << TapFloats(t->res.metal);
-		file << "\t\t\tenergy: " << TapFloats(t->res.energy);
-		file << "\t\t\tmetalPull: " << TapFloats(t->resPull.metal);
-		file << "\t\t\tenergyPull: " << TapFloats(t->resPull.energy);
-		file << "\t\t\tmetalIncome: " << TapFloats(t->resIncome.metal);
-		file << "\t\t\tenergyIncome: " << TapFloats(t->resIncome.energy);
-		file << "\t\t\tmetalExpense: " << TapFloats(t->resExpense.metal);
-		file << "\t\t\tenergyExpense: " << TapFloats(t->resExpense.energy);
-	}
-	#endif
+	if (DumpLane(SYNC_LANE_MISC)) {
+		const auto heightmap = readMap->GetCornerHeightMapSynced();
+		const auto centerNormals = readMap->GetCenterNormalsSynced();
+		const auto faceNormals = readMap->GetFaceNormalsSynced();
+		#ifdef DUMP_HEIGHTMAP
+		file << "\theightmap as uint32t: " << "\n";
+		file << "\t\t";
+		for (unsigned int i = 0; i < (mapDims.mapxp1 * mapDims.mapyp1); i++) {
+			file << *reinterpret_cast<const uint32_t*>(&heightmap[i]) << " ";
+		}
+		file << "\n";
 
-	file << "\tallyteams: " << teamHandler.ActiveAllyTeams() << "\n";
+		file << "\tcenterNormals as uint32t: " << "\n";
+		file << "\t\t";
+		for (unsigned int i = 0; i < (mapDims.mapx * mapDims.mapy); i++) {
+			file << *reinterpret_cast<const uint32_t*>(&centerNormals[i].x) << " ";
+			file << *reinterpret_cast<const uint32_t*>(&centerNormals[i].y) << " ";
+			file << *reinterpret_cast<const uint32_t*>(&centerNormals[i].z) << " ";
+		}
+		file << "\n";
 
-	std::array<ILosType*, 7> losTypes = {
-		&losHandler->los,
-		&losHandler->airLos,
-		&losHandler->radar,
-		&losHandler->sonar,
-		&losHandler->seismic,
-		&losHandler->jammer,
-		&losHandler->sonarJammer
-	};
-	#if defined(DUMP_ALLYTEAM_DATA) || defined(DUMP_ALLYTEAM_DATA_CHECKSUM)
-	for (int a = 0; a < teamHandler.ActiveAllyTeams(); ++a) {
-		file << "\t\tallyteamID: " << a << "\n";
-
-		for (int lti = 0; lti < losTypes.size(); ++lti) {
-			file << "\t\t\tLOS-map type:" << lti << "\n";
-			const auto lt = losTypes[lti];
-			const auto* lm = &lt->losMaps[a].front();
-
-			#ifdef DUMP_ALLYTEAM_DATA
-			file << "\t\t\t\t";
-			for (unsigned int i = 0; i < (lt->size.x * lt->size.y); i++) {
-				file << lm[i] << " ";
-			}
-			file << "\n";
-			#endif
+		file << "\tfaceNormals as uint32t: " << "\n";
+		file << "\t\t";
+		for (unsigned int i = 0; i < (mapDims.mapx * mapDims.mapy); i++) {
+			file << *reinterpret_cast<const uint32_t*>(&faceNormals[i + 0].x) << " ";
+			file << *reinterpret_cast<const uint32_t*>(&faceNormals[i + 0].y) << " ";
+			file << *reinterpret_cast<const uint32_t*>(&faceNormals[i + 0].z) << " ";
 
-			#ifdef DUMP_ALLYTEAM_DATA_CHECKSUM
-			uint32_t adCs = 0;
-			for (unsigned int i = 0; i < (lt->size.x * lt->size.y); i++) {
-				adCs = spring::LiteHash(lm[i], adCs);
-			}
-			file << "\t\t\t\thash: " << adCs << "\n";
-			#endif
+			file << *reinterpret_cast<const uint32_t*>(&faceNormals[i + 1].x) << " ";
+			file << *reinterpret_cast<const uint32_t*>(&faceNormals[i + 1].y) << " ";
+			file << *reinterpret_cast<const uint32_t*>(&faceNormals[i + 1].z) << " ";
 		}
-	}
-	#endif
-
-	const auto heightmap = readMap->GetCornerHeightMapSynced();
-	const auto centerNormals = readMap->GetCenterNormalsSynced();
-	const auto faceNormals = readMap->GetFaceNormalsSynced();
-	#ifdef DUMP_HEIGHTMAP
-	file << "\theightmap as uint32t: " << "\n";
-	file << "\t\t";
-	for (unsigned int i = 0; i < (mapDims.mapxp1 * mapDims.mapyp1); i++) {
-		file << *reinterpret_cast<const uint32_t*>(&heightmap[i]) << " ";
-	}
-	file << "\n";
-
-	file << "\tcenterNormals as uint32t: " << "\n";
-	file << "\t\t";
-	for (unsigned int i = 0; i < (mapDims.mapx * mapDims.mapy); i++) {
-		file << *reinterpret_cast<const uint32_t*>(&centerNormals[i].x) << " ";
-		file << *reinterpret_cast<const uint32_t*>(&centerNormals[i].y) << " ";
-		file << *reinterpret_cast<const uint32_t*>(&centerNormals[i].z) << " ";
-	}
-	file << "\n";
-
-	file << "\tfaceNormals as uint32t: " << "\n";
-	file << "\t\t";
-	for (unsigned int i = 0; i < (mapDims.mapx * mapDims.mapy); i++) {
-		file << *reinterpret_cast<const uint32_t*>(&faceNormals[i + 0].x) << " ";
-		file << *reinterpret_cast<const uint32_t*>(&faceNormals[i + 0].y) << " ";
-		file << *reinterpret_cast<const uint32_t*>(&faceNormals[i + 0].z) << " ";
-
-		file << *reinterpret_cast<const uint32_t*>(&faceNormals[i + 1].x) << " ";
-		file << *reinterpret_cast<const uint32_t*>(&faceNormals[i + 1].y) << " ";
-		file << *reinterpret_cast<const uint32_t*>(&faceNormals[i + 1].z) << " ";
-	}
-	file << "\n";
+		file << "\n";
 
-	#endif
+		#endif
 
-	#ifdef DUMP_HEIGHTMAP_CHECKSUM
-	uint32_t hmCs = 0;
-	uint32_t cnCs = 0;
-	uint32_t fnCs = 0;
-	for (unsigned int i = 0; i < (mapDims.mapxp1 * mapDims.mapyp1); i++) {
-		hmCs = spring::LiteHash(heightmap[i], hmCs);
-	}
-	for (unsigned int i = 0; i < (mapDims.mapx * mapDims.mapy); i++) {
-		cnCs = spring::LiteHash(centerNormals[i], cnCs);
-	}
-	for (unsigned int i = 0; i < (mapDims.mapx * mapDims.mapy); i++) {
-		fnCs = spring::LiteHash(faceNormals[i + 0], fnCs);
-		fnCs = spring::LiteHash(faceNormals[i + 1], fnCs);
-	}
+		#ifdef DUMP_HEIGHTMAP_CHECKSUM
+		uint32_t hmCs = 0;
+		uint32_t cnCs = 0;
+		uint32_t fnCs = 0;
+		for (unsigned int i = 0; i < (mapDims.mapxp1 * mapDims.mapyp1); i++) {
+			hmCs = spring::LiteHash(heightmap[i], hmCs);
+		}
+		for (unsigned int i = 0; i < (mapDims.mapx * mapDims.mapy); i++) {
+			cnCs = spring::LiteHash(centerNormals[i], cnCs);
+		}
+		for (unsigned int i = 0; i < (mapDims.mapx * mapDims.mapy); i++) {
+			fnCs = spring::LiteHash(faceNormals[i + 0], fnCs);
+			fnCs = spring::LiteHash(faceNormals[i + 1], fnCs);
+		}
 
-	file << "\theightmap checksum as uint32t: " << hmCs << "\n";
-	file << "\tcenterNormals checksum as uint32t: " << cnCs << "\n";
-	file << "\tfaceNormals checksum as uint32t: " << fnCs << "\n";
-	#endif
+		file << "\theightmap checksum as uint32t: " << hmCs << "\n";
+		file << "\tcenterNormals checksum as uint32t: " << cnCs << "\n";
+		file << "\tfaceNormals checksum as uint32t: " << fnCs << "\n";
+		#endif
 
-	const auto smoothMesh = smoothGround.GetMeshData();
-	#ifdef DUMP_SMOOTHMESH
-	file << "\tsmoothMesh as uint32t: " << "\n";
-	file << "\t\t";
-	for (unsigned int i = 0; i < (smoothGround.GetMaxX() * smoothGround.GetMaxY()); i++) {
-		file << *reinterpret_cast<const uint32_t*>(&smoothMesh[i]) << " ";
-	}
-	file << "\n";
-	#endif
+		const auto smoothMesh = smoothGround.GetMeshData();
+		#ifdef DUMP_SMOOTHMESH
+		file << "\tsmoothMesh as uint32t: " << "\n";
+		file << "\t\t";
+		for (unsigned int i = 0; i < (smoothGround.GetMaxX() * smoothGround.GetMaxY()); i++) {
+			file << *reinterpret_cast<const uint32_t*>(&smoothMesh[i]) << " ";
+		}
+		file << "\n";
+		#endif
 
-	#ifdef DUMP_SMOOTHMESH_CHECKSUM
-	uint32_t smCs = 0;
-	for (unsigned int i = 0; i < (smoothGround.GetMaxX() * smoothGround.GetMaxY()); i++) {
-		smCs = spring::LiteHash(smoothMesh[i], smCs);
+		#ifdef DUMP_SMOOTHMESH_CHECKSUM
+		uint32_t smCs = 0;
+		for (unsigned int i = 0; i < (smoothGround.GetMaxX() * smoothGround.GetMaxY()); i++) {
+			smCs = spring::LiteHash(smoothMesh[i], smCs);
+		}
+		file << "\tsmoothMesh checksum as uint32t: " << smCs << "\n";
+		#endif
 	}
-	file << "\tsmoothMesh checksum as uint32t: " << smCs << "\n";
-	#endif
 
 	file.flush();
 	if (gs->frameNum == gMaxFrameNum)
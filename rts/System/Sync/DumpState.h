@@ -5,7 +5,10 @@
 
 #include <optional>
 
-extern void DumpState(int startFrameNum, int endFrameNum, int newFramePeriod, std::optional<bool> outputFloats, bool serverRequest = false);
+#include "System/Sync/SyncChecker.h"
+
+/// <syncLaneMask> restricts the dump to the parts of the game state owned by the given SyncLane's
+extern void DumpState(int startFrameNum, int endFrameNum, int newFramePeriod, std::optional<bool> outputFloats, bool serverRequest = false, uint32_t syncLaneMask = SYNC_LANE_MASK_ALL);
 extern void DumpRNG(int startFrameNum, int endFrameNum);
 
 #endif /* DUMPSTATE_H */
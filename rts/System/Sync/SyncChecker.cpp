@@ -9,9 +9,30 @@
 #include "System/Threading/ThreadPool.h"
 
 
-unsigned CSyncChecker::g_checksum;
+SyncLaneChecksums CSyncChecker::g_laneChecksums;
+SyncLane CSyncChecker::g_curLane = SYNC_LANE_MISC;
 int CSyncChecker::inSyncedCode;
 
+std::array<SyncLaneChecksums, CSyncChecker::LANE_HISTORY_SIZE> CSyncChecker::g_laneHistory;
+std::array<int, CSyncChecker::LANE_HISTORY_SIZE> CSyncChecker::g_laneHistoryFrames;
+
+
+void CSyncChecker::SaveLaneHistory(int frameNum)
+{
+	g_laneHistory[frameNum % LANE_HISTORY_SIZE] = g_laneChecksums;
+	// stored off-by-one so the zero-initialized slots never match
+	g_laneHistoryFrames[frameNum % LANE_HISTORY_SIZE] = frameNum + 1;
+}
+
+bool CSyncChecker::GetLaneHistory(int frameNum, SyncLaneChecksums& laneChecksums)
+{
+	if (frameNum < 0 || g_laneHistoryFrames[frameNum % LANE_HISTORY_SIZE] != (frameNum + 1))
+		return false;
+
+	laneChecksums = g_laneHistory[frameNum % LANE_HISTORY_SIZE];
+	return true;
+}
+
 
 void CSyncChecker::debugSyncCheckThreading()
 {
@@ -3,6 +3,43 @@
 #ifndef SYNCCHECKER_H
 #define SYNCCHECKER_H
 
+#include <array>
+#include <cstdint>
+
+/**
+ * Sync-checksum lanes. Synced assignments are folded into the lane of the
+ * SimFrame stage performing them (e.g. a projectile damaging a unit counts
+ * towards SYNC_LANE_PROJECTILES), so a desync can be narrowed down to one
+ * subsystem without dumping the entire game state.
+ */
+enum SyncLane {
+	SYNC_LANE_MISC        = 0, // net-commands, map, teams, everything not below
+	SYNC_LANE_UNITS       = 1,
+	SYNC_LANE_FEATURES    = 2,
+	SYNC_LANE_PROJECTILES = 3,
+	SYNC_LANE_PATHING     = 4,
+	SYNC_LANE_LOS         = 5,
+	SYNC_LANE_LUA         = 6,
+	SYNC_LANE_RNG         = 7,
+	SYNC_LANE_COUNT       = 8,
+};
+
+static constexpr uint32_t SYNC_LANE_MASK_ALL = (1u << SYNC_LANE_COUNT) - 1;
+
+using SyncLaneChecksums = std::array<uint32_t, SYNC_LANE_COUNT>;
+
+static inline const char* GetSyncLaneName(unsigned int lane) {
+	constexpr const char* names[SYNC_LANE_COUNT] = {"misc", "units", "features", "projectiles", "pathing", "los", "lua", "rng"};
+	return ((lane < SYNC_LANE_COUNT)? names[lane]: "???");
+}
+
+#ifdef SYNCCHECK
+	#define SCOPED_SYNC_LANE(lane) CSyncChecker::ScopedLane scopedSyncLane(lane)
+#else
+	#define SCOPED_SYNC_LANE(lane)
+#endif
+
+
 #ifdef SYNCCHECK
 
 #include "System/SpringHash.h"
@@ -28,8 +65,9 @@ class CSyncChecker {
 		/**
 		 * Keeps a running checksum over all assignments to synced variables.
 		 */
-		static unsigned GetChecksum() { return g_checksum; }
-		static void NewFrame() { g_checksum = 0xfade1eaf; }
+		static unsigned GetChecksum() { return spring::LiteHash(g_laneChecksums.data(), sizeof(g_laneChecksums), 0); }
+		static const SyncLaneChecksums& GetLaneChecksums() { return g_laneChecksums; }
+		static void NewFrame() { g_laneChecksums.fill(0xfade1eaf); }
 		static void debugSyncCheckThreading();
 		static void Sync(const void* p, unsigned size) {
 #ifdef DEBUG_SYNC_MT_CHECK
@@ -38,16 +76,36 @@ class CSyncChecker {
 #endif
 			// most common cases first, make it easy for compiler to optimize for it
 			// simple xor is not enough to detect multiple zeroes, e.g.
-			g_checksum = spring::LiteHash(p, size, g_checksum);
-			//LOG("[Sync::Checker] chksum=%u\n", g_checksum);
+			g_laneChecksums[g_curLane] = spring::LiteHash(p, size, g_laneChecksums[g_curLane]);
+			//LOG("[Sync::Checker] chksum=%u\n", g_laneChecksums[g_curLane]);
 		}
 
+		/**
+		 * Remembers the lane checksums of the last LANE_HISTORY_SIZE frames
+		 * so they can still be inspected once the server detects a desync.
+		 */
+		static void SaveLaneHistory(int frameNum);
+		static bool GetLaneHistory(int frameNum, SyncLaneChecksums& laneChecksums);
+
+		class ScopedLane {
+		public:
+			ScopedLane(SyncLane lane): prevLane(g_curLane) { g_curLane = lane; }
+			~ScopedLane() { g_curLane = prevLane; }
+		private:
+			SyncLane prevLane;
+		};
+
 	private:
+		static constexpr unsigned LANE_HISTORY_SIZE = 512;
 
 		/**
-		 * The sync checksum
+		 * The per-lane sync checksums, GetChecksum combines them
 		 */
-		static unsigned g_checksum;
+		static SyncLaneChecksums g_laneChecksums;
+		static SyncLane g_curLane;
+
+		static std::array<SyncLaneChecksums, LANE_HISTORY_SIZE> g_laneHistory;
+		static std::array<int, LANE_HISTORY_SIZE> g_laneHistoryFrames;
 
 		/**
 		 * @brief in synced code
@@ -62,7 +62,7 @@ struct ThreadStats {
 static std::vector< spring::thread > extThreads;
 static std::vector< std::future<void> > extFutures;
 
-bool ThreadPool::inMultiThreadedSection;
+std::atomic_int ThreadPool::inMultiThreadedSection = {0};
 
 // global [idx = 0] and smaller per-thread [idx > 0] queues; the latter are
 // for tasks that want to execute on specific threads, e.g. parallel_reduce
@@ -417,28 +417,44 @@ static void KillThreads(int wantedNumThreads, int curNumThreads)
 }
 
 
-static std::uint32_t FindWorkerThreadCore(std::int32_t index, std::uint32_t availCores, std::uint32_t avoidCores)
+static std::uint64_t FindWorkerThreadCore(std::int32_t index, std::uint64_t availCores, std::uint64_t avoidCores)
 {
 	// find an unused core for worker-thread <index>
-	const auto FindCore = [&index](std::uint32_t targetCores) {
-		std::uint32_t workerCore = 1;
+	// cores are handed out one last-level cache group after another so that
+	// neighbouring workers (which steal from each other first) share an L3,
+	// and SMT siblings are only used once every physical core has a worker
+	const auto FindCore = [&index](std::uint64_t targetCores) -> std::uint64_t {
+		const springproc::CPUID& cpuid = springproc::CPUID::GetInstance();
+
 		std::int32_t n = index;
+		std::int32_t maxThreadIndex = 0;
+
+		for (int threadIndex = 0; threadIndex <= maxThreadIndex; threadIndex++) {
+			for (int group = 0; group < cpuid.GetNumCacheGroups(); group++) {
+				const std::uint64_t groupCores = targetCores & cpuid.GetCacheGroupAffinityMask(group);
+
+				for (int core = 0; core < 64; core++) {
+					const std::uint64_t workerCore = std::uint64_t(1) << core;
+
+					if ((groupCores & workerCore) == 0)
+						continue;
 
-		while ((workerCore != 0) && !(workerCore & targetCores))
-			workerCore <<= 1;
+					maxThreadIndex = std::max(maxThreadIndex, cpuid.GetProcessorThreadIndex(core));
 
-		// select n'th bit in targetCores
-		// counts down because hyper-thread cores are appended to the end
-		// and we prefer those for our worker threads (physical cores are
-		// preferred for task specific threads)
-		while (n--)
-			do workerCore <<= 1; while ((workerCore != 0) && !(workerCore & targetCores));
+					if (cpuid.GetProcessorThreadIndex(core) != threadIndex)
+						continue;
+
+					if ((n--) == 0)
+						return workerCore;
+				}
+			}
+		}
 
-		return workerCore;
+		return 0;
 	};
 
-	const std::uint32_t threadAvailCore = FindCore(availCores);
-	const std::uint32_t threadAvoidCore = FindCore(avoidCores);
+	const std::uint64_t threadAvailCore = FindCore(availCores);
+	const std::uint64_t threadAvoidCore = FindCore(avoidCores);
 
 	if (threadAvailCore != 0)
 		return threadAvailCore;
@@ -447,7 +463,7 @@ static std::uint32_t FindWorkerThreadCore(std::int32_t index, std::uint32_t avai
 		return threadAvoidCore;
 
 	// fallback; use all
-	return (~0u);
+	return (~std::uint64_t(0));
 }
 
 
@@ -586,30 +602,30 @@ void SetMaximumThreadCount()
 
 void SetDefaultThreadCount()
 {
-	std::uint32_t systemCores  = springproc::CPUID::GetInstance().GetAvailableProceesorAffinityMask();
-	std::uint32_t mainAffinity = systemCores;
+	std::uint64_t systemCores  = springproc::CPUID::GetInstance().GetAvailableProceesorAffinityMask();
+	std::uint64_t mainAffinity = systemCores;
 
 	#ifndef UNIT_TEST
 	mainAffinity &= configHandler->GetUnsigned("SetCoreAffinity");
 	#endif
 
-	std::uint32_t workerAvailCores = systemCores & ~mainAffinity;
+	std::uint64_t workerAvailCores = systemCores & ~mainAffinity;
 
 	SetThreadCount(GetDefaultNumWorkers());
 
 	{
 		// parallel_reduce now folds over shared_ptrs to futures
-		// const auto ReduceFunc = [](std::uint32_t a, std::future<std::uint32_t>& b) -> std::uint32_t { return (a | b.get()); };
-		const auto ReduceFunc = [](std::uint32_t a, std::shared_ptr< std::future<std::uint32_t> >& b) -> std::uint32_t { return (a | (b.get())->get()); };
-		const auto AffinityFunc = [&]() -> std::uint32_t {
+		// const auto ReduceFunc = [](std::uint64_t a, std::future<std::uint64_t>& b) -> std::uint64_t { return (a | b.get()); };
+		const auto ReduceFunc = [](std::uint64_t a, std::shared_ptr< std::future<std::uint64_t> >& b) -> std::uint64_t { return (a | (b.get())->get()); };
+		const auto AffinityFunc = [&]() -> std::uint64_t {
 			const int i = ThreadPool::GetThreadNum();
 
 			// 0 is the source thread, skip
 			if (i == 0)
 				return 0;
 
-			const std::uint32_t workerCore = FindWorkerThreadCore(i - 1, workerAvailCores, mainAffinity);
-			// const std::uint32_t workerCore = workerAvailCores;
+			const std::uint64_t workerCore = FindWorkerThreadCore(i - 1, workerAvailCores, mainAffinity);
+			// const std::uint64_t workerCore = workerAvailCores;
 
 			char threadName[20];
 			std::snprintf(threadName, sizeof(threadName), "Worker %d", i);
@@ -618,8 +634,8 @@ void SetDefaultThreadCount()
 			return workerCore;
 		};
 
-		const std::uint32_t poolCoreAffinity = parallel_reduce(AffinityFunc, ReduceFunc);
-		const std::uint32_t mainCoreAffinity = Threading::HasHyperThreading() ? ~poolCoreAffinity : ~0;
+		const std::uint64_t poolCoreAffinity = parallel_reduce(AffinityFunc, ReduceFunc);
+		const std::uint64_t mainCoreAffinity = Threading::HasHyperThreading() ? ~poolCoreAffinity : ~std::uint64_t(0);
 
 		if (mainAffinity == 0)
 			mainAffinity = systemCores;
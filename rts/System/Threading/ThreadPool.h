@@ -72,6 +72,8 @@ static inline auto parallel_reduce(F&& f, G&& g) -> std::invoke_result_t<F>
 #include <vector>
 #include <numeric>
 #include <atomic>
+#include <algorithm>
+#include <cstdint>
 
 #undef gt
 #include <memory>
@@ -109,9 +111,17 @@ namespace ThreadPool {
 	int GetNumThreads();
 	void NotifyWorkerThreads(bool force, bool async);
 
-	extern bool inMultiThreadedSection;
+	// nesting depth of running for_mt calls
+	extern std::atomic_int inMultiThreadedSection;
 
+	// upper bound on pool size, including the main thread; sizes the
+	// per-thread slots of every CWorldObject, so raise it only for builds
+	// that run on machines with more hardware threads (see CMakeLists.txt)
+	#ifdef THREADPOOL_MAX_THREADS
+	static constexpr int MAX_THREADS = THREADPOOL_MAX_THREADS;
+	#else
 	static constexpr int MAX_THREADS = 32;
+	#endif
 }
 
 
@@ -594,23 +604,30 @@ private:
 
 #else
 
+// each thread owns a contiguous range of iterations [begin, end) packed into
+// one word; it pops from the front of its own range and, once that is empty,
+// steals the back half of another thread's range, so uneven per-iteration
+// costs get rebalanced without every thread contending on a shared counter
 template<typename F>
 class ForTaskGroup: public ITaskGroup
 {
 public:
-	typedef  TTaskGroup<F, void, int>  ChildTaskType;
-
 	ForTaskGroup(bool pooled) : ITaskGroup(false, pooled) {}
 
 	void Enqueue(const int from, const int to, const int step, F& func)
 	{
 		assert(to >= from);
 
-		remainingTasks.store((step == 1) ? (to - from) : ((to - from + step - 1) / step));
-		ctr.store(0);
+		const int numIters = (step == 1) ? (to - from) : ((to - from + step - 1) / step);
+
+		remainingTasks.store(numIters);
+		numRanges = std::clamp(ThreadPool::GetNumThreads(), 1, ThreadPool::MAX_THREADS);
+
+		for (int i = 0; i < numRanges; i++) {
+			ranges[i].store(PackRange((numIters * int64_t(i)) / numRanges, (numIters * int64_t(i + 1)) / numRanges));
+		}
 
 		this->from = from;
-		this->to   = to;
 		this->step = step;
 		this->func = func;
 	}
@@ -618,23 +635,78 @@ public:
 	bool IsSliceTask() const override { return true; }
 	bool ExecuteStep() override
 	{
-		const int i = from + (step * ctr.fetch_add(1, std::memory_order_relaxed));
+		const int tid = ThreadPool::GetThreadNum();
 
-		if (i < to) {
-			func(i);
-			remainingTasks -= 1;
+		int iter = 0;
+
+		if ((tid >= numRanges || !PopFront(tid, iter)) && !Steal(tid, iter))
+			return false;
+
+		func(from + step * iter);
+		remainingTasks -= 1;
+		return true;
+	}
+
+private:
+	static uint64_t PackRange(uint32_t b, uint32_t e) { return ((uint64_t(e) << 32) | b); }
+	static uint32_t RangeBeg(uint64_t r) { return (r & 0xFFFFFFFFu); }
+	static uint32_t RangeEnd(uint64_t r) { return (r >> 32); }
+
+	bool PopFront(int idx, int& iter)
+	{
+		uint64_t r = ranges[idx].load(std::memory_order_relaxed);
+
+		while (RangeBeg(r) < RangeEnd(r)) {
+			if (!ranges[idx].compare_exchange_weak(r, PackRange(RangeBeg(r) + 1, RangeEnd(r))))
+				continue;
+
+			iter = RangeBeg(r);
 			return true;
 		}
 
 		return false;
 	}
 
+	bool Steal(int tid, int& iter)
+	{
+		// threads added after Enqueue own no range, they only take single iterations
+		const bool ownsRange = (tid < numRanges);
+
+		for (int n = 1; n <= numRanges; n++) {
+			const int victim = (tid + n) % numRanges;
+
+			if (victim == tid)
+				continue;
+
+			uint64_t r = ranges[victim].load(std::memory_order_relaxed);
+
+			while (RangeBeg(r) < RangeEnd(r)) {
+				const uint32_t b = RangeBeg(r);
+				const uint32_t e = RangeEnd(r);
+				const uint32_t m = (ownsRange)? (b + (e - b) / 2): (e - 1);
+
+				if (!ranges[victim].compare_exchange_weak(r, PackRange(b, m)))
+					continue;
+
+				// our own range is empty and nobody refills it but us
+				if (ownsRange)
+					ranges[tid].store(PackRange(m + 1, e));
+
+				iter = m;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
 private:
-	std::atomic<int> ctr;
+	std::array<std::atomic<uint64_t>, ThreadPool::MAX_THREADS> ranges;
 	std::function<void(const int)> func;
 
+	int numRanges = 1;
+
 	int from;
-	int to;
 	int step;
 };
 #endif
@@ -673,7 +745,7 @@ struct TaskPool {
 template <typename F>
 static inline void for_mt(int start, int end, int step, F&& f)
 {
-	ThreadPool::inMultiThreadedSection = true;
+	ThreadPool::inMultiThreadedSection += 1;
 
 	if (!ThreadPool::HasThreads() || ((end - start) < step)) {
 		for (int i = start; i < end; i += step) {
@@ -706,7 +778,7 @@ static inline void for_mt(int start, int end, int step, F&& f)
 		ThreadPool::WaitForFinished(taskGroup);
 	}
 
-	ThreadPool::inMultiThreadedSection = false;
+	ThreadPool::inMultiThreadedSection -= 1;
 }
 
 template <typename F>
@@ -724,17 +796,22 @@ static inline void for_mt_chunk(int b, int e, F&& f, int minChunkSize = 1, int m
 
 	static const int maxThreads = ThreadPool::GetNumThreads();
 
-	const int chunkSize = std::clamp(numElems / maxThreads + (numElems % maxThreads != 0), minChunkSize, maxChunkSize);
-	const int numThreads = numElems / chunkSize + (numElems % chunkSize != 0);
+	// split into several chunks per thread, one chunk each would leave
+	// nothing to steal when per-element costs are uneven
+	constexpr int chunksPerThread = 4;
+
+	const int numChunks = maxThreads * chunksPerThread;
+	const int chunkSize = std::clamp(numElems / numChunks + (numElems % numChunks != 0), minChunkSize, maxChunkSize);
+	const int numJobs = numElems / chunkSize + (numElems % chunkSize != 0);
 
-	if (numThreads == 1) {
+	if (numJobs == 1) {
 		for (int i = b; i < e; ++i)
 			f(i);
 
 		return;
 	}
 
-	for_mt(0, numThreads, 1, [&f, b, e, chunkSize](const int jobId) {
+	for_mt(0, numJobs, 1, [&f, b, e, chunkSize](const int jobId) {
 		const int bb = b + jobId * chunkSize;
 		const int ee = std::min(bb + chunkSize, e);
 
@@ -406,6 +406,31 @@ void CTimeProfiler::AddTimeRaw(
 	}
 }
 
+void CTimeProfiler::GetTotalTimes(std::vector< std::pair<unsigned, spring_time> >& totalTimes) const
+{
+	std::lock_guard<ProfileMutexType> lock(profileMutex);
+
+	totalTimes.clear();
+	totalTimes.reserve(profiles.size());
+
+	for (const auto& profile: profiles) {
+		totalTimes.emplace_back(profile.first, profile.second.total);
+	}
+}
+
+std::string CTimeProfiler::GetTimerName(unsigned nameHash)
+{
+	std::lock_guard<HashNamMutexType> lock(hashToNameMutex);
+
+	const auto iter = hashToName.find(nameHash);
+
+	if (iter == hashToName.end())
+		return "???";
+
+	return (iter->second);
+}
+
+
 void CTimeProfiler::PrintProfilingInfo() const
 {
 	if (sortedProfiles.empty())
@@ -187,6 +187,10 @@ public:
 	void SetEnabled(bool b) { enabled = b; }
 	void PrintProfilingInfo() const;
 
+	/// snapshot of the accumulated time of every profile, keyed by name-hash
+	void GetTotalTimes(std::vector< std::pair<unsigned, spring_time> >& totalTimes) const;
+	static std::string GetTimerName(unsigned nameHash);
+
 	void AddTime(
 		unsigned nameHash,
 		const spring_time startTime,
@@ -1,7 +1,11 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include <map>
+#include <memory>
 #include <string>
 
+#include <asio/ip/udp.hpp>
+
 #ifdef _WIN32
 #include <windows.h>
 #endif
@@ -11,6 +15,7 @@
 #include "Game/GameData.h"
 #include "Game/GameVersion.h"
 #include "Net/GameServer.h"
+#include "Net/SpectatorRelay.h"
 #include "System/Exceptions.h"
 #include "System/GlobalConfig.h"
 #include "System/GlobalRNG.h"
@@ -27,9 +32,11 @@
 #include "System/Log/DefaultFilter.h"
 #include "System/LogOutput.h"
 #include "System/Misc/SpringTime.h"
+#include "System/Net/Socket.h"
 #include "System/Platform/CrashHandler.h"
 #include "System/Platform/errorhandler.h"
 #include "System/Platform/Threading.h"
+#include "System/StringUtil.h"
 
 #define LOG_SECTION_DEDICATED_SERVER "DedicatedServer"
 LOG_REGISTER_SECTION_GLOBAL(LOG_SECTION_DEDICATED_SERVER)
@@ -47,6 +54,12 @@ DEFINE_bool     (isolation,                            false, "Limit the data-di
 DEFINE_string_EX(isolation_dir,    "isolation-dir",    "",    "Specify the isolation-mode data-dir (see --isolation)");
 DEFINE_bool     (nocolor,                              false, "Disables colorized stdout");
 DEFINE_uint32   (sleeptime,                            1,     "Number of seconds to sleep between game-over checks");
+DEFINE_uint32   (controlport,                          0,     "Host any number of games in this process, started and stopped by commands sent to this loopback UDP port instead of a script");
+DEFINE_string   (relay,                                "",    "Relay the game hosted at host:port to spectators connecting to this process instead of hosting one; relays can be chained");
+DEFINE_string_EX(relay_name,       "relay-name",       "relay", "Player name the relay joins its upstream server with");
+DEFINE_string_EX(relay_password,   "relay-password",   "",    "Password the relay joins its upstream server with");
+DEFINE_string_EX(relay_client_password, "relay-client-password", "", "Password spectators have to connect to the relay with; empty lets anyone in");
+DEFINE_uint32   (relayport,                            8452,  "Port the relay accepts spectators on");
 
 #ifdef __cplusplus
 extern "C"
@@ -73,7 +86,7 @@ void ParseCmdLine(int argc, char* argv[], std::string& scriptName)
 	if (argc >= 2)
 		scriptName = argv[1];
 
-	if (scriptName.empty() && !FLAGS_list_config_vars) {
+	if (scriptName.empty() && !FLAGS_list_config_vars && FLAGS_controlport == 0 && FLAGS_relay.empty()) {
 		gflags::ShowUsageWithFlags(argv[0]);
 		exit(1);
 	}
@@ -105,6 +118,276 @@ void ParseCmdLine(int argc, char* argv[], std::string& scriptName)
 
 
 
+static std::unique_ptr<CGameServer> StartGameServer(const std::string& scriptName, CGlobalUnsyncedRNG& rng)
+{
+	LOG("loading script from file: %s", scriptName.c_str());
+
+	// server will take ownership of these
+	std::shared_ptr<ClientSetup> dsClientSetup(new ClientSetup());
+	std::shared_ptr<GameData> dsGameData(new GameData());
+	std::shared_ptr<CGameSetup> dsGameSetup(new CGameSetup());
+
+	std::string scriptText;
+	CFileHandler fh(scriptName);
+
+	if (!fh.FileExists())
+		throw content_error("script does not exist in given location: " + scriptName);
+
+	if (!fh.LoadStringData(scriptText))
+		throw content_error("script cannot be read: " + scriptName);
+
+	dsClientSetup->LoadFromStartScript(scriptText);
+
+	if (!dsGameSetup->Init(scriptText)) {
+		// read the script provided by cmdline
+		LOG_L(L_ERROR, "failed to load script %s", scriptName.c_str());
+		return nullptr;
+	}
+
+	if (dsGameSetup->fixedRNGSeed == 0) {
+		dsGameData->SetRandomSeed(rng.NextInt());
+	} else {
+		dsGameData->SetRandomSeed(dsGameSetup->fixedRNGSeed);
+	}
+
+	{
+		sha512::raw_digest dsMapChecksum;
+		sha512::raw_digest dsModChecksum;
+		sha512::hex_digest dsMapChecksumHex;
+		sha512::hex_digest dsModChecksumHex;
+
+		std::memcpy(dsMapChecksum.data(), &dsGameSetup->dsMapHash[0], sizeof(dsGameSetup->dsMapHash));
+		std::memcpy(dsModChecksum.data(), &dsGameSetup->dsModHash[0], sizeof(dsGameSetup->dsModHash));
+		sha512::dump_digest(dsMapChecksum, dsMapChecksumHex);
+		sha512::dump_digest(dsModChecksum, dsModChecksumHex);
+
+		LOG("[script-checksums]\n\tmap=%s\n\tmod=%s", dsMapChecksumHex.data(), dsModChecksumHex.data());
+
+		// use script-provided hashes if any byte is non-zero; these
+		// are only used by some client-side (pregame) sanity checks
+		const auto hashPred = [](uint8_t byte) { return (byte != 0); };
+
+		if (std::find_if(dsMapChecksum.begin(), dsMapChecksum.end(), hashPred) != dsMapChecksum.end()) {
+			dsGameData->SetMapChecksum(dsMapChecksum.data());
+			dsGameSetup->LoadStartPositions(false); // reduced mode
+		} else {
+			dsGameData->SetMapChecksum(&archiveScanner->GetArchiveCompleteChecksumBytes(dsGameSetup->mapName)[0]);
+
+			CFileHandler f("maps/" + dsGameSetup->mapName);
+			if (!f.FileExists())
+				vfsHandler->AddArchiveWithDeps(dsGameSetup->mapName, false);
+
+			dsGameSetup->LoadStartPositions(); // full mode
+		}
+
+		if (std::find_if(dsModChecksum.begin(), dsModChecksum.end(), hashPred) != dsModChecksum.end()) {
+			dsGameData->SetModChecksum(dsModChecksum.data());
+		} else {
+			const std::string& modArchive = archiveScanner->ArchiveFromName(dsGameSetup->modName);
+			const sha512::raw_digest& modCheckSum = archiveScanner->GetArchiveCompleteChecksumBytes(modArchive);
+
+			dsGameData->SetModChecksum(&modCheckSum[0]);
+		}
+	}
+
+	LOG("starting server...");
+
+	// the server runs in a separate thread
+	dsGameData->SetSetupText(dsGameSetup->setupText);
+	return (std::make_unique<CGameServer>(dsClientSetup, dsGameData, dsGameSetup));
+}
+
+static void LogDemoRecording(const CGameServer& server)
+{
+	const std::unique_ptr<CDemoRecorder>& demoRec = server.GetDemoRecorder();
+	const std::uint8_t* gameID = (demoRec->GetFileHeader()).gameID;
+
+	LOG("recording demo: %s", (demoRec->GetName()).c_str());
+	LOG("using mod: %s", (server.GetGameSetup()->modName).c_str());
+	LOG("using map: %s", (server.GetGameSetup()->mapName).c_str());
+	LOG("GameID: %02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x", gameID[0], gameID[1], gameID[2], gameID[3], gameID[4], gameID[5], gameID[6], gameID[7], gameID[8], gameID[9], gameID[10], gameID[11], gameID[12], gameID[13], gameID[14], gameID[15]);
+}
+
+
+
+/**
+ * Runs games side by side until told to quit. They share everything that is
+ * global to the process (archive scanner, VFS, demo writer jobs) but each
+ * has its own server thread, port and autohost connection. Commands arrive
+ * as single datagrams on 127.0.0.1:controlPort, every one gets a reply that
+ * starts with "OK" or "ERROR":
+ *
+ *   start <script>  ->  OK <gameNum>
+ *   stop <gameNum>  ->  OK
+ *   list            ->  OK <numGames>, then "<gameNum> <hostPort> <state> <script>" per line
+ *   quit            ->  OK, stops all games and exits
+ */
+class GameHost
+{
+public:
+	GameHost(unsigned int controlPort): controlSocket(netcode::netservice) {
+		const asio::ip::udp::endpoint endpoint(asio::ip::address_v4::loopback(), controlPort);
+
+		controlSocket.open(endpoint.protocol());
+		controlSocket.bind(endpoint);
+		controlSocket.non_blocking(true);
+
+		LOG("[GameHost] listening for commands on %s:%u", endpoint.address().to_string().c_str(), controlPort);
+	}
+
+	void Run() {
+		rng.Seed(time(nullptr) % ((spring_gettime().toNanoSecsi() + 1) * 9007));
+
+		while (!quit) {
+			ReadCommands();
+			UpdateGames();
+
+			spring_msecs(50).sleep(true);
+		}
+
+		// each dtor waits for its server to shut down
+		games.clear();
+	}
+
+private:
+	struct HostedGame {
+		std::unique_ptr<CGameServer> server;
+		std::string scriptName;
+		bool loggedDemo = false;
+	};
+
+	void ReadCommands() {
+		asio::error_code err;
+
+		while (controlSocket.available(err) > 0) {
+			std::string command(controlSocket.available(err), 0);
+			asio::ip::udp::endpoint sender;
+
+			command.resize(controlSocket.receive_from(asio::buffer(&command[0], command.size()), sender, 0, err));
+
+			if (err)
+				break;
+
+			while (!command.empty() && (command.back() == '\n' || command.back() == '\r'))
+				command.pop_back();
+
+			const std::string reply = ExecuteCommand(command);
+
+			controlSocket.send_to(asio::buffer(reply), sender, 0, err);
+		}
+	}
+
+	std::string ExecuteCommand(const std::string& command) {
+		const size_t sep = command.find(' ');
+		const std::string name = command.substr(0, sep);
+		const std::string args = (sep != std::string::npos)? command.substr(sep + 1): "";
+
+		LOG("[GameHost] command \"%s\"", command.c_str());
+
+		if (name == "start") {
+			try {
+				std::unique_ptr<CGameServer> server = StartGameServer(args, rng);
+
+				if (server == nullptr)
+					return "ERROR failed to load script " + args;
+
+				games[nextGameNum] = {std::move(server), args, false};
+				return ("OK " + IntToString(nextGameNum++));
+			} catch (const std::exception& ex) {
+				return (std::string("ERROR ") + ex.what());
+			}
+		}
+
+		if (name == "stop") {
+			const auto iter = games.find(StringToInt(args));
+
+			if (iter == games.end())
+				return "ERROR no game " + args;
+
+			games.erase(iter);
+			return "OK";
+		}
+
+		if (name == "list") {
+			std::string reply = "OK " + IntToString(games.size());
+
+			for (const auto& p: games) {
+				const CGameServer* server = p.second.server.get();
+				const char* state = server->HasFinished()? "finished": (server->HasStarted()? "running": "waiting");
+
+				reply += "\n" + IntToString(p.first) + " " + IntToString(server->GetClientSetup()->hostPort) + " " + state + " " + p.second.scriptName;
+			}
+
+			return reply;
+		}
+
+		if (name == "quit") {
+			quit = true;
+			return "OK";
+		}
+
+		return "ERROR unknown command " + name;
+	}
+
+	void UpdateGames() {
+		for (auto iter = games.begin(); iter != games.end(); ) {
+			HostedGame& game = iter->second;
+
+			if (game.server->HasFinished()) {
+				LOG("[GameHost] game %u (%s) finished", iter->first, game.scriptName.c_str());
+
+				iter = games.erase(iter);
+				continue;
+			}
+
+			if (!game.loggedDemo && game.server->HasGameID() && game.server->GetDemoRecorder() != nullptr) {
+				game.loggedDemo = true;
+				LogDemoRecording(*game.server);
+			}
+
+			++iter;
+		}
+	}
+
+private:
+	asio::ip::udp::socket controlSocket;
+
+	std::map<unsigned int, HostedGame> games;
+	unsigned int nextGameNum = 1;
+
+	CGlobalUnsyncedRNG rng;
+
+	bool quit = false;
+};
+
+
+
+static int RunSpectatorRelay(const std::string& upstream)
+{
+	const size_t sep = upstream.rfind(':');
+
+	if (sep == std::string::npos) {
+		LOG_L(L_ERROR, "relay address \"%s\" is not of the form host:port", upstream.c_str());
+		return 1;
+	}
+
+	// strip brackets around IPv6 addresses
+	std::string upstreamHost = upstream.substr(0, sep);
+
+	if (upstreamHost.size() >= 2 && upstreamHost.front() == '[' && upstreamHost.back() == ']')
+		upstreamHost = upstreamHost.substr(1, upstreamHost.size() - 2);
+
+	CSpectatorRelay relay(upstreamHost, StringToInt(upstream.substr(sep + 1)), "", FLAGS_relayport, FLAGS_relay_name, FLAGS_relay_password, FLAGS_relay_client_password);
+
+	while (!relay.HasFinished()) {
+		relay.Update();
+	}
+
+	return 0;
+}
+
+
+
 int main(int argc, char* argv[])
 {
 	Threading::SetMainThread();
@@ -117,7 +400,6 @@ int main(int argc, char* argv[])
 		CLogOutput::LogSystemInfo();
 
 		std::string scriptName;
-		std::string scriptText;
 		std::string binaryName = argv[0];
 
 		gflags::SetUsageMessage("Usage: " + binaryName + " [options] path_to_script.txt");
@@ -133,110 +415,42 @@ int main(int argc, char* argv[])
 		CrashHandler::Install();
 
 		LOG("report any errors to Mantis or the forums.");
-		LOG("loading script from file: %s", scriptName.c_str());
-
-		// server will take ownership of these
-		std::shared_ptr<ClientSetup> dsClientSetup(new ClientSetup());
-		std::shared_ptr<GameData> dsGameData(new GameData());
-		std::shared_ptr<CGameSetup> dsGameSetup(new CGameSetup());
-
-		CFileHandler fh(scriptName);
-
-		if (!fh.FileExists())
-			throw content_error("script does not exist in given location: " + scriptName);
-
-		if (!fh.LoadStringData(scriptText))
-			throw content_error("script cannot be read: " + scriptName);
-
-		dsClientSetup->LoadFromStartScript(scriptText);
-
-		if (!dsGameSetup->Init(scriptText)) {
-			// read the script provided by cmdline
-			LOG_L(L_ERROR, "failed to load script %s", scriptName.c_str());
-			return 1;
-		}
-
-		// create the server, it will run in a separate thread
-		CGlobalUnsyncedRNG rng;
 
-		const uint32_t sleepTime = FLAGS_sleeptime;
-		const uint32_t randSeed = time(nullptr) % ((spring_gettime().toNanoSecsi() + 1) * 9007);
-
-		rng.Seed(randSeed);
-		if (dsGameSetup->fixedRNGSeed == 0) {
-			dsGameData->SetRandomSeed(rng.NextInt());
+		if (!FLAGS_relay.empty()) {
+			if (RunSpectatorRelay(FLAGS_relay) != 0)
+				return 1;
+		} else if (FLAGS_controlport != 0) {
+			GameHost host(FLAGS_controlport);
+			host.Run();
 		} else {
-			dsGameData->SetRandomSeed(dsGameSetup->fixedRNGSeed);
-		}
-
-		{
-			sha512::raw_digest dsMapChecksum;
-			sha512::raw_digest dsModChecksum;
-			sha512::hex_digest dsMapChecksumHex;
-			sha512::hex_digest dsModChecksumHex;
-
-			std::memcpy(dsMapChecksum.data(), &dsGameSetup->dsMapHash[0], sizeof(dsGameSetup->dsMapHash));
-			std::memcpy(dsModChecksum.data(), &dsGameSetup->dsModHash[0], sizeof(dsGameSetup->dsModHash));
-			sha512::dump_digest(dsMapChecksum, dsMapChecksumHex);
-			sha512::dump_digest(dsModChecksum, dsModChecksumHex);
-
-			LOG("[script-checksums]\n\tmap=%s\n\tmod=%s", dsMapChecksumHex.data(), dsModChecksumHex.data());
-
-			// use script-provided hashes if any byte is non-zero; these
-			// are only used by some client-side (pregame) sanity checks
-			const auto hashPred = [](uint8_t byte) { return (byte != 0); };
+			// create the server, it will run in a separate thread
+			CGlobalUnsyncedRNG rng;
 
-			if (std::find_if(dsMapChecksum.begin(), dsMapChecksum.end(), hashPred) != dsMapChecksum.end()) {
-				dsGameData->SetMapChecksum(dsMapChecksum.data());
-				dsGameSetup->LoadStartPositions(false); // reduced mode
-			} else {
-				dsGameData->SetMapChecksum(&archiveScanner->GetArchiveCompleteChecksumBytes(dsGameSetup->mapName)[0]);
+			const uint32_t sleepTime = FLAGS_sleeptime;
+			const uint32_t randSeed = time(nullptr) % ((spring_gettime().toNanoSecsi() + 1) * 9007);
 
-				CFileHandler f("maps/" + dsGameSetup->mapName);
-				if (!f.FileExists())
-					vfsHandler->AddArchiveWithDeps(dsGameSetup->mapName, false);
+			rng.Seed(randSeed);
 
-				dsGameSetup->LoadStartPositions(); // full mode
-			}
-
-			if (std::find_if(dsModChecksum.begin(), dsModChecksum.end(), hashPred) != dsModChecksum.end()) {
-				dsGameData->SetModChecksum(dsModChecksum.data());
-			} else {
-				const std::string& modArchive = archiveScanner->ArchiveFromName(dsGameSetup->modName);
-				const sha512::raw_digest& modCheckSum = archiveScanner->GetArchiveCompleteChecksumBytes(modArchive);
-
-				dsGameData->SetModChecksum(&modCheckSum[0]);
-			}
-		}
-
-		LOG("starting server...");
+			std::unique_ptr<CGameServer> server = StartGameServer(scriptName, rng);
 
-		{
-			dsGameData->SetSetupText(dsGameSetup->setupText);
-			CGameServer server(dsClientSetup, dsGameData, dsGameSetup);
+			if (server == nullptr)
+				return 1;
 
-			while (!server.HasGameID()) {
+			while (!server->HasGameID()) {
 				// wait until gameID has been generated or
 				// a timeout occurs (if no clients connect)
-				if (server.HasFinished())
+				if (server->HasFinished())
 					break;
 
 				spring_sleep(spring_secs(sleepTime));
 			}
 
-			while (!server.HasFinished()) {
-				static bool printData = (server.GetDemoRecorder() != nullptr);
+			while (!server->HasFinished()) {
+				static bool printData = (server->GetDemoRecorder() != nullptr);
 
 				if (printData) {
 					printData = false;
-
-					const std::unique_ptr<CDemoRecorder>& demoRec = server.GetDemoRecorder();
-					const std::uint8_t* gameID = (demoRec->GetFileHeader()).gameID;
-
-					LOG("recording demo: %s", (demoRec->GetName()).c_str());
-					LOG("using mod: %s", (dsGameSetup->modName).c_str());
-					LOG("using map: %s", (dsGameSetup->mapName).c_str());
-					LOG("GameID: %02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x", gameID[0], gameID[1], gameID[2], gameID[3], gameID[4], gameID[5], gameID[6], gameID[7], gameID[8], gameID[9], gameID[10], gameID[11], gameID[12], gameID[13], gameID[14], gameID[15]);
+					LogDemoRecording(*server);
 				}
 
 				spring_secs(sleepTime).sleep(true);
@@ -0,0 +1,165 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Lua/LuaSharedArray.h"
+#include "LuaInclude.h"
+#include "Sim/Misc/GlobalSynced.h"
+
+#include <cstdlib>
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+
+// only views read it, for their frame number
+static CGlobalSynced globalSynced;
+CGlobalSynced* gs = &globalSynced;
+
+
+static void* l_alloc(void* ud, void* ptr, size_t osize, size_t nsize)
+{
+	if (nsize == 0) {
+		free(ptr);
+		return nullptr;
+	}
+
+	return realloc(ptr, nsize);
+}
+
+static lua_State* NewState(bool synced = true)
+{
+	lua_State* L = lua_newstate(l_alloc, nullptr);
+
+	SPRING_LUA_OPEN_LIB(L, luaopen_base);
+
+	lua_newtable(L);
+
+	if (synced) {
+		LuaSharedArray::PushSynced(L);
+	} else {
+		LuaSharedArray::PushUnsynced(L);
+	}
+
+	lua_setglobal(L, "Script");
+	return L;
+}
+
+// creates a synced array global "a" = {1, 2, 3} and hands a view of it to
+// the unsynced global "v", as SendToUnsynced/RecvFromSynced would
+static void SendArray(lua_State* S, lua_State* U)
+{
+	REQUIRE(luaL_dostring(S, "a = Script.CreateSharedArray('float', 3) a:Set(1, 1, 2, 3)") == 0);
+
+	lua_getglobal(S, "a");
+	REQUIRE(LuaSharedArray::IsSharedArray(S, -1));
+	REQUIRE(LuaSharedArray::PushView(U, S, -1));
+	lua_setglobal(U, "v");
+	lua_pop(S, 1);
+}
+
+static bool RunChunk(lua_State* L, const char* code)
+{
+	if (luaL_loadstring(L, code) != 0)
+		return false;
+
+	const bool ret = (lua_pcall(L, 0, 0, 0) == 0);
+
+	lua_settop(L, 0);
+	return ret;
+}
+
+
+TEST_CASE("SharedArrayInRange")
+{
+	lua_State* L = NewState();
+
+	CHECK(RunChunk(L, "local a = Script.CreateSharedArray('float', 3) a:Set(1, 1, 2, 3) assert(a:Get(3) == 3)"));
+	CHECK(RunChunk(L, "local a = Script.CreateSharedArray('int', 3) a:Set(2, {5, 6}) local x, y = a:Get(2, 2) assert(x == 5 and y == 6)"));
+	CHECK(RunChunk(L, "local a = Script.CreateSharedArray('int', 3) assert(select('#', a:Get(4, 0)) == 0)"));
+
+	lua_close(L);
+}
+
+TEST_CASE("SharedArrayOutOfRange")
+{
+	lua_State* L = NewState();
+
+	CHECK_FALSE(RunChunk(L, "local a = Script.CreateSharedArray('float', 3) a:Set(3, 1, 2)"));
+	CHECK_FALSE(RunChunk(L, "local a = Script.CreateSharedArray('float', 3) a:Get(0)"));
+	CHECK_FALSE(RunChunk(L, "local a = Script.CreateSharedArray('float', 3) a:Get(5, 0)"));
+
+	// start - 1 + count used to overflow int and pass the bounds check
+	CHECK_FALSE(RunChunk(L, "local a = Script.CreateSharedArray('float', 3) local t = {} for i = 1, 200 do t[i] = 1 end a:Set(2147483520, t)"));
+	CHECK_FALSE(RunChunk(L, "local a = Script.CreateSharedArray('float', 3) a:Set(2147483647, 1, 2)"));
+	CHECK_FALSE(RunChunk(L, "local a = Script.CreateSharedArray('float', 3) a:Get(2147483600, 100)"));
+	CHECK_FALSE(RunChunk(L, "local a = Script.CreateSharedArray('float', 3) a:Get(2, 2147483647)"));
+
+	lua_close(L);
+}
+
+TEST_CASE("SharedArrayView")
+{
+	lua_State* S = NewState(true);
+	lua_State* U = NewState(false);
+
+	gs->frameNum = 10;
+	SendArray(S, U);
+
+	CHECK(RunChunk(U, "assert(v:IsValid())"));
+	CHECK(RunChunk(U, "assert(#v == 3 and v[1] == 1 and v[3] == 3 and v[4] == nil)"));
+	CHECK(RunChunk(U, "local x, y = v:Get(2, 2) assert(x == 2 and y == 3)"));
+	CHECK_FALSE(RunChunk(U, "v:Get(3, 2)"));
+
+	// views alias the synced storage, later synced writes in the same frame are visible
+	CHECK(RunChunk(S, "a[2] = 20"));
+	CHECK(RunChunk(U, "assert(v[2] == 20)"));
+
+	// only synced code can create arrays
+	CHECK_FALSE(RunChunk(U, "Script.CreateSharedArray('float', 1)"));
+
+	lua_close(U);
+	lua_close(S);
+}
+
+TEST_CASE("SharedArrayViewReadOnly")
+{
+	lua_State* S = NewState(true);
+	lua_State* U = NewState(false);
+
+	gs->frameNum = 10;
+	SendArray(S, U);
+
+	CHECK_FALSE(RunChunk(U, "v[1] = 5"));
+	CHECK_FALSE(RunChunk(U, "v.x = 5"));
+	CHECK_FALSE(RunChunk(U, "v:Set(1, 5)"));
+	CHECK_FALSE(RunChunk(U, "v:Fill(5)"));
+
+	CHECK(RunChunk(S, "assert(a[1] == 1 and a[2] == 2 and a[3] == 3)"));
+
+	lua_close(U);
+	lua_close(S);
+}
+
+TEST_CASE("SharedArrayViewExpiry")
+{
+	lua_State* S = NewState(true);
+	lua_State* U = NewState(false);
+
+	gs->frameNum = 10;
+	SendArray(S, U);
+
+	CHECK(RunChunk(U, "assert(v[1] == 1)"));
+
+	gs->frameNum = 11;
+
+	CHECK(RunChunk(U, "assert(not v:IsValid())"));
+	CHECK_FALSE(RunChunk(U, "local x = v[1]"));
+	CHECK_FALSE(RunChunk(U, "local n = #v"));
+	CHECK_FALSE(RunChunk(U, "v:Get(1)"));
+
+	// a view sent in the new frame is valid again
+	SendArray(S, U);
+	CHECK(RunChunk(U, "assert(v:IsValid() and v[1] == 1)"));
+
+	lua_close(U);
+	lua_close(S);
+}
@@ -0,0 +1,139 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Net/SpectatorRelay.h"
+#include "Net/Protocol/BaseNetProtocol.h"
+#include "Net/Protocol/NetMessageTypes.h"
+#include "Game/GameVersion.h"
+#include "System/GlobalConfig.h"
+#include "System/Misc/SpringTime.h"
+#include "System/Net/RawPacket.h"
+#include "System/Net/UDPConnection.h"
+#include "System/Net/UDPListener.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+using netcode::RawPacket;
+
+static constexpr int UPSTREAM_PORT = 18452;
+static constexpr int RELAY_PORT = 18453;
+static constexpr int RELAY_PLAYER_NUM = 5;
+
+
+/// stands in for the game server the relay joins
+class FakeUpstream {
+public:
+	FakeUpstream(): listener(UPSTREAM_PORT, "127.0.0.1") {}
+
+	void Update() {
+		listener.Update();
+
+		while (listener.HasIncomingConnections()) {
+			link = listener.AcceptConnection();
+
+			std::shared_ptr<const RawPacket> packet = link->GetData();
+			REQUIRE(packet != nullptr);
+			REQUIRE(packet->data[0] == NETMSG_ATTEMPTCONNECT);
+
+			link->Unmute();
+			link->SendData(CBaseNetProtocol::Get().SendCreateNewPlayer(RELAY_PLAYER_NUM, true, 0, "relay"));
+			link->SendData(CBaseNetProtocol::Get().SendSetPlayerNum(RELAY_PLAYER_NUM));
+			link->Flush(true);
+		}
+
+		if (link == nullptr)
+			return;
+
+		while (link->GetData() != nullptr);
+	}
+
+	void Quit() {
+		link->SendData(CBaseNetProtocol::Get().SendQuit("game over"));
+		link->Flush(true);
+	}
+
+private:
+	netcode::UDPListener listener;
+	std::shared_ptr<netcode::UDPConnection> link;
+};
+
+
+/// connects to the relay like a game client and records what it is sent
+class TestClient {
+public:
+	TestClient(const std::string& name, const std::string& passwd) {
+		link = std::make_shared<netcode::UDPConnection>(0, "127.0.0.1", RELAY_PORT);
+		link->Unmute();
+		link->SendData(CBaseNetProtocol::Get().SendAttemptConnect(name, passwd, SpringVersion::GetSync(), "test", 0));
+		link->Flush(true);
+	}
+
+	void Update() {
+		link->Update();
+
+		std::shared_ptr<const RawPacket> packet;
+
+		while ((packet = link->GetData()) != nullptr) {
+			msgIDs.push_back(packet->data[0]);
+		}
+	}
+
+	bool Received(uint8_t msgID) const {
+		return (std::find(msgIDs.begin(), msgIDs.end(), msgID) != msgIDs.end());
+	}
+
+private:
+	std::shared_ptr<netcode::UDPConnection> link;
+	std::vector<uint8_t> msgIDs;
+};
+
+
+static bool RunUntil(FakeUpstream& server, CSpectatorRelay& relay, std::vector<TestClient*> clients, const std::function<bool()>& done)
+{
+	const spring_time endTime = spring_gettime() + spring_secs(10);
+
+	while (spring_gettime() < endTime) {
+		server.Update();
+		relay.Update();
+
+		for (TestClient* client: clients)
+			client->Update();
+
+		if (done())
+			return true;
+	}
+
+	return false;
+}
+
+
+TEST_CASE("SpectatorRelay")
+{
+	spring_clock::PushTickRate(false);
+	spring_time::setstarttime(spring_time::gettime(true));
+
+	FakeUpstream server;
+	CSpectatorRelay relay("127.0.0.1", UPSTREAM_PORT, "127.0.0.1", RELAY_PORT, "relay", "", "secret");
+
+	TestClient wrongPasswd("wrong", "guess");
+	TestClient rightPasswd("right", "secret");
+
+	CHECK(RunUntil(server, relay, {&wrongPasswd, &rightPasswd}, [&]() {
+		return (wrongPasswd.Received(NETMSG_REJECT_CONNECT) && rightPasswd.Received(NETMSG_SETPLAYERNUM));
+	}));
+
+	CHECK(relay.GetNumClients() == 1);
+	CHECK(!wrongPasswd.Received(NETMSG_SETPLAYERNUM));
+	CHECK(!rightPasswd.Received(NETMSG_REJECT_CONNECT));
+
+	// the relay ends and takes its clients along once the upstream quits
+	server.Quit();
+
+	CHECK(RunUntil(server, relay, {&rightPasswd}, [&]() { return (relay.HasFinished() && rightPasswd.Received(NETMSG_QUIT)); }));
+	CHECK(relay.GetNumClients() == 0);
+}
@@ -9,6 +9,7 @@
 
 #include <vector>
 #include <atomic>
+#include <functional>
 #include <future>
 
 #define CATCH_CONFIG_MAIN
@@ -145,6 +146,58 @@ TEST_CASE("test_nested_for_mt")
 	});
 }
 
+TEST_CASE("test_skewed_for_mt")
+{
+	LOG("[%s::test_skewed_for_mt]", __func__);
+
+	std::vector<std::atomic<int>> hits(NUM_RUNS);
+
+	// expensive iterations are all at the front, the threads owning those
+	// ranges only finish in time if the others steal from them
+	const auto SkewedKernel = [&](const int i) {
+		if (i < (NUM_RUNS / 50)) {
+			const spring_time finish = spring_now() + spring_time::fromMicroSecs(20);
+			while (spring_now() < finish) {}
+		}
+
+		hits[i] += 1;
+	};
+
+	for_mt(0, NUM_RUNS, SkewedKernel);
+
+	for (int i = 0; i < NUM_RUNS; i++) {
+		CHECK(hits[i] == 1);
+	}
+
+	for_mt_chunk(0, NUM_RUNS, SkewedKernel);
+
+	for (int i = 0; i < NUM_RUNS; i++) {
+		CHECK(hits[i] == 2);
+	}
+}
+
+TEST_CASE("test_nested_for_mt_section")
+{
+	LOG("[%s::test_nested_for_mt_section]", __func__);
+
+	std::vector<std::atomic<int>> hits(64 * 64);
+
+	for_mt(0, 64, [&](const int y) {
+		for_mt(0, 64, [&](const int x) {
+			hits[y * 64 + x] += 1;
+		});
+
+		// an inner for_mt returning must not end the outer section
+		SAFE_CHECK(ThreadPool::inMultiThreadedSection > 0);
+	});
+
+	CHECK(ThreadPool::inMultiThreadedSection == 0);
+
+	for (size_t i = 0; i < hits.size(); i++) {
+		CHECK(hits[i] == 1);
+	}
+}
+
 TEST_CASE("test_nested_parallel")
 {
 	#if 0
@@ -256,6 +309,84 @@ TEST_CASE("test_for_vs_for_mt")
 }
 
 
+static void skewed_for_mt_kernel(const char* name, const int numRuns, const std::function<spring_time(int)>& kernelLoad)
+{
+	spring_time t_for;
+	spring_time t_formt;
+	spring_time t_formt_chunk;
+	spring_time t_load;
+
+	const auto& ExecKernel = [](const spring_time t) {
+		const spring_time finish = spring_now() + t;
+		while (spring_now() < finish) {}
+	};
+
+	for (int i = 0; i < numRuns; ++i) {
+		t_load += kernelLoad(i);
+	}
+
+	{
+		const spring_time start = spring_now();
+
+		for (int i = 0; i < numRuns; ++i) {
+			ExecKernel(kernelLoad(i));
+		}
+
+		t_for = (spring_now() - start);
+	}
+	{
+		const spring_time start = spring_now();
+
+		for_mt(0, numRuns, [&](const int i) {
+			ExecKernel(kernelLoad(i));
+		});
+
+		t_formt = (spring_now() - start);
+	}
+	{
+		const spring_time start = spring_now();
+
+		for_mt_chunk(0, numRuns, [&](const int i) {
+			ExecKernel(kernelLoad(i));
+		});
+
+		t_formt_chunk = (spring_now() - start);
+	}
+
+	// ideal is the total load spread evenly over all threads
+	const float t_ideal = t_load.toMilliSecsf() / ThreadPool::GetNumThreads();
+
+	LOG("\t[%s] %s: %i runs, %.0fms total load", __func__, name, numRuns, t_load.toMilliSecsf());
+	LOG("\t\tfor          took %.4fms", t_for.toMilliSecsf());
+	LOG("\t\tfor_mt       took %.4fms (%.0f%% of ideal)", t_formt.toMilliSecsf(), (t_ideal / t_formt.toMilliSecsf()) * 100.0f);
+	LOG("\t\tfor_mt_chunk took %.4fms (%.0f%% of ideal)", t_formt_chunk.toMilliSecsf(), (t_ideal / t_formt_chunk.toMilliSecsf()) * 100.0f);
+}
+
+TEST_CASE("test_skewed_for_mt_benchmark")
+{
+	LOG("[%s::test_skewed_for_mt_benchmark] threads=%d", __func__, ThreadPool::GetNumThreads());
+
+	constexpr int NUM_ITEMS = 2000;
+
+	std::vector<spring_time> randomLoads(NUM_ITEMS);
+	CGlobalUnsyncedRNG rng;
+
+	rng.Seed(NUM_ITEMS);
+
+	// a few expensive items at random positions, e.g. long path searches
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		randomLoads[i] = spring_time::fromMicroSecs((rng.NextFloat() < 0.01f)? 500: 2);
+	}
+
+	skewed_for_mt_kernel("uniform", NUM_ITEMS, [](int i) { return spring_time::fromMicroSecs(5); });
+	// cost growing with index, e.g. units sorted by number of neighbours
+	skewed_for_mt_kernel("ramp", NUM_ITEMS, [](int i) { return spring_time::fromMicroSecs(1 + (i * 10) / NUM_ITEMS); });
+	// expensive items clustered in one range, e.g. a blob of units stuck at a choke
+	skewed_for_mt_kernel("clustered", NUM_ITEMS, [](int i) { return spring_time::fromMicroSecs((i < NUM_ITEMS / 50)? 200: 2); });
+	skewed_for_mt_kernel("random", NUM_ITEMS, [&](int i) { return randomLoads[i]; });
+}
+
+
 static void test_parallel_reaction_times_aux(int numRuns)
 {
 	LOG("\t[%s]", __func__);
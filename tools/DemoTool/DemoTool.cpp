@@ -421,6 +421,12 @@ void TrafficDump(CDemoReader& reader, bool trafficStats)
 				std::cout << " Checksum: " << (unsigned)buffer[6];
 				std::cout << std::endl;
 				break;
+			case NETMSG_SYNCLANES:
+				//uchar playerNum; int frameNum; uint laneChecksums[SYNC_LANE_COUNT];
+				std::cout << "NETMSG_SYNCLANES: Playernum: " << (unsigned)buffer[1];
+				std::cout << " Framenum: " << *(int*)(buffer+2);
+				std::cout << std::endl;
+				break;
 			case NETMSG_DIRECT_CONTROL:
 				std::cout << "NETMSG_DIRECT_CONTROL: " << std::endl;
 				break;